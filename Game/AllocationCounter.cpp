@@ -0,0 +1,53 @@
+#include "Game/AllocationCounter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+// -----------------------------------------------------------------------------
+#if defined(GAME_COUNT_ALLOCATIONS)
+static std::atomic<uint64_t> s_numHeapAllocations(0);
+// -----------------------------------------------------------------------------
+// The nothrow and sized forms fall back to these, so every allocation is counted once
+void* operator new(size_t size)
+{
+	s_numHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+#endif
+// -----------------------------------------------------------------------------
+bool IsCountingAllocations()
+{
+#if defined(GAME_COUNT_ALLOCATIONS)
+	return true;
+#else
+	return false;
+#endif
+}
+
+uint64_t GetTotalHeapAllocations()
+{
+#if defined(GAME_COUNT_ALLOCATIONS)
+	return s_numHeapAllocations.load(std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
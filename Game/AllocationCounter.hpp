@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+// -----------------------------------------------------------------------------
+// Dev builds replace the global operator new so the F2 overlay can show how many
+// heap allocations a frame really made, from the game and the engine alike.
+// -----------------------------------------------------------------------------
+#if defined(_DEBUG)
+#define GAME_COUNT_ALLOCATIONS
+#endif
+// -----------------------------------------------------------------------------
+bool	 IsCountingAllocations();
+uint64_t GetTotalHeapAllocations();		// Since startup, always zero when not counting
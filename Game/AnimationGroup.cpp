@@ -1,13 +1,14 @@
 #include "Game/AnimationGroup.hpp"
 #include "Engine/Math/MathUtils.h"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include <cmath>
 
 
 AnimationGroup::AnimationGroup(XmlElement const& element, SpriteSheet* spritesheet)
 	:m_spriteSheet(spritesheet)
 {
 	m_animationGroupName = ParseXmlAttribute(element, "name", m_animationGroupName);
-	float secondsPerFrame = ParseXmlAttribute(element, "secondsPerFrame", 0.f);
+	m_secondsPerFrame = ParseXmlAttribute(element, "secondsPerFrame", 0.f);
 
 	std::string playbackMode = ParseXmlAttribute(element, "playbackMode", playbackMode);
 	if (playbackMode == "Loop")
@@ -38,26 +39,112 @@ AnimationGroup::AnimationGroup(XmlElement const& element, SpriteSheet* spriteshe
 		}
 
 		m_directions.push_back(direction);
-		SpriteAnimDefinition animDef(*spritesheet, -1, -1, secondsPerFrame, m_playbackMode);
+		SpriteAnimDefinition animDef(*spritesheet, -1, -1, m_secondsPerFrame, m_playbackMode);
 		animDef.LoadFromXmlElement(animElement);
 		m_anims.push_back(animDef);
+
+		FlipbookDirection flipbookDirection;
+		int startFrame = ParseXmlAttribute(*animElement, "startFrame", 0);
+		int endFrame = ParseXmlAttribute(*animElement, "endFrame", startFrame);
+		flipbookDirection.m_numFrames = endFrame - startFrame + 1;
+		m_flipbookDirections.push_back(flipbookDirection);
 		directionElement = directionElement->NextSiblingElement("Direction");
 	}
+
+	BuildFlipbook();
 }
 
-SpriteAnimDefinition AnimationGroup::GetAnimDirection(Vec3 const& direction)
+void AnimationGroup::BuildFlipbook()
 {
-	int animResultIndex = 0;
-	float maxDot = -1000.f;
-
+	// Sample each frame's middle through the engine's definition once, every later lookup reads the table
 	for (int animIndex = 0; animIndex < static_cast<int>(m_anims.size()); ++animIndex)
 	{
-		float dot = DotProduct3D(direction, m_directions[animIndex]);
-		if (dot > maxDot)
+		FlipbookDirection& flipbookDirection = m_flipbookDirections[animIndex];
+		GUARANTEE_OR_DIE(flipbookDirection.m_numFrames > 0, Stringf("Animation group \"%s\" has an animation with no frames", m_animationGroupName.c_str()));
+
+		flipbookDirection.m_firstFrame = static_cast<int>(m_frameUVs.size());
+		for (int frameIndex = 0; frameIndex < flipbookDirection.m_numFrames; ++frameIndex)
+		{
+			float frameMiddleSeconds = (static_cast<float>(frameIndex) + 0.5f) * m_secondsPerFrame;
+			SpriteDefinition const& spriteDef = m_anims[animIndex].GetSpriteDefAtTime(frameMiddleSeconds);
+			m_frameUVs.push_back(spriteDef.GetUVs());
+			m_texture = &spriteDef.GetTexture();
+		}
+	}
+
+	for (int bucketIndex = 0; bucketIndex < NUM_ANIM_DIRECTION_BUCKETS; ++bucketIndex)
+	{
+		float bucketRadians = ((static_cast<float>(bucketIndex) + 0.5f) / static_cast<float>(NUM_ANIM_DIRECTION_BUCKETS)) * 6.2831853f - 3.1415927f;
+		Vec3 bucketDirection = Vec3(cosf(bucketRadians), sinf(bucketRadians), 0.f);
+		m_directionBuckets[bucketIndex] = 0;
+		float maxDot = -1000.f;
+		for (int animIndex = 0; animIndex < static_cast<int>(m_directions.size()); ++animIndex)
 		{
-			maxDot = dot;
-			animResultIndex = animIndex;
+			float dot = DotProduct3D(bucketDirection, m_directions[animIndex]);
+			if (dot > maxDot)
+			{
+				maxDot = dot;
+				m_directionBuckets[bucketIndex] = animIndex;
+			}
 		}
 	}
-	return m_anims[animResultIndex];
+}
+
+SpriteAnimDefinition const& AnimationGroup::GetAnimDirection(Vec3 const& direction) const
+{
+	return m_anims[GetDirectionIndex(direction)];
+}
+
+int AnimationGroup::GetDirectionIndex(Vec3 const& direction) const
+{
+	// Viewing directions are flattened onto XY, so the yaw alone picks the bucket
+	float radians = atan2f(direction.y, direction.x);
+	int bucketIndex = static_cast<int>((radians + 3.1415927f) * (static_cast<float>(NUM_ANIM_DIRECTION_BUCKETS) / 6.2831853f));
+	if (bucketIndex < 0)
+	{
+		bucketIndex = 0;
+	}
+	else if (bucketIndex >= NUM_ANIM_DIRECTION_BUCKETS)
+	{
+		bucketIndex = NUM_ANIM_DIRECTION_BUCKETS - 1;
+	}
+	return m_directionBuckets[bucketIndex];
+}
+
+int AnimationGroup::GetFrameIndex(int directionIndex, float seconds) const
+{
+	int numFrames = m_flipbookDirections[directionIndex].m_numFrames;
+	int elapsedFrames = (m_secondsPerFrame > 0.f) ? static_cast<int>(seconds / m_secondsPerFrame) : 0;
+	if (elapsedFrames < 0)
+	{
+		elapsedFrames = 0;
+	}
+
+	if (m_playbackMode == SpriteAnimPlaybackType::LOOP)
+	{
+		return elapsedFrames % numFrames;
+	}
+	if (m_playbackMode == SpriteAnimPlaybackType::PINGPONG && numFrames > 1)
+	{
+		int cycleFrames = (numFrames * 2) - 2;
+		int cycleFrame = elapsedFrames % cycleFrames;
+		return (cycleFrame < numFrames) ? cycleFrame : cycleFrames - cycleFrame;
+	}
+	return (elapsedFrames < numFrames) ? elapsedFrames : numFrames - 1;
+}
+
+int AnimationGroup::GetFlipbookFrame(Vec3 const& direction, float seconds) const
+{
+	int directionIndex = GetDirectionIndex(direction);
+	return m_flipbookDirections[directionIndex].m_firstFrame + GetFrameIndex(directionIndex, seconds);
+}
+
+AABB2 const& AnimationGroup::GetFrameUVs(Vec3 const& direction, float seconds) const
+{
+	return m_frameUVs[GetFlipbookFrame(direction, seconds)];
+}
+
+Texture const* AnimationGroup::GetTexture() const
+{
+	return m_texture;
 }
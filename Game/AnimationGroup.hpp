@@ -1,14 +1,38 @@
 #pragma once
 #include "Engine/Core/XmlUtils.hpp"
 #include "Engine/Renderer/SpriteAnimDefinition.hpp"
+#include "Engine/Math/AABB2.hpp"
 // -----------------------------------------------------------------------------
 class SpriteSheet;
+class Texture;
+// -----------------------------------------------------------------------------
+constexpr int NUM_ANIM_DIRECTION_BUCKETS = 64;		// Around the yaw circle, each holds the closest authored direction
+// -----------------------------------------------------------------------------
+struct FlipbookDirection
+{
+	int m_firstFrame = 0;		// Into m_frameUVs
+	int m_numFrames = 0;
+};
+// -----------------------------------------------------------------------------
+// Frame UVs for every direction are sampled once at load into one flat table,
+// so a frame lookup is a yaw bucket, a frame index and an array read.
 // -----------------------------------------------------------------------------
 class AnimationGroup
 {
 public:
 	AnimationGroup(XmlElement const& element, SpriteSheet* spritesheet);
-	SpriteAnimDefinition GetAnimDirection(Vec3 const& direction);
+	SpriteAnimDefinition const& GetAnimDirection(Vec3 const& direction) const;
+
+	int   GetDirectionIndex(Vec3 const& direction) const;
+	int   GetFrameIndex(int directionIndex, float seconds) const;
+	int   GetFlipbookFrame(Vec3 const& direction, float seconds) const;		// Into m_frameUVs
+	AABB2 const& GetFrameUVs(Vec3 const& direction, float seconds) const;
+	Texture const* GetTexture() const;
+
+private:
+	void BuildFlipbook();
+
+public:
 	// -----------------------------------------------------------------------------
 	SpriteSheet* m_spriteSheet = nullptr;
 	std::string m_animationGroupName;
@@ -18,4 +42,9 @@ public:
 
 	std::vector<SpriteAnimDefinition> m_anims;
 	std::vector<Vec3> m_directions;
+
+	std::vector<AABB2>			   m_frameUVs;
+	std::vector<FlipbookDirection> m_flipbookDirections;	// Parallel to m_anims
+	int		 m_directionBuckets[NUM_ANIM_DIRECTION_BUCKETS] = {};
+	Texture const* m_texture = nullptr;
 };
\ No newline at end of file
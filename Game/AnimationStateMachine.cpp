@@ -0,0 +1,109 @@
+#include "Game/AnimationStateMachine.hpp"
+#include "Game/AnimationGroup.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+// -----------------------------------------------------------------------------
+static char const* const s_triggerNames[NUM_ANIM_TRIGGERS] =
+{
+	"Jumped",
+	"TurningLeft",
+	"TurningRight",
+	"StoppedTurning",
+	"LeftGround",
+	"Landed",
+	"Finished",
+};
+// -----------------------------------------------------------------------------
+static int FindStateByName(std::vector<AnimationGroup*> const& animationGroups, std::string const& stateName, std::string const& ownerName)
+{
+	int stateIndex = INVALID_ANIM_STATE;
+	for (int groupIndex = 0; groupIndex < static_cast<int>(animationGroups.size()); ++groupIndex)
+	{
+		if (animationGroups[groupIndex]->m_animationGroupName == stateName)
+		{
+			stateIndex = groupIndex;
+			break;
+		}
+	}
+	GUARANTEE_OR_DIE(stateIndex != INVALID_ANIM_STATE, Stringf("Animation state \"%s\" in \"%s\" has no matching AnimationGroup", stateName.c_str(), ownerName.c_str()));
+	return stateIndex;
+}
+// -----------------------------------------------------------------------------
+void AnimationStateMachine::Compile(XmlElement const* statesElement, std::vector<AnimationGroup*> const& animationGroups, std::string const& ownerName)
+{
+	m_numStates = static_cast<int>(animationGroups.size());
+	m_initialState = 0;
+	m_transitions.assign(m_numStates * NUM_ANIM_TRIGGERS, INVALID_ANIM_STATE);
+
+	if (statesElement == nullptr || m_numStates == 0)
+	{
+		return;
+	}
+
+	std::string initialName = ParseXmlAttribute(*statesElement, "initial", std::string());
+	if (!initialName.empty())
+	{
+		m_initialState = FindStateByName(animationGroups, initialName, ownerName);
+	}
+
+	// Two passes so specific transitions win over "any state" ones regardless of order
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		bool isSpecificPass = (pass == 1);
+		XmlElement const* transitionElement = statesElement->FirstChildElement("Transition");
+		while (transitionElement != nullptr)
+		{
+			std::string fromName = ParseXmlAttribute(*transitionElement, "from", std::string());
+			if (fromName.empty() != isSpecificPass)
+			{
+				int toState = FindStateByName(animationGroups, ParseXmlAttribute(*transitionElement, "to", std::string()), ownerName);
+				int trigger = static_cast<int>(GetTriggerByName(ParseXmlAttribute(*transitionElement, "trigger", std::string())));
+				GUARANTEE_OR_DIE(trigger != NUM_ANIM_TRIGGERS, Stringf("Unknown animation trigger in \"%s\"", ownerName.c_str()));
+
+				if (isSpecificPass)
+				{
+					int fromState = FindStateByName(animationGroups, fromName, ownerName);
+					m_transitions[fromState * NUM_ANIM_TRIGGERS + trigger] = toState;
+				}
+				else
+				{
+					for (int fromState = 0; fromState < m_numStates; ++fromState)
+					{
+						m_transitions[fromState * NUM_ANIM_TRIGGERS + trigger] = toState;
+					}
+				}
+			}
+			transitionElement = transitionElement->NextSiblingElement("Transition");
+		}
+	}
+}
+
+int AnimationStateMachine::GetInitialState() const
+{
+	return m_initialState;
+}
+
+int AnimationStateMachine::GetNextState(int state, AnimTrigger trigger) const
+{
+	if (state < 0 || state >= m_numStates)
+	{
+		return INVALID_ANIM_STATE;
+	}
+	return m_transitions[state * NUM_ANIM_TRIGGERS + static_cast<int>(trigger)];
+}
+
+int AnimationStateMachine::GetNumStates() const
+{
+	return m_numStates;
+}
+
+AnimTrigger AnimationStateMachine::GetTriggerByName(std::string const& triggerName)
+{
+	for (int triggerIndex = 0; triggerIndex < NUM_ANIM_TRIGGERS; ++triggerIndex)
+	{
+		if (triggerName == s_triggerNames[triggerIndex])
+		{
+			return static_cast<AnimTrigger>(triggerIndex);
+		}
+	}
+	return AnimTrigger::COUNT;
+}
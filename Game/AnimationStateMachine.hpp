@@ -0,0 +1,43 @@
+#pragma once
+#include "Engine/Core/XmlUtils.hpp"
+#include <string>
+#include <vector>
+// -----------------------------------------------------------------------------
+class AnimationGroup;
+// -----------------------------------------------------------------------------
+enum class AnimTrigger
+{
+	JUMPED,
+	TURNING_LEFT,
+	TURNING_RIGHT,
+	STOPPED_TURNING,
+	LEFT_GROUND,
+	LANDED,
+	FINISHED,		// A Once animation ran past its last frame
+	COUNT
+};
+constexpr int NUM_ANIM_TRIGGERS = static_cast<int>(AnimTrigger::COUNT);
+constexpr int INVALID_ANIM_STATE = -1;
+// -----------------------------------------------------------------------------
+// Animation transitions from a definition's <AnimationStates>, compiled into a
+// flat state by trigger table once its animation groups exist. States are
+// animation group indices, so a transition is one array read and no name is
+// looked up after load. A Transition without "from" applies to every state,
+// ones with "from" override it.
+// -----------------------------------------------------------------------------
+class AnimationStateMachine
+{
+public:
+	void Compile(XmlElement const* statesElement, std::vector<AnimationGroup*> const& animationGroups, std::string const& ownerName);
+
+	int GetInitialState() const;
+	int GetNextState(int state, AnimTrigger trigger) const;		// INVALID_ANIM_STATE when the trigger changes nothing
+	int GetNumStates() const;
+
+	static AnimTrigger GetTriggerByName(std::string const& triggerName);
+
+private:
+	int m_numStates = 0;
+	int m_initialState = 0;
+	std::vector<int> m_transitions;		// [state * NUM_ANIM_TRIGGERS + trigger]
+};
@@ -1,4 +1,7 @@
 #include "Game/App.h"
+#include "Game/ShaderLibrary.hpp"
+#include "Game/FrameScratch.hpp"
+#include "Game/RenderQueue.hpp"
 #include "Engine/Core/EventSystem.hpp"
 #include "Engine/Renderer/Renderer.h"
 #include "Engine/Renderer/Camera.h"
@@ -20,6 +23,9 @@ AudioSystem* g_theAudio = nullptr;		// Created and owned by the App
 UISystem* g_theUISystem = nullptr;		// Created and owned by the App
 Window* g_theWindow = nullptr;			// Created and owned by the App
 Game* g_theGame = nullptr;
+ShaderLibrary* g_theShaderLibrary = nullptr;	// Created and owned by the App
+FrameScratch* g_theFrameScratch = nullptr;		// Created and owned by the App
+RenderQueue* g_theRenderQueue = nullptr;		// Created and owned by the App
 
 
 App::App()
@@ -82,6 +88,10 @@ void App::Startup()
 	debugRenderConfig.m_fontName = "Data/Fonts/SquirrelFixedFont";
 	DebugRenderSystemStartup(debugRenderConfig);
 
+	g_theShaderLibrary = new ShaderLibrary();
+	g_theFrameScratch = new FrameScratch();
+	g_theRenderQueue = new RenderQueue();
+
 	g_theGame = new Game(this);
 	g_theGame->StartUp();
 
@@ -96,6 +106,15 @@ void App::Shutdown()
 
 	DebugRenderSystemShutdown();
 
+	delete g_theShaderLibrary;
+	g_theShaderLibrary = nullptr;
+
+	delete g_theFrameScratch;
+	g_theFrameScratch = nullptr;
+
+	delete g_theRenderQueue;
+	g_theRenderQueue = nullptr;
+
 	g_theAudio->Shutdown();
 	g_theUISystem->Shutdown();
 	g_theRenderer->Shutdown();
@@ -173,6 +192,10 @@ void App::EndFrame()
 	g_theAudio->EndFrame();
 
 	DebugRenderEndFrame();
+
+	// Everything drawn this frame is submitted, its scratch vertices can be reused
+	g_theRenderQueue->EndFrame();
+	g_theFrameScratch->EndFrame();
 }
 
 void App::LoadGameConfig(char const* gameConfigXMLFilePath)
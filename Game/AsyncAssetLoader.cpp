@@ -0,0 +1,149 @@
+#include "Game/AsyncAssetLoader.hpp"
+#include "Game/GameCommon.h"
+#include "Engine/Renderer/Renderer.h"
+#include <fstream>
+// -----------------------------------------------------------------------------
+AsyncAssetLoader::AsyncAssetLoader()
+{
+	// Leave a core for the main thread, which keeps parsing definitions meanwhile
+	int numThreads = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+	if (numThreads > MAX_ASSET_LOADER_THREADS)
+	{
+		numThreads = MAX_ASSET_LOADER_THREADS;
+	}
+	if (numThreads < 1)
+	{
+		numThreads = 1;
+	}
+
+	for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+	{
+		m_workerThreads.push_back(std::thread(&AsyncAssetLoader::WorkerThreadMain, this));
+	}
+}
+
+AsyncAssetLoader::~AsyncAssetLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isQuitting = true;
+	}
+	m_requestCondition.notify_all();
+	for (std::thread& workerThread : m_workerThreads)
+	{
+		workerThread.join();
+	}
+}
+
+TextureHandle AsyncAssetLoader::RequestTexture(std::string const& filePath)
+{
+	for (int requestIndex = 0; requestIndex < static_cast<int>(m_requests.size()); ++requestIndex)
+	{
+		if (m_requests[requestIndex]->m_filePath == filePath)
+		{
+			return requestIndex;
+		}
+	}
+
+	TextureLoadRequest* request = new TextureLoadRequest();
+	request->m_filePath = filePath;
+	request->m_handle = static_cast<TextureHandle>(m_requests.size());
+	m_requests.push_back(std::unique_ptr<TextureLoadRequest>(request));
+	m_numPending++;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_requestQueue.push_back(request);
+	}
+	m_requestCondition.notify_one();
+	return request->m_handle;
+}
+
+void AsyncAssetLoader::Update()
+{
+	std::deque<TextureHandle> prefetchedHandles;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		prefetchedHandles.swap(m_prefetchedHandles);
+	}
+	for (TextureHandle handle : prefetchedHandles)
+	{
+		CreateTexture(*m_requests[handle]);
+	}
+}
+
+Texture* AsyncAssetLoader::WaitForTexture(TextureHandle handle)
+{
+	Update();
+	while (!IsTextureReady(handle))
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_prefetchedCondition.wait(lock, [this]() { return !m_prefetchedHandles.empty(); });
+		}
+		Update();
+	}
+	return GetTexture(handle);
+}
+
+void AsyncAssetLoader::WaitForAll()
+{
+	for (int requestIndex = 0; requestIndex < static_cast<int>(m_requests.size()); ++requestIndex)
+	{
+		WaitForTexture(requestIndex);
+	}
+}
+
+bool AsyncAssetLoader::IsTextureReady(TextureHandle handle) const
+{
+	return m_requests[handle]->m_state.load() == AssetLoadState::READY;
+}
+
+Texture* AsyncAssetLoader::GetTexture(TextureHandle handle) const
+{
+	return IsTextureReady(handle) ? m_requests[handle]->m_texture : nullptr;
+}
+
+int AsyncAssetLoader::GetNumPending() const
+{
+	return m_numPending;
+}
+
+void AsyncAssetLoader::CreateTexture(TextureLoadRequest& request)
+{
+	// The decode happens here on the main thread, registered under its path so
+	// CreateOrGetBitmapFont and later lookups reuse this one
+	request.m_texture = g_theRenderer->CreateOrGetTextureFromFile(request.m_filePath.c_str());
+	request.m_state.store(AssetLoadState::READY);
+	m_numPending--;
+}
+
+void AsyncAssetLoader::WorkerThreadMain()
+{
+	static thread_local char readBuffer[64 * 1024];
+	for (;;)
+	{
+		TextureLoadRequest* request = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_requestCondition.wait(lock, [this]() { return m_isQuitting || !m_requestQueue.empty(); });
+			if (m_isQuitting)
+			{
+				return;
+			}
+			request = m_requestQueue.front();
+			m_requestQueue.pop_front();
+		}
+
+		// The bytes are thrown away, the read only has to leave the file in the OS cache
+		std::ifstream file(request->m_filePath, std::ios::binary);
+		while (file.read(readBuffer, sizeof(readBuffer)))
+		{
+		}
+		request->m_state.store(AssetLoadState::PREFETCHED);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_prefetchedHandles.push_back(request->m_handle);
+		}
+		m_prefetchedCondition.notify_all();
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+// -----------------------------------------------------------------------------
+class Texture;
+// -----------------------------------------------------------------------------
+typedef int TextureHandle;
+constexpr TextureHandle INVALID_TEXTURE_HANDLE = -1;
+constexpr int MAX_ASSET_LOADER_THREADS = 4;
+// -----------------------------------------------------------------------------
+enum class AssetLoadState
+{
+	PREFETCHING,	// Queued for or owned by a worker thread
+	PREFETCHED,		// File in the OS cache, waiting to be decoded on the main thread
+	READY
+};
+// -----------------------------------------------------------------------------
+struct TextureLoadRequest
+{
+	std::string	  m_filePath;
+	TextureHandle m_handle = INVALID_TEXTURE_HANDLE;
+	Texture*	m_texture = nullptr;
+	std::atomic<AssetLoadState> m_state{ AssetLoadState::PREFETCHING };
+};
+// -----------------------------------------------------------------------------
+// Prefetches image files on worker threads while the main thread keeps going,
+// so the disk reads overlap definition parsing and each other. Workers only
+// read bytes, they do not decode: the renderer only makes textures from a path,
+// so CreateOrGetTextureFromFile still decodes each image serially on the main
+// thread, in Update or while waiting on a handle, against a file that is
+// already in the OS cache. Handles are valid as soon as they are requested, so
+// definitions can hold one before the file has even been read.
+// -----------------------------------------------------------------------------
+class AsyncAssetLoader
+{
+public:
+	AsyncAssetLoader();
+	~AsyncAssetLoader();
+
+	// Main thread only, asking twice for a path returns the same handle
+	TextureHandle RequestTexture(std::string const& filePath);
+
+	// Decodes every file prefetched so far, never waits on a worker
+	void Update();
+
+	// Also decodes anything else that is prefetched while waiting
+	Texture* WaitForTexture(TextureHandle handle);
+	void	 WaitForAll();
+
+	bool	 IsTextureReady(TextureHandle handle) const;
+	Texture* GetTexture(TextureHandle handle) const;		// Null until ready
+	int		 GetNumPending() const;
+
+private:
+	void CreateTexture(TextureLoadRequest& request);
+	void WorkerThreadMain();
+
+private:
+	std::vector<std::unique_ptr<TextureLoadRequest>> m_requests;
+	int m_numPending = 0;
+
+	std::vector<std::thread> m_workerThreads;
+	std::mutex				 m_mutex;
+	std::condition_variable	 m_requestCondition;
+	std::condition_variable	 m_prefetchedCondition;
+	std::deque<TextureLoadRequest*> m_requestQueue;
+	std::deque<TextureHandle>		m_prefetchedHandles;
+	bool							m_isQuitting = false;
+};
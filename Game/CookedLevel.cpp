@@ -0,0 +1,275 @@
+#include "Game/CookedLevel.hpp"
+#include "Game/LevelDefinition.hpp"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+// -----------------------------------------------------------------------------
+static char const COOKED_LEVEL_FOURCC[4] = { 'R', 'N', 'L', 'V' };
+// -----------------------------------------------------------------------------
+// Stored byte for byte, anything with pointers or a vtable would break the format
+static_assert(std::is_trivially_copyable<CookedLevelEntry>::value, "CookedLevelEntry must be trivially copyable");
+static_assert(std::is_trivially_copyable<BlockInstance>::value, "BlockInstance must be trivially copyable");
+static_assert(std::is_trivially_copyable<BVHNode>::value, "BVHNode must be trivially copyable");
+static_assert(std::is_trivially_copyable<EulerAngles>::value, "EulerAngles must be trivially copyable");
+static_assert(sizeof(CookedLevelFileHeader) % COOKED_ARRAY_ALIGNMENT == 0, "Entries must start aligned");
+// -----------------------------------------------------------------------------
+static uint32_t AppendAligned(std::vector<unsigned char>& buffer, void const* data, size_t numBytes)
+{
+	size_t alignedSize = (buffer.size() + COOKED_ARRAY_ALIGNMENT - 1) & ~static_cast<size_t>(COOKED_ARRAY_ALIGNMENT - 1);
+	buffer.resize(alignedSize, 0);
+	uint32_t byteOffset = static_cast<uint32_t>(buffer.size());
+	unsigned char const* bytes = static_cast<unsigned char const*>(data);
+	buffer.insert(buffer.end(), bytes, bytes + numBytes);
+	return byteOffset;
+}
+
+static bool CopyCookedName(char (&out_name)[COOKED_NAME_LENGTH], std::string const& name)
+{
+	if (name.size() >= COOKED_NAME_LENGTH)
+	{
+		return false;
+	}
+	memset(out_name, 0, COOKED_NAME_LENGTH);
+	memcpy(out_name, name.c_str(), name.size());
+	return true;
+}
+
+static bool IsCookedNameTerminated(char const (&name)[COOKED_NAME_LENGTH])
+{
+	return memchr(name, '\0', COOKED_NAME_LENGTH) != nullptr;
+}
+
+static bool HashSourceFile(char const* sourcePath, uint64_t& out_hash, uint32_t& out_size)
+{
+	std::ifstream file(sourcePath, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	std::vector<unsigned char> source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	// FNV-1a over the exact bytes, any edit to the XML changes it
+	uint64_t hash = 14695981039346656037ull;
+	for (unsigned char sourceByte : source)
+	{
+		hash ^= sourceByte;
+		hash *= 1099511628211ull;
+	}
+	out_hash = hash;
+	out_size = static_cast<uint32_t>(source.size());
+	return true;
+}
+// -----------------------------------------------------------------------------
+bool CookedLevelFile::Open(char const* filePath, char const* sourcePath)
+{
+	Close();
+	uint64_t sourceHash = 0;
+	uint32_t sourceSize = 0;
+	if (!HashSourceFile(sourcePath, sourceHash, sourceSize) || !m_file.Open(filePath))
+	{
+		return false;
+	}
+
+	// A file from another version, cooked from other XML, or a truncated copy is treated as missing, the caller falls back to XML
+	CookedLevelFileHeader const* header = reinterpret_cast<CookedLevelFileHeader const*>(m_file.GetData());
+	if (m_file.GetSize() < sizeof(CookedLevelFileHeader) || memcmp(header->m_fourCC, COOKED_LEVEL_FOURCC, 4) != 0 ||
+		header->m_version != COOKED_LEVEL_VERSION || header->m_fileSize != m_file.GetSize() ||
+		header->m_sourceHash != sourceHash || header->m_sourceSize != sourceSize ||
+		!IsRangeValid(sizeof(CookedLevelFileHeader), static_cast<size_t>(header->m_numLevels) * sizeof(CookedLevelEntry)))
+	{
+		Close();
+		return false;
+	}
+
+	CookedLevelEntry const* entries = reinterpret_cast<CookedLevelEntry const*>(m_file.GetData() + sizeof(CookedLevelFileHeader));
+	m_levels.resize(header->m_numLevels);
+	for (uint32_t levelIndex = 0; levelIndex < header->m_numLevels; ++levelIndex)
+	{
+		CookedLevelEntry const& entry = entries[levelIndex];
+		size_t numBlocks = entry.m_numBlocks;
+		size_t numPaddedBlocks = numBlocks + BLOCK_SIMD_WIDTH - 1;
+
+		bool isValid = IsCookedNameTerminated(entry.m_levelName) && IsCookedNameTerminated(entry.m_shaderName);
+		isValid = isValid && IsRangeValid(entry.m_colorsOffset, numBlocks * sizeof(Rgba8));
+		isValid = isValid && IsRangeValid(entry.m_orientationsOffset, numBlocks * sizeof(EulerAngles));
+		isValid = isValid && IsRangeValid(entry.m_instancesOffset, numBlocks * sizeof(BlockInstance));
+		isValid = isValid && IsRangeValid(entry.m_bvhNodesOffset, entry.m_numBVHNodes * sizeof(BVHNode));
+		isValid = isValid && IsRangeValid(entry.m_leafPrimBoundsOffset, numBlocks * sizeof(AABB3));
+		for (int arrayIndex = 0; arrayIndex < NUM_BLOCK_FLOAT_ARRAYS; ++arrayIndex)
+		{
+			isValid = isValid && IsRangeValid(entry.m_floatArrayOffsets[arrayIndex], numPaddedBlocks * sizeof(float));
+		}
+
+		// LevelBVH::AdoptPrebuilt takes the nodes as they are, so every child and prim index is checked here
+		isValid = isValid && IsBVHValid(reinterpret_cast<BVHNode const*>(m_file.GetData() + entry.m_bvhNodesOffset), entry.m_numBVHNodes, entry.m_numBlocks);
+		if (!isValid)
+		{
+			Close();
+			return false;
+		}
+
+		unsigned char const* data = m_file.GetData();
+		CookedLevelView& view = m_levels[levelIndex];
+		view.m_entry = &entry;
+		for (int arrayIndex = 0; arrayIndex < NUM_BLOCK_FLOAT_ARRAYS; ++arrayIndex)
+		{
+			view.m_floatArrays[arrayIndex] = reinterpret_cast<float const*>(data + entry.m_floatArrayOffsets[arrayIndex]);
+		}
+		view.m_colors = reinterpret_cast<Rgba8 const*>(data + entry.m_colorsOffset);
+		view.m_orientations = reinterpret_cast<EulerAngles const*>(data + entry.m_orientationsOffset);
+		view.m_instances = reinterpret_cast<BlockInstance const*>(data + entry.m_instancesOffset);
+		view.m_bvhNodes = reinterpret_cast<BVHNode const*>(data + entry.m_bvhNodesOffset);
+		view.m_leafPrimBounds = reinterpret_cast<AABB3 const*>(data + entry.m_leafPrimBoundsOffset);
+	}
+	return true;
+}
+
+void CookedLevelFile::Close()
+{
+	m_levels.clear();
+	m_file.Close();
+}
+
+int CookedLevelFile::GetNumLevels() const
+{
+	return static_cast<int>(m_levels.size());
+}
+
+CookedLevelView const* CookedLevelFile::GetLevel(int levelIndex) const
+{
+	return &m_levels[levelIndex];
+}
+
+bool CookedLevelFile::IsRangeValid(uint32_t byteOffset, size_t numBytes) const
+{
+	return (byteOffset % COOKED_ARRAY_ALIGNMENT) == 0 && byteOffset <= m_file.GetSize() && numBytes <= m_file.GetSize() - byteOffset;
+}
+
+bool CookedLevelFile::IsBVHValid(BVHNode const* nodes, uint32_t numNodes, uint32_t numPrims)
+{
+	if (numNodes == 0)
+	{
+		return numPrims == 0;
+	}
+
+	// Walks the tree the way the queries do, so a node reached twice or a stack deeper than
+	// theirs is rejected here instead of looping or overflowing at runtime
+	std::vector<unsigned char> wasVisited(numNodes, 0);
+	int nodeStack[BVH_MAX_TRAVERSAL_DEPTH];
+	int stackSize = 0;
+	nodeStack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		int nodeIndex = nodeStack[--stackSize];
+		if (wasVisited[nodeIndex])
+		{
+			return false;
+		}
+		wasVisited[nodeIndex] = 1;
+
+		BVHNode const& node = nodes[nodeIndex];
+		if (node.m_primCount < 0)
+		{
+			return false;
+		}
+		if (node.m_primCount > 0)
+		{
+			int64_t primEnd = static_cast<int64_t>(node.m_firstPrimOrRightChild) + node.m_primCount;
+			if (node.m_firstPrimOrRightChild < 0 || primEnd > static_cast<int64_t>(numPrims))
+			{
+				return false;
+			}
+			continue;
+		}
+
+		// Children always come after their parent, the left one right after it
+		int64_t leftChild = static_cast<int64_t>(nodeIndex) + 1;
+		int64_t rightChild = node.m_firstPrimOrRightChild;
+		if (leftChild >= numNodes || rightChild <= leftChild || rightChild >= numNodes || stackSize + 2 > BVH_MAX_TRAVERSAL_DEPTH)
+		{
+			return false;
+		}
+		nodeStack[stackSize++] = node.m_firstPrimOrRightChild;
+		nodeStack[stackSize++] = nodeIndex + 1;
+	}
+	return true;
+}
+// -----------------------------------------------------------------------------
+bool CookLevelDefinitions(std::vector<LevelDefinition*> const& levelDefs, char const* sourcePath, char const* filePath)
+{
+	CookedLevelFileHeader header;
+	memset(&header, 0, sizeof(CookedLevelFileHeader));
+	if (!HashSourceFile(sourcePath, header.m_sourceHash, header.m_sourceSize))
+	{
+		return false;
+	}
+
+	// Header and entry table first, entries are filled in once their arrays have offsets
+	std::vector<unsigned char> buffer(sizeof(CookedLevelFileHeader) + levelDefs.size() * sizeof(CookedLevelEntry), 0);
+	std::vector<CookedLevelEntry> entries(levelDefs.size());
+	std::vector<BlockInstance> instances;
+	std::vector<float> paddedArray;
+
+	for (size_t levelIndex = 0; levelIndex < levelDefs.size(); ++levelIndex)
+	{
+		LevelDefinition const& levelDef = *levelDefs[levelIndex];
+		CookedLevelEntry& entry = entries[levelIndex];
+		memset(static_cast<void*>(&entry), 0, sizeof(CookedLevelEntry));		// Padding too, so cooking the same XML gives the same bytes
+		if (!CopyCookedName(entry.m_levelName, levelDef.m_levelName) || !CopyCookedName(entry.m_shaderName, levelDef.m_shaderName))
+		{
+			return false;
+		}
+
+		// Same layout and BVH the runtime would build from XML, so collision and replays match exactly
+		SimLevel simLevel;
+		simLevel.LayoutFromDefinition(levelDef);
+		simLevel.BuildBlockBVH();
+		LevelBlocks const& blocks = simLevel.GetBlocks();
+		LevelBVH const& blockBVH = simLevel.GetBlockBVH();
+		int numBlocks = blocks.GetNumBlocks();
+
+		entry.m_numBlocks = static_cast<uint32_t>(numBlocks);
+		for (int arrayIndex = 0; arrayIndex < NUM_BLOCK_FLOAT_ARRAYS; ++arrayIndex)
+		{
+			// A level with no blocks never got its padding, the file always carries it
+			paddedArray = blocks.GetFloatArray(arrayIndex);
+			paddedArray.resize(numBlocks + BLOCK_SIMD_WIDTH - 1, 0.f);
+			entry.m_floatArrayOffsets[arrayIndex] = AppendAligned(buffer, paddedArray.data(), paddedArray.size() * sizeof(float));
+		}
+		entry.m_colorsOffset = AppendAligned(buffer, blocks.m_colors.data(), blocks.m_colors.size() * sizeof(Rgba8));
+		entry.m_orientationsOffset = AppendAligned(buffer, blocks.m_orientations.data(), blocks.m_orientations.size() * sizeof(EulerAngles));
+
+		instances.clear();
+		for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+		{
+			instances.push_back(MakeBlockInstance(blocks.GetBlockBounds(blockIndex), blocks.GetBlockColor(blockIndex)));
+		}
+		entry.m_instancesOffset = AppendAligned(buffer, instances.data(), instances.size() * sizeof(BlockInstance));
+
+		entry.m_numBVHNodes = static_cast<uint32_t>(blockBVH.GetNumNodes());
+		entry.m_bvhNodesOffset = AppendAligned(buffer, blockBVH.GetNodes().data(), blockBVH.GetNodes().size() * sizeof(BVHNode));
+		entry.m_leafPrimBoundsOffset = AppendAligned(buffer, blockBVH.GetLeafPrimBounds().data(), blockBVH.GetLeafPrimBounds().size() * sizeof(AABB3));
+
+		entry.m_hasEndGoal = simLevel.HasEndGoal() ? 1u : 0u;
+		entry.m_endGoal = simLevel.GetEndGoal();
+	}
+
+	memcpy(header.m_fourCC, COOKED_LEVEL_FOURCC, 4);
+	header.m_version = COOKED_LEVEL_VERSION;
+	header.m_fileSize = static_cast<uint32_t>(buffer.size());
+	header.m_numLevels = static_cast<uint32_t>(levelDefs.size());
+	memcpy(buffer.data(), &header, sizeof(CookedLevelFileHeader));
+	if (!entries.empty())
+	{
+		memcpy(buffer.data() + sizeof(CookedLevelFileHeader), entries.data(), entries.size() * sizeof(CookedLevelEntry));
+	}
+
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		return false;
+	}
+	file.write(reinterpret_cast<char const*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+	return file.good();
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "Game/SimLevel.hpp"
+#include "Game/LevelBlockMesh.hpp"
+#include "Game/MappedFile.hpp"
+#include <cstdint>
+#include <vector>
+// -----------------------------------------------------------------------------
+struct LevelDefinition;
+// -----------------------------------------------------------------------------
+constexpr uint32_t COOKED_LEVEL_VERSION = 3;
+constexpr int	   COOKED_NAME_LENGTH = 64;
+constexpr uint32_t COOKED_ARRAY_ALIGNMENT = 16;
+// -----------------------------------------------------------------------------
+// Cooked level file: a header, a CookedLevelEntry per level, then the arrays the
+// entries point at by byte offset. Everything is stored exactly as the runtime
+// holds it in memory, so loading is bounds checks and pointer arithmetic.
+// Bump COOKED_LEVEL_VERSION whenever any stored struct changes. The header keeps
+// a hash of the XML it was cooked from, so a file older than its XML is ignored.
+// -----------------------------------------------------------------------------
+struct CookedLevelFileHeader
+{
+	char	 m_fourCC[4];
+	uint32_t m_version;
+	uint32_t m_fileSize;
+	uint32_t m_numLevels;
+	uint64_t m_sourceHash;
+	uint32_t m_sourceSize;
+	uint32_t m_padding;
+};
+// -----------------------------------------------------------------------------
+struct CookedLevelEntry
+{
+	char	 m_levelName[COOKED_NAME_LENGTH];
+	char	 m_shaderName[COOKED_NAME_LENGTH];
+	uint32_t m_numBlocks;
+	uint32_t m_floatArrayOffsets[NUM_BLOCK_FLOAT_ARRAYS];	// LevelBlocks arrays in BVH leaf order, padded like LevelBlocks pads them
+	uint32_t m_colorsOffset;
+	uint32_t m_orientationsOffset;
+	uint32_t m_instancesOffset;								// A BlockInstance per block, ready for the block mesh slots
+	uint32_t m_numBVHNodes;
+	uint32_t m_bvhNodesOffset;
+	uint32_t m_leafPrimBoundsOffset;
+	uint32_t m_hasEndGoal;
+	EndGoal	 m_endGoal;
+};
+// -----------------------------------------------------------------------------
+// Typed pointers into the mapped file, valid while it stays open
+// -----------------------------------------------------------------------------
+struct CookedLevelView
+{
+	CookedLevelEntry const* m_entry = nullptr;
+	float const*			m_floatArrays[NUM_BLOCK_FLOAT_ARRAYS] = {};
+	Rgba8 const*			m_colors = nullptr;
+	EulerAngles const*		m_orientations = nullptr;
+	BlockInstance const*	m_instances = nullptr;
+	BVHNode const*			m_bvhNodes = nullptr;
+	AABB3 const*			m_leafPrimBounds = nullptr;
+};
+// -----------------------------------------------------------------------------
+class CookedLevelFile
+{
+public:
+	// False for a missing, damaged or stale file, the caller then loads sourcePath instead
+	bool Open(char const* filePath, char const* sourcePath);
+	void Close();
+
+	int GetNumLevels() const;
+	CookedLevelView const* GetLevel(int levelIndex) const;
+
+private:
+	bool IsRangeValid(uint32_t byteOffset, size_t numBytes) const;
+	static bool IsBVHValid(BVHNode const* nodes, uint32_t numNodes, uint32_t numPrims);
+
+private:
+	MappedFile					 m_file;
+	std::vector<CookedLevelView> m_levels;
+};
+// -----------------------------------------------------------------------------
+// Offline step, lays out and builds the BVH for every definition then writes the result.
+// The definitions must have been loaded from sourcePath
+bool CookLevelDefinitions(std::vector<LevelDefinition*> const& levelDefs, char const* sourcePath, char const* filePath);
@@ -0,0 +1,121 @@
+#include "Game/EndlessChunkGenerator.hpp"
+#include <cmath>
+// -----------------------------------------------------------------------------
+constexpr float ENDLESS_BLOCK_THICKNESS = 0.8f;
+constexpr float ENDLESS_MIN_BLOCK_LENGTH = 4.f;
+constexpr float ENDLESS_MAX_BLOCK_LENGTH = 7.f;
+constexpr float ENDLESS_MIN_GAP = 1.5f;
+constexpr float ENDLESS_MAX_GAP = 3.f;
+constexpr float ENDLESS_MAX_LANE_OFFSET = 3.f;
+// -----------------------------------------------------------------------------
+static Rgba8 const ENDLESS_CHUNK_COLORS[] =
+{
+	Rgba8(0, 0, 255),
+	Rgba8(255, 0, 0),
+	Rgba8(255, 128, 0),
+	Rgba8(160, 32, 240),
+	Rgba8(0, 200, 200),
+};
+constexpr int NUM_ENDLESS_CHUNK_COLORS = static_cast<int>(sizeof(ENDLESS_CHUNK_COLORS) / sizeof(ENDLESS_CHUNK_COLORS[0]));
+// -----------------------------------------------------------------------------
+static unsigned int HashChunkValue(unsigned int seed, int chunkIndex, int valueIndex)
+{
+	// Integer bit mangling only, so the sequence is identical on every compiler and platform
+	unsigned int value = static_cast<unsigned int>(chunkIndex) * 198491317u + static_cast<unsigned int>(valueIndex) * 6542989u;
+	value *= 0xB5297A4Du;
+	value += seed;
+	value ^= (value >> 8);
+	value += 0x68E31DA4u;
+	value ^= (value << 8);
+	value *= 0x1B56C4E9u;
+	value ^= (value >> 8);
+	return value;
+}
+
+static float GetChunkFloatInRange(unsigned int seed, int chunkIndex, int valueIndex, float minValue, float maxValue)
+{
+	float zeroToOne = static_cast<float>(HashChunkValue(seed, chunkIndex, valueIndex) >> 8) * (1.f / 16777216.f);
+	return minValue + (maxValue - minValue) * zeroToOne;
+}
+
+static float GetChunkEntryHeight(unsigned int seed, int chunkIndex)
+{
+	if (chunkIndex == 0)
+	{
+		return 0.f;
+	}
+	return floorf(GetChunkFloatInRange(seed, chunkIndex, 0, 0.f, 5.f)) * 0.75f;
+}
+
+static float GetChunkEntryLane(unsigned int seed, int chunkIndex)
+{
+	if (chunkIndex == 0)
+	{
+		return 0.f;
+	}
+	return GetChunkFloatInRange(seed, chunkIndex, 1, -ENDLESS_MAX_LANE_OFFSET, ENDLESS_MAX_LANE_OFFSET);
+}
+// -----------------------------------------------------------------------------
+int GetEndlessChunkIndex(float worldX)
+{
+	int chunkIndex = static_cast<int>(floorf(worldX / ENDLESS_CHUNK_LENGTH));
+	return (chunkIndex < 0) ? 0 : chunkIndex;
+}
+
+void GenerateEndlessChunk(unsigned int seed, int chunkIndex, std::vector<SpawnInfo>& out_spawnInfos)
+{
+	out_spawnInfos.clear();
+
+	float chunkStartX = static_cast<float>(chunkIndex) * ENDLESS_CHUNK_LENGTH;
+	float chunkEndX = chunkStartX + ENDLESS_CHUNK_LENGTH - ENDLESS_CHUNK_MARGIN;
+	float entryHeight = GetChunkEntryHeight(seed, chunkIndex);
+	float exitHeight = GetChunkEntryHeight(seed, chunkIndex + 1);
+	float entryLane = GetChunkEntryLane(seed, chunkIndex);
+	float exitLane = GetChunkEntryLane(seed, chunkIndex + 1);
+	Rgba8 chunkColor = ENDLESS_CHUNK_COLORS[HashChunkValue(seed, chunkIndex, 2) % NUM_ENDLESS_CHUNK_COLORS];
+
+	float cursorX = chunkStartX + ENDLESS_CHUNK_MARGIN;
+	if (chunkIndex == 0)
+	{
+		// Same starting pad the authored levels open with, the runner spawns on it
+		SpawnInfo startPad;
+		startPad.m_levelItem = "Block";
+		startPad.m_center = Vec3(1.f, 0.f, -1.f);
+		startPad.m_dimensions = Vec3(10.f, 10.f, 1.f);
+		startPad.m_color = Rgba8(0, 255, 0);
+		out_spawnInfos.push_back(startPad);
+		cursorX = 6.f + ENDLESS_MIN_GAP;
+	}
+
+	int valueIndex = 3;
+	while (static_cast<int>(out_spawnInfos.size()) < ENDLESS_MAX_BLOCKS_PER_CHUNK && cursorX < chunkEndX)
+	{
+		float blockLength = GetChunkFloatInRange(seed, chunkIndex, valueIndex++, ENDLESS_MIN_BLOCK_LENGTH, ENDLESS_MAX_BLOCK_LENGTH);
+		bool isLastBlock = (static_cast<int>(out_spawnInfos.size()) == ENDLESS_MAX_BLOCKS_PER_CHUNK - 1);
+
+		// Stretch the last block to the chunk edge so the gap into the next chunk is never wider than two margins
+		if (isLastBlock || cursorX + blockLength + ENDLESS_MAX_GAP + ENDLESS_MIN_BLOCK_LENGTH > chunkEndX)
+		{
+			blockLength = chunkEndX - cursorX;
+			isLastBlock = true;
+		}
+
+		float chunkFraction = (cursorX + blockLength * 0.5f - chunkStartX) / ENDLESS_CHUNK_LENGTH;
+		float blockHeight = entryHeight + (exitHeight - entryHeight) * chunkFraction + GetChunkFloatInRange(seed, chunkIndex, valueIndex++, -0.5f, 0.5f);
+		float blockLane = entryLane + (exitLane - entryLane) * chunkFraction + GetChunkFloatInRange(seed, chunkIndex, valueIndex++, -1.5f, 1.5f);
+		float blockWidth = GetChunkFloatInRange(seed, chunkIndex, valueIndex++, 2.5f, 5.f);
+
+		SpawnInfo blockInfo;
+		blockInfo.m_levelItem = "Block";
+		blockInfo.m_center = Vec3(cursorX + blockLength * 0.5f, blockLane, blockHeight);
+		blockInfo.m_dimensions = Vec3(blockLength, blockWidth, ENDLESS_BLOCK_THICKNESS);
+		blockInfo.m_color = chunkColor;
+		out_spawnInfos.push_back(blockInfo);
+
+		if (isLastBlock)
+		{
+			break;
+		}
+		cursorX += blockLength + GetChunkFloatInRange(seed, chunkIndex, valueIndex++, ENDLESS_MIN_GAP, ENDLESS_MAX_GAP);
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "Game/LevelDefinition.hpp"
+#include <vector>
+// -----------------------------------------------------------------------------
+constexpr float ENDLESS_CHUNK_LENGTH = 60.f;
+constexpr float ENDLESS_CHUNK_MARGIN = 1.f;			// Blocks stay this far inside their chunk, wider than any runner radius
+constexpr int   ENDLESS_MAX_BLOCKS_PER_CHUNK = 16;
+constexpr float ENDLESS_DEATH_HEIGHT = -20.f;
+// -----------------------------------------------------------------------------
+// Endless layout as a pure function of (seed, chunk index). Every chunk can be
+// rebuilt on its own in any order, on any thread, and always comes out the same.
+// Consecutive chunks agree on the height and lane where one ends and the next
+// begins, so the seams stay jumpable.
+// -----------------------------------------------------------------------------
+int  GetEndlessChunkIndex(float worldX);
+void GenerateEndlessChunk(unsigned int seed, int chunkIndex, std::vector<SpawnInfo>& out_spawnInfos);
@@ -0,0 +1,301 @@
+#include "Game/EndlessLevel.hpp"
+#include "Game/EndlessChunkGenerator.hpp"
+#include "Game/Level.hpp"
+#include "Game/Player.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <cmath>
+#include <cstdlib>
+// -----------------------------------------------------------------------------
+EndlessLevel::EndlessLevel(Game* owner, unsigned int seed, float maxRunnerSpeed)
+	:m_theGame(owner),
+	 m_seed(seed)
+{
+	// The seed is part of the name so input recordings of different layouts never collide
+	m_chunkDefinition.m_levelName = Stringf("Endless%u", seed);
+
+	// Everything the runner can reach before a request is served, plus the chunk it is entering
+	m_numChunksAhead = static_cast<int>(ceilf(maxRunnerSpeed * ENDLESS_WORKER_LATENCY_SECONDS / ENDLESS_CHUNK_LENGTH)) + 1;
+	GUARANTEE_OR_DIE(ENDLESS_CHUNKS_BEHIND + 1 + m_numChunksAhead <= ENDLESS_CHUNK_SLOTS - 1,
+		Stringf("Endless mode needs %d chunks ahead at speed %0.1f, raise ENDLESS_CHUNK_SLOTS", m_numChunksAhead, maxRunnerSpeed));
+	m_streamingStats.m_numChunksAhead = m_numChunksAhead;
+
+	AABB3 deathBounds = AABB3(Vec3(-1000000.f, -1000000.f, ENDLESS_DEATH_HEIGHT - 180.f), Vec3(1000000.f, 1000000.f, ENDLESS_DEATH_HEIGHT));
+	for (int slotIndex = 0; slotIndex < ENDLESS_CHUNK_SLOTS; ++slotIndex)
+	{
+		m_slots[slotIndex].m_level = new Level(owner, &m_chunkDefinition, ENDLESS_MAX_BLOCKS_PER_CHUNK);
+		m_slots[slotIndex].m_level->SetDeathBounds(deathBounds);
+		m_slots[slotIndex].m_spawnInfos.reserve(ENDLESS_MAX_BLOCKS_PER_CHUNK);
+	}
+
+	// The start chunk is built up front so the runner has ground on the very first tick
+	EndlessChunkSlot& startSlot = m_slots[0];
+	startSlot.m_chunkIndex = 0;
+	GenerateChunk(startSlot);
+	startSlot.m_level->UploadGeometry();
+	startSlot.m_state.store(ChunkSlotState::RESIDENT);
+
+	m_workerThread = std::thread(&EndlessLevel::WorkerThreadMain, this);
+}
+
+EndlessLevel::~EndlessLevel()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_requestMutex);
+		m_isQuitting = true;
+	}
+	m_requestCondition.notify_all();
+	m_workerThread.join();
+
+	for (int slotIndex = 0; slotIndex < ENDLESS_CHUNK_SLOTS; ++slotIndex)
+	{
+		delete m_slots[slotIndex].m_level;
+		m_slots[slotIndex].m_level = nullptr;
+	}
+}
+
+void EndlessLevel::Update(float runnerX)
+{
+	int runnerChunk = GetEndlessChunkIndex(runnerX);
+	RequestChunks(runnerChunk);
+	UploadFinishedChunks(runnerChunk);
+}
+
+void EndlessLevel::EnsureChunkAt(float worldX)
+{
+	// Collision has to be identical however the worker is doing, so a late chunk is built here
+	// rather than letting the runner fall through a missing one. RequestChunks reaches far enough
+	// ahead that this only happens when the worker stalls, and each time is counted
+	int chunkIndex = GetEndlessChunkIndex(worldX);
+	int slotIndex = FindSlotForChunk(chunkIndex);
+	if (slotIndex < 0)
+	{
+		m_streamingStats.m_numStalls++;
+	}
+	while (slotIndex < 0)
+	{
+		// Every recyclable slot is still generating, one frees up as soon as the worker finishes it
+		RequestChunks(chunkIndex);
+		slotIndex = FindSlotForChunk(chunkIndex);
+		if (slotIndex < 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	EndlessChunkSlot& slot = m_slots[slotIndex];
+	if (slot.m_state.load() != ChunkSlotState::GENERATING)
+	{
+		return;
+	}
+
+	bool isStillQueued = false;
+	{
+		std::lock_guard<std::mutex> lock(m_requestMutex);
+		for (std::deque<int>::iterator requestIter = m_requestedSlots.begin(); requestIter != m_requestedSlots.end(); ++requestIter)
+		{
+			if (*requestIter == slotIndex)
+			{
+				m_requestedSlots.erase(requestIter);
+				isStillQueued = true;
+				break;
+			}
+		}
+	}
+
+	if (isStillQueued)
+	{
+		m_streamingStats.m_numMainThreadBuilds++;
+		GenerateChunk(slot);
+		slot.m_state.store(ChunkSlotState::READY_TO_UPLOAD);
+		return;
+	}
+
+	// The worker already took it, it is closer to done than starting over
+	m_streamingStats.m_numStalls++;
+	while (slot.m_state.load() == ChunkSlotState::GENERATING)
+	{
+		std::this_thread::yield();
+	}
+}
+
+void EndlessLevel::CullBlocks(ViewFrustum const& frustum, LevelCullStats& out_stats)
+{
+	for (int slotIndex = 0; slotIndex < ENDLESS_CHUNK_SLOTS; ++slotIndex)
+	{
+		if (m_slots[slotIndex].m_state.load() == ChunkSlotState::RESIDENT)
+		{
+			m_slots[slotIndex].m_level->CullBlocks(frustum, out_stats);
+		}
+	}
+}
+
+void EndlessLevel::Render() const
+{
+	for (int slotIndex = 0; slotIndex < ENDLESS_CHUNK_SLOTS; ++slotIndex)
+	{
+		if (m_slots[slotIndex].m_state.load() == ChunkSlotState::RESIDENT)
+		{
+			m_slots[slotIndex].m_level->Render();
+		}
+	}
+}
+
+void EndlessLevel::CastPlayerRays(Player* playerCharacter) const
+{
+	Level const* level = GetResidentLevelAt(playerCharacter->m_renderPosition.x);
+	if (level == nullptr)
+	{
+		playerCharacter->m_shadowRaycast = RaycastResult3D();
+		return;
+	}
+	level->CastPlayerRays(playerCharacter);
+}
+
+SimLevel const& EndlessLevel::GetSimLevelAt(float worldX) const
+{
+	// Blocks sit a margin inside their chunk, so a runner only ever touches the chunk under its center
+	int chunkIndex = GetEndlessChunkIndex(worldX);
+	int slotIndex = FindSlotForChunk(chunkIndex);
+	GUARANTEE_OR_DIE(slotIndex >= 0 && m_slots[slotIndex].m_state.load() != ChunkSlotState::GENERATING, Stringf("Endless chunk %d was not made ready before simulating on it", chunkIndex));
+	return m_slots[slotIndex].m_level->GetSimLevel();
+}
+
+LevelDefinition const* EndlessLevel::GetDefinition() const
+{
+	return &m_chunkDefinition;
+}
+
+unsigned int EndlessLevel::GetSeed() const
+{
+	return m_seed;
+}
+
+EndlessStreamingStats const& EndlessLevel::GetStreamingStats() const
+{
+	return m_streamingStats;
+}
+
+void EndlessLevel::RequestChunks(int runnerChunk)
+{
+	// Keep a window from just behind the runner to m_numChunksAhead past it, nearest first
+	int firstChunk = runnerChunk - ENDLESS_CHUNKS_BEHIND;
+	if (firstChunk < 1)
+	{
+		firstChunk = 1;
+	}
+	int lastChunk = runnerChunk + m_numChunksAhead;
+
+	for (int chunkIndex = firstChunk; chunkIndex <= lastChunk; ++chunkIndex)
+	{
+		if (FindSlotForChunk(chunkIndex) >= 0)
+		{
+			continue;
+		}
+
+		// Recycle the first slot that has fallen out of the window and is not being worked on
+		for (int slotIndex = 1; slotIndex < ENDLESS_CHUNK_SLOTS; ++slotIndex)
+		{
+			EndlessChunkSlot const& slot = m_slots[slotIndex];
+			bool isOutsideWindow = slot.m_chunkIndex < firstChunk || slot.m_chunkIndex > lastChunk;
+			if (isOutsideWindow && slot.m_state.load() != ChunkSlotState::GENERATING)
+			{
+				RequestChunk(slotIndex, chunkIndex);
+				break;
+			}
+		}
+	}
+}
+
+void EndlessLevel::UploadFinishedChunks(int runnerChunk)
+{
+	// Bounded GPU work per frame, nearest chunks to the runner go first
+	for (int uploadIndex = 0; uploadIndex < MAX_CHUNK_UPLOADS_PER_FRAME; ++uploadIndex)
+	{
+		int bestSlot = -1;
+		int bestDistance = 0;
+		for (int slotIndex = 0; slotIndex < ENDLESS_CHUNK_SLOTS; ++slotIndex)
+		{
+			if (m_slots[slotIndex].m_state.load() != ChunkSlotState::READY_TO_UPLOAD)
+			{
+				continue;
+			}
+			int distance = abs(m_slots[slotIndex].m_chunkIndex - runnerChunk);
+			if (bestSlot < 0 || distance < bestDistance)
+			{
+				bestSlot = slotIndex;
+				bestDistance = distance;
+			}
+		}
+		if (bestSlot < 0)
+		{
+			return;
+		}
+
+		m_slots[bestSlot].m_level->UploadGeometry();
+		m_slots[bestSlot].m_state.store(ChunkSlotState::RESIDENT);
+	}
+}
+
+void EndlessLevel::RequestChunk(int slotIndex, int chunkIndex)
+{
+	EndlessChunkSlot& slot = m_slots[slotIndex];
+	slot.m_chunkIndex = chunkIndex;
+	slot.m_state.store(ChunkSlotState::GENERATING);
+	{
+		std::lock_guard<std::mutex> lock(m_requestMutex);
+		m_requestedSlots.push_back(slotIndex);
+	}
+	m_requestCondition.notify_one();
+}
+
+void EndlessLevel::GenerateChunk(EndlessChunkSlot& slot)
+{
+	GenerateEndlessChunk(m_seed, slot.m_chunkIndex, slot.m_spawnInfos);
+	slot.m_level->SpawnFromInfos(slot.m_spawnInfos);
+}
+
+int EndlessLevel::FindSlotForChunk(int chunkIndex) const
+{
+	for (int slotIndex = 0; slotIndex < ENDLESS_CHUNK_SLOTS; ++slotIndex)
+	{
+		if (m_slots[slotIndex].m_chunkIndex == chunkIndex)
+		{
+			return slotIndex;
+		}
+	}
+	return -1;
+}
+
+Level const* EndlessLevel::GetResidentLevelAt(float worldX) const
+{
+	int slotIndex = FindSlotForChunk(GetEndlessChunkIndex(worldX));
+	if (slotIndex < 0 || m_slots[slotIndex].m_state.load() != ChunkSlotState::RESIDENT)
+	{
+		return nullptr;
+	}
+	return m_slots[slotIndex].m_level;
+}
+
+void EndlessLevel::WorkerThreadMain()
+{
+	for (;;)
+	{
+		int slotIndex = -1;
+		{
+			std::unique_lock<std::mutex> lock(m_requestMutex);
+			m_requestCondition.wait(lock, [this]() { return m_isQuitting || !m_requestedSlots.empty(); });
+			if (m_isQuitting)
+			{
+				return;
+			}
+			slotIndex = m_requestedSlots.front();
+			m_requestedSlots.pop_front();
+		}
+
+		// The main thread leaves a GENERATING slot alone until the state flips below
+		EndlessChunkSlot& slot = m_slots[slotIndex];
+		GenerateChunk(slot);
+		slot.m_state.store(ChunkSlotState::READY_TO_UPLOAD);
+	}
+}
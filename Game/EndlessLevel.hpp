@@ -0,0 +1,94 @@
+#pragma once
+#include "Game/GameCommon.h"
+#include "Game/SimLevel.hpp"
+#include "Game/LevelDefinition.hpp"
+#include "Game/LevelBlockMesh.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+// -----------------------------------------------------------------------------
+class Level;
+class Player;
+class ViewFrustum;
+// -----------------------------------------------------------------------------
+constexpr int ENDLESS_CHUNK_SLOTS = 8;					// Slot 0 always holds chunk 0 so respawning never waits on generation
+constexpr int ENDLESS_CHUNKS_BEHIND = 1;
+constexpr int MAX_CHUNK_UPLOADS_PER_FRAME = 1;
+constexpr float ENDLESS_WORKER_LATENCY_SECONDS = 2.f;	// Longest a request may take to be generated, far above a normal chunk
+// -----------------------------------------------------------------------------
+struct EndlessStreamingStats
+{
+	int m_numChunksAhead = 0;
+	int m_numMainThreadBuilds = 0;		// Fallbacks where the main thread generated a late chunk itself
+	int m_numStalls = 0;				// Fallbacks where the main thread waited on the worker
+};
+// -----------------------------------------------------------------------------
+enum class ChunkSlotState
+{
+	FREE,
+	GENERATING,			// Owned by the worker thread
+	READY_TO_UPLOAD,	// Layout and collision built, waiting for its GPU copy. Collision is usable from here on
+	RESIDENT
+};
+// -----------------------------------------------------------------------------
+struct EndlessChunkSlot
+{
+	Level* m_level = nullptr;
+	int	   m_chunkIndex = -1;
+	std::atomic<ChunkSlotState> m_state{ ChunkSlotState::FREE };
+	std::vector<SpawnInfo> m_spawnInfos;
+};
+// -----------------------------------------------------------------------------
+// Endless mode streams generated chunks through a fixed ring of Level slots. A
+// worker thread lays out and builds collision for upcoming chunks, the main
+// thread only copies finished ones into buffers made up front, so neither
+// memory nor frame time grows with distance run. Chunks are requested further
+// ahead than the fastest runner covers in ENDLESS_WORKER_LATENCY_SECONDS, so the
+// main thread fallback in EnsureChunkAt only runs when the worker falls badly
+// behind, and every time it does shows in the stats.
+// -----------------------------------------------------------------------------
+class EndlessLevel
+{
+public:
+	EndlessLevel(Game* owner, unsigned int seed, float maxRunnerSpeed);
+	~EndlessLevel();
+
+	void Update(float runnerX);
+	void EnsureChunkAt(float worldX);
+	void CullBlocks(ViewFrustum const& frustum, LevelCullStats& out_stats);
+	void Render() const;
+	void CastPlayerRays(Player* playerCharacter) const;
+
+	// The chunk must have been made ready by EnsureChunkAt
+	SimLevel const& GetSimLevelAt(float worldX) const;
+	LevelDefinition const* GetDefinition() const;
+	unsigned int GetSeed() const;
+	EndlessStreamingStats const& GetStreamingStats() const;
+
+private:
+	void RequestChunks(int runnerChunk);
+	void UploadFinishedChunks(int runnerChunk);
+	void RequestChunk(int slotIndex, int chunkIndex);
+	void GenerateChunk(EndlessChunkSlot& slot);
+	int  FindSlotForChunk(int chunkIndex) const;
+	Level const* GetResidentLevelAt(float worldX) const;
+	void WorkerThreadMain();
+
+private:
+	Game*			 m_theGame = nullptr;
+	unsigned int	 m_seed = 0;
+	LevelDefinition	 m_chunkDefinition;
+	EndlessChunkSlot m_slots[ENDLESS_CHUNK_SLOTS];
+	int				 m_numChunksAhead = 0;
+
+	EndlessStreamingStats m_streamingStats;		// Since the run started
+
+	std::thread				m_workerThread;
+	std::mutex				m_requestMutex;
+	std::condition_variable m_requestCondition;
+	std::deque<int>			m_requestedSlots;
+	bool					m_isQuitting = false;
+};
@@ -0,0 +1,52 @@
+#include "Game/FrameScratch.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+// -----------------------------------------------------------------------------
+std::vector<Vertex_PCU>& FrameScratch::AcquirePCU()
+{
+	return AcquireFromPool(m_pcuPool);
+}
+
+void FrameScratch::EndFrame()
+{
+	m_lastFrameStats = FrameScratchStats();
+	ResetPool(m_pcuPool, m_lastFrameStats);
+}
+
+FrameScratchStats const& FrameScratch::GetLastFrameStats() const
+{
+	return m_lastFrameStats;
+}
+
+template<typename VertexType>
+std::vector<VertexType>& FrameScratch::AcquireFromPool(ScratchPool<VertexType>& pool)
+{
+	GUARANTEE_OR_DIE(pool.m_numInUse < MAX_FRAME_SCRATCH_ARRAYS, "Out of frame scratch arrays, raise MAX_FRAME_SCRATCH_ARRAYS");
+	std::vector<VertexType>& scratchArray = pool.m_arrays[pool.m_numInUse];
+	pool.m_numInUse++;
+	return scratchArray;
+}
+
+template<typename VertexType>
+void FrameScratch::ResetPool(ScratchPool<VertexType>& pool, FrameScratchStats& out_stats)
+{
+	out_stats.m_numArraysUsed += pool.m_numInUse;
+	for (int arrayIndex = 0; arrayIndex < pool.m_numInUse; ++arrayIndex)
+	{
+		std::vector<VertexType>& scratchArray = pool.m_arrays[arrayIndex];
+		out_stats.m_numVertsUsed += static_cast<int>(scratchArray.size());
+		if (scratchArray.capacity() != pool.m_capacities[arrayIndex])
+		{
+			out_stats.m_numScratchGrowths++;
+			pool.m_capacities[arrayIndex] = scratchArray.capacity();
+		}
+
+		// Keeps the storage for next frame
+		scratchArray.clear();
+	}
+	pool.m_numInUse = 0;
+
+	for (int arrayIndex = 0; arrayIndex < MAX_FRAME_SCRATCH_ARRAYS; ++arrayIndex)
+	{
+		out_stats.m_reservedBytes += pool.m_capacities[arrayIndex] * sizeof(VertexType);
+	}
+}
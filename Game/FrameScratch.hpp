@@ -0,0 +1,49 @@
+#pragma once
+#include "Engine/Core/Vertex_PCU.h"
+#include <cstddef>
+#include <vector>
+// -----------------------------------------------------------------------------
+constexpr int MAX_FRAME_SCRATCH_ARRAYS = 16;		// Live at once within a frame
+// -----------------------------------------------------------------------------
+struct FrameScratchStats
+{
+	int	   m_numArraysUsed = 0;
+	int	   m_numVertsUsed = 0;
+	int	   m_numScratchGrowths = 0;		// Arrays whose storage grew, zero once every path has run at its largest
+	size_t m_reservedBytes = 0;
+};
+// -----------------------------------------------------------------------------
+// Vertex arrays for geometry that lives for one frame. Arrays are handed out in
+// order and all come back at EndFrame still holding their storage, so after the
+// first few frames building transient geometry stops growing them. They are
+// plain std::vectors because the engine's AddVerts helpers and DrawVertexArray
+// take nothing else.
+// -----------------------------------------------------------------------------
+class FrameScratch
+{
+public:
+	// Empty, valid until EndFrame
+	std::vector<Vertex_PCU>& AcquirePCU();
+
+	void EndFrame();
+	FrameScratchStats const& GetLastFrameStats() const;
+
+private:
+	template<typename VertexType>
+	struct ScratchPool
+	{
+		std::vector<VertexType> m_arrays[MAX_FRAME_SCRATCH_ARRAYS];
+		size_t					m_capacities[MAX_FRAME_SCRATCH_ARRAYS] = {};
+		int						m_numInUse = 0;
+	};
+
+	template<typename VertexType>
+	static std::vector<VertexType>& AcquireFromPool(ScratchPool<VertexType>& pool);
+
+	template<typename VertexType>
+	static void ResetPool(ScratchPool<VertexType>& pool, FrameScratchStats& out_stats);
+
+private:
+	ScratchPool<Vertex_PCU> m_pcuPool;
+	FrameScratchStats		m_lastFrameStats;
+};
@@ -3,8 +3,19 @@
 #include "Game/App.h"
 #include "Game/PlayerDefinition.hpp"
 #include "Game/Player.hpp"
+#include "Game/PlayerMeshCache.hpp"
 #include "Game/Level.hpp"
 #include "Game/LevelDefinition.hpp"
+#include "Game/LevelCatalog.hpp"
+#include "Game/AsyncAssetLoader.hpp"
+#include "Game/ShaderLibrary.hpp"
+#include "Game/FrameScratch.hpp"
+#include "Game/TextMeshCache.hpp"
+#include "Game/MenuUI.hpp"
+#include "Game/RenderQueue.hpp"
+#include "Game/EndlessLevel.hpp"
+#include "Game/ViewFrustum.hpp"
+#include "Game/AllocationCounter.hpp"
 
 #include "Engine/Input/InputSystem.h"
 #include "Engine/Renderer/Renderer.h"
@@ -19,9 +30,7 @@
 #include "Engine/Core/DebugRender.hpp"
 #include "Engine/Math/MathUtils.h"
 #include "Engine/Math/AABB3.hpp"
-#include "Engine/UI/UISystem.hpp"
-#include "Engine/UI/Elements/UIButton.hpp"
-#include "Engine/UI/Elements/UIBorder.hpp"
+#include <cstdio>
 
 Game::Game(App* owner)
 	: m_app(owner)
@@ -31,6 +40,34 @@ Game::Game(App* owner)
 	m_clickSoundPath = g_gameConfigBlackboard.GetValue("buttonClickSound", "default");
 	m_musicVolume = g_gameConfigBlackboard.GetValue("musicVolume", 0.f);
 
+	// Fixed simulation rate
+	float simulationHz = g_gameConfigBlackboard.GetValue("simulationHz", 120.f);
+	GUARANTEE_OR_DIE(simulationHz > 0.f, "GameConfig simulationHz must be greater than zero");
+	m_simulationTimestep = 1.f / simulationHz;
+	m_maxSimulationSubsteps = g_gameConfigBlackboard.GetValue("maxSimulationSubsteps", 8);
+	if (m_maxSimulationSubsteps < 1)
+	{
+		m_maxSimulationSubsteps = 1;
+	}
+
+	// Input recording, every level attempt is written to or read from its own file in the folder
+	std::string inputRecordingMode = g_gameConfigBlackboard.GetValue("inputRecordingMode", "Off");
+	if (inputRecordingMode == "Record")
+	{
+		m_inputRecordingMode = InputRecordingMode::RECORD;
+	}
+	else if (inputRecordingMode == "Replay")
+	{
+		m_inputRecordingMode = InputRecordingMode::REPLAY;
+	}
+	m_inputRecordingFolder = g_gameConfigBlackboard.GetValue("inputRecordingFolder", "Data/Recordings/");
+
+	m_levelCullDistance = g_gameConfigBlackboard.GetValue("levelCullDistance", m_levelCullDistance);
+	m_levelMemoryBudgetMB = g_gameConfigBlackboard.GetValue("levelMemoryBudgetMB", m_levelMemoryBudgetMB);
+
+	int endlessSeed = g_gameConfigBlackboard.GetValue("endlessSeed", 0);
+	m_endlessSeed = static_cast<unsigned int>(endlessSeed);
+
 	m_gameMusic = g_theAudio->CreateOrGetSound(m_gameMusicPath);
 	m_clickSound = g_theAudio->CreateOrGetSound(m_clickSoundPath);
 	m_gameMusicPlayback = m_gameMusic;
@@ -57,98 +94,82 @@ void Game::StartUp()
 	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "F4    - Toggle camera switch");
 	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "K     - Toggle unlock mode (unlocks all levels for testing)");
 	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "L     - Toggle planar shadow on/off");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "LevelMemory - List memory held by each loaded level");
 	g_theDevConsole->AddLine(Rgba8::SEAWEED, "----------------------------------------------------------------------");
 
-	m_backgroundTexture = g_theRenderer->CreateOrGetTextureFromFile("Data/Images/galaxy.jpg");
+	// Image files are prefetched on worker threads while definitions are parsed here, decoding stays on this thread
+	m_assetLoader = new AsyncAssetLoader();
+	TextureHandle backgroundTexture = m_assetLoader->RequestTexture("Data/Images/galaxy.jpg");
+	TextureHandle fontTexture = m_assetLoader->RequestTexture("Data/Fonts/SquirrelFixedFont.png");
+
+	m_playerMeshCache = new PlayerMeshCache();
+	PlayerDefinition::InitializePlayerDefintions(*m_assetLoader);
+	LevelDefinition::InitializeLevelDefinitions();
+	InitializeLevels();
+
+	// The menus need only these two, sprite sheets finish loading behind them
+	m_backgroundTexture = m_assetLoader->WaitForTexture(backgroundTexture);
+	m_assetLoader->WaitForTexture(fontTexture);
 	m_font = g_theRenderer->CreateOrGetBitmapFont("Data/Fonts/SquirrelFixedFont");
+	m_textMeshCache = new TextMeshCache(m_font);
+	m_menuUI = new MenuUI(m_textMeshCache);
+	BuildMenuScreens();
 
 	EnterState(GameState::MAIN_MENU);
 	m_gameClock = new Clock(Clock::GetSystemClock());
-
-	PlayerDefinition::InitializePlayerDefintions();
-	LevelDefinition::InitializeLevelDefinitions();
-
-	InitializeLevels();
+	SubscribeEventCallbackFunction("LevelMemory", Command_LevelMemory);
 }
 
 void Game::InitializeRunner()
 {
+	PlayerDefinition::WaitForPendingVisuals(*m_assetLoader);
 	m_player = new Player(this, Vec3::ZERO, EulerAngles::ZERO, Rgba8(0, 0, 0, 180), PlayerDefinition::GetPlayerByName("Runner"));
 }
 
 void Game::InitializeSkater()
 {
+	PlayerDefinition::WaitForPendingVisuals(*m_assetLoader);
 	m_player = new Player(this, Vec3::ZERO, EulerAngles::ZERO, Rgba8(0, 0, 0, 180), PlayerDefinition::GetPlayerByName("Skater"));
 }
 
 void Game::InitializeLevels()
 {
-	m_levels.push_back(new Level(this, LevelDefinition::GetLevelByName("LevelOne")));
-	m_levels.push_back(new Level(this, LevelDefinition::GetLevelByName("LevelTwo")));
-	m_levels.push_back(new Level(this, LevelDefinition::GetLevelByName("LevelThree")));
-	m_levels.push_back(new Level(this, LevelDefinition::GetLevelByName("LevelFour")));
-	m_levels.push_back(new Level(this, LevelDefinition::GetLevelByName("LevelFive")));
-
+	// Nothing is built yet, levels load when first played
+	size_t memoryBudgetBytes = static_cast<size_t>(m_levelMemoryBudgetMB * 1024.f * 1024.f);
+	m_levelCatalog = new LevelCatalog(this, { "LevelOne", "LevelTwo", "LevelThree", "LevelFour", "LevelFive" }, memoryBudgetBytes);
 	m_levelsUnlocked = { true, false, false, false, false };
+
+	// The first level is almost always played first, start it while the menus are up
+	m_levelCatalog->PrefetchLevel(0);
+}
+
+void Game::BuildMenuScreens()
+{
+	// Every screen is built once here, entering a state only switches which one is shown
+	SetupUIMainMenu();
+	SetupUIControls();
+	SetupCredits();
+	SetupUICharacterSelect();
+	SetupUILevelSelect();
+	RefreshLevelButtons();
 }
 
 void Game::SetupUIMainMenu()
 {
 	AABB2 startButtonBounds = AABB2(600.f, 400.f, 1000.f, 460.f);
 	AABB2 exitButtonBounds = AABB2(600.f, 300.f, 1000.f, 360.f);
-
-	UIButton* startButton = new UIButton("StartButton", startButtonBounds, "Start", m_font);
-	startButton->SetButtonBackgroundColor(Rgba8::SEAWEED);
-	startButton->SetButtonHoverColor(Rgba8(20, 60, 20, 120));
-	startButton->SetOnClickCallback([this]()
-	{
-		g_theAudio->StartSound(m_clickSound, false, m_musicVolume);
-		EnterState(GameState::CHARACTER_SELECT);
-	});
-	g_theUISystem->AddElement(startButton);
-
-	UIBorder* startBorder = new UIBorder("StartButtonBorder", startButtonBounds, Rgba8::BLACK, 2.5f);
-	g_theUISystem->AddElement(startBorder);
-
-	UIButton* exitButton = new UIButton("ExitButton", exitButtonBounds, "Exit", m_font);
-	exitButton->SetButtonBackgroundColor(Rgba8::DARKRED);
-	exitButton->SetButtonHoverColor(Rgba8(139, 0, 0, 120));
-	exitButton->SetOnClickCallback([]()
-	{
-		g_theEventSystem->FireEvent("Quit");
-	});
-	g_theUISystem->AddElement(exitButton);
-
-	UIBorder* exitBorder = new UIBorder("ExitButtonBorder", exitButtonBounds, Rgba8::BLACK, 2.5f);
-	g_theUISystem->AddElement(exitBorder);
-
-	UIButton* controlsButton = new UIButton("ControlsButton", m_controlsButtonBounds, "Controls", m_font);
-	controlsButton->SetButtonBackgroundColor(Rgba8::SEAWEED);
-	controlsButton->SetButtonHoverColor(Rgba8(20, 60, 20, 120));
-	controlsButton->SetOnClickCallback([this]()
-	{
-		g_theAudio->StartSound(m_clickSound, false, m_musicVolume);
-		EnterState(GameState::CONTROLS);
-	});
-	g_theUISystem->AddElement(controlsButton);
-
-	UIBorder* controlsBorder = new UIBorder("ControlsButtonBorder", m_controlsButtonBounds, Rgba8::BLACK, 2.5f);
-	g_theUISystem->AddElement(controlsBorder);
-
 	AABB2 creditBounds = AABB2(1200.f, 100.f, 1400.f, 160.f);
 
-	UIButton* creditsButton = new UIButton("CreditsButton", creditBounds, "Credits", m_font);
-	creditsButton->SetButtonBackgroundColor(Rgba8::SEAWEED);
-	creditsButton->SetButtonHoverColor(Rgba8(20, 60, 20, 120));
-	creditsButton->SetOnClickCallback([this]()
-	{
-		g_theAudio->StartSound(m_clickSound, false, m_musicVolume);
-		EnterState(GameState::CREDITS);
-	});
-	g_theUISystem->AddElement(creditsButton);
-
-	UIBorder* creditsBorder = new UIBorder("CreditsBorder", creditBounds, Rgba8::BLACK, 2.f);
-	g_theUISystem->AddElement(creditsBorder);
+	m_menuUI->BeginScreen(static_cast<int>(GameState::MAIN_MENU));
+	m_menuUI->AddButton(startButtonBounds, "Start", Rgba8::SEAWEED, Rgba8(20, 60, 20, 120), MenuAction::GO_TO_STATE, static_cast<int>(GameState::CHARACTER_SELECT));
+	m_menuUI->AddBorder(startButtonBounds, Rgba8::BLACK, 2.5f);
+	m_menuUI->AddButton(exitButtonBounds, "Exit", Rgba8::DARKRED, Rgba8(139, 0, 0, 120), MenuAction::QUIT);
+	m_menuUI->AddBorder(exitButtonBounds, Rgba8::BLACK, 2.5f);
+	m_menuUI->AddButton(m_controlsButtonBounds, "Controls", Rgba8::SEAWEED, Rgba8(20, 60, 20, 120), MenuAction::GO_TO_STATE, static_cast<int>(GameState::CONTROLS));
+	m_menuUI->AddBorder(m_controlsButtonBounds, Rgba8::BLACK, 2.5f);
+	m_menuUI->AddButton(creditBounds, "Credits", Rgba8::SEAWEED, Rgba8(20, 60, 20, 120), MenuAction::GO_TO_STATE, static_cast<int>(GameState::CREDITS));
+	m_menuUI->AddBorder(creditBounds, Rgba8::BLACK, 2.f);
+	m_menuUI->EndScreen();
 }
 
 void Game::SetupUILevelSelect()
@@ -159,45 +180,26 @@ void Game::SetupUILevelSelect()
 	AABB2 levelFourButtonBounds = AABB2(600.f, 220.f, 1000.f, 280.f);
 	AABB2 levelFiveButtonBounds = AABB2(600.f, 140.f, 1000.f, 200.f);
 	AABB2 backButtonBounds = AABB2(600.f, 60.f, 1000.f, 120.f);
-
-	CreateLevelButton("LevelOneButton", 0, levelOneButtonBounds);
-	CreateLevelButton("LevelTwoButton", 1, levelTwoButtonBounds);
-	CreateLevelButton("LevelThreeButton", 2, levelThreeButtonBounds);
-	CreateLevelButton("LevelFourButton", 3, levelFourButtonBounds);
-	CreateLevelButton("LevelFiveButton", 4, levelFiveButtonBounds);
-
-	UIButton* backButton = new UIButton("BackButton", backButtonBounds, "Back", m_font);
-	backButton->SetButtonBackgroundColor(Rgba8::DARKRED);
-	backButton->SetButtonHoverColor(Rgba8(139, 0, 0, 120));
-	backButton->SetOnClickCallback([this]()
-	{
-		g_theAudio->StartSound(m_clickSound, false, m_musicVolume);
-		DestroyPlayer();
-		EnterState(GameState::CHARACTER_SELECT);
-	});
-	g_theUISystem->AddElement(backButton);
+	AABB2 endlessButtonBounds = AABB2(1100.f, 300.f, 1400.f, 360.f);
+
+	m_menuUI->BeginScreen(static_cast<int>(GameState::LEVEL_SELECT));
+	CreateLevelButton(0, levelOneButtonBounds);
+	CreateLevelButton(1, levelTwoButtonBounds);
+	CreateLevelButton(2, levelThreeButtonBounds);
+	CreateLevelButton(3, levelFourButtonBounds);
+	CreateLevelButton(4, levelFiveButtonBounds);
+	CreateEndlessButton(endlessButtonBounds);
+	m_menuUI->AddButton(backButtonBounds, "Back", Rgba8::DARKRED, Rgba8(139, 0, 0, 120), MenuAction::BACK_TO_CHARACTER_SELECT);
+	m_menuUI->EndScreen();
 }
 
 void Game::SetupUIControls()
 {
-	UIButton* backButton = new UIButton("BackButton", m_controlsButtonBounds, "Back", m_font);
-	backButton->SetButtonBackgroundColor(Rgba8::DARKRED);
-	backButton->SetButtonHoverColor(Rgba8(139, 0, 0, 120));
-	backButton->SetOnClickCallback([this]()
-	{
-		g_theAudio->StartSound(m_clickSound, false, m_musicVolume);
-		EnterState(GameState::MAIN_MENU);
-	});
-	g_theUISystem->AddElement(backButton);
-
-	UIBorder* controlsBorder = new UIBorder("ControlsBorder", AABB2(Vec2(500.f, 650.f), Vec2(1100.f, 150.f)), Rgba8::LIMEGREEN, 2.f);
-	controlsBorder->SetBorderStyle(BorderStyle::DASHED);
-	controlsBorder->SetGapLength(7.f);
-	controlsBorder->SetDashLength(10.f);
-	g_theUISystem->AddElement(controlsBorder);
-
-	UIBorder* backBorder = new UIBorder("BackButtonBorder", m_controlsButtonBounds, Rgba8::BLACK, 5.5f);
-	g_theUISystem->AddElement(backBorder);
+	m_menuUI->BeginScreen(static_cast<int>(GameState::CONTROLS));
+	m_menuUI->AddButton(m_controlsButtonBounds, "Back", Rgba8::DARKRED, Rgba8(139, 0, 0, 120), MenuAction::GO_TO_STATE, static_cast<int>(GameState::MAIN_MENU));
+	m_menuUI->AddDashedBorder(AABB2(Vec2(500.f, 650.f), Vec2(1100.f, 150.f)), Rgba8::LIMEGREEN, 2.f, 10.f, 7.f);
+	m_menuUI->AddBorder(m_controlsButtonBounds, Rgba8::BLACK, 5.5f);
+	m_menuUI->EndScreen();
 }
 
 void Game::SetupUICharacterSelect()
@@ -205,81 +207,100 @@ void Game::SetupUICharacterSelect()
 	AABB2 runnerButtonBounds = AABB2(600.f, 400.f, 1000.f, 460.f);
 	AABB2 skaterButtonBounds = AABB2(600.f, 300.f, 1000.f, 360.f);
 
-	UIButton* runnerButton = new UIButton("RunnerButton", runnerButtonBounds, "Runner", m_font);
-	runnerButton->SetButtonBackgroundColor(Rgba8::SAPPHIRE);
-	runnerButton->SetButtonHoverColor(Rgba8(50, 80, 150, 120));
-	runnerButton->SetOnClickCallback([this]()
-	{
-		g_theAudio->StartSound(m_clickSound, false, m_musicVolume);
-		InitializeRunner();
-		EnterState(GameState::LEVEL_SELECT);
-	});
-	g_theUISystem->AddElement(runnerButton);
+	m_menuUI->BeginScreen(static_cast<int>(GameState::CHARACTER_SELECT));
+	m_menuUI->AddButton(runnerButtonBounds, "Runner", Rgba8::SAPPHIRE, Rgba8(50, 80, 150, 120), MenuAction::PICK_RUNNER);
+	m_menuUI->AddButton(skaterButtonBounds, "Skater", Rgba8::SAPPHIRE, Rgba8(50, 80, 150, 120), MenuAction::PICK_SKATER);
+	m_menuUI->AddButton(m_controlsButtonBounds, "Back", Rgba8::DARKRED, Rgba8(139, 0, 0, 120), MenuAction::GO_TO_STATE, static_cast<int>(GameState::MAIN_MENU));
+	m_menuUI->AddBorder(m_controlsButtonBounds, Rgba8::BLACK, 5.5f);
+	m_menuUI->EndScreen();
+}
 
-	UIButton* skaterButton = new UIButton("SkaterButton", skaterButtonBounds, "Skater", m_font);
-	skaterButton->SetButtonBackgroundColor(Rgba8::SAPPHIRE);
-	skaterButton->SetButtonHoverColor(Rgba8(50, 80, 150, 120));
-	skaterButton->SetOnClickCallback([this]()
-	{
-		g_theAudio->StartSound(m_clickSound, false, m_musicVolume);
-		InitializeSkater();
-		EnterState(GameState::LEVEL_SELECT);
-	});
-	g_theUISystem->AddElement(skaterButton);
+void Game::SetupCredits()
+{
+	m_menuUI->BeginScreen(static_cast<int>(GameState::CREDITS));
+	m_menuUI->AddButton(m_controlsButtonBounds, "Back", Rgba8::DARKRED, Rgba8(139, 0, 0, 120), MenuAction::GO_TO_STATE, static_cast<int>(GameState::MAIN_MENU));
+	m_menuUI->AddBorder(m_controlsButtonBounds, Rgba8::BLACK, 5.5f);
+	m_menuUI->EndScreen();
+}
 
-	UIButton* backButton = new UIButton("BackButton", m_controlsButtonBounds, "Back", m_font);
-	backButton->SetButtonBackgroundColor(Rgba8::DARKRED);
-	backButton->SetButtonHoverColor(Rgba8(139, 0, 0, 120));
-	backButton->SetOnClickCallback([this]()
-	{
-		g_theAudio->StartSound(m_clickSound, false, m_musicVolume);
-		EnterState(GameState::MAIN_MENU);
-	});
-	g_theUISystem->AddElement(backButton);
+void Game::CreateLevelButton(int levelIndex, AABB2 buttonBounds)
+{
+	int buttonIndex = m_menuUI->AddButton(buttonBounds, Stringf("%d", levelIndex + 1), Rgba8::SAPPHIRE, Rgba8(50, 80, 150, 120), MenuAction::PLAY_LEVEL, levelIndex);
+	m_levelButtons.push_back(buttonIndex);
+}
 
-	UIBorder* backBorder = new UIBorder("BackButtonBorder", m_controlsButtonBounds, Rgba8::BLACK, 5.5f);
-	g_theUISystem->AddElement(backBorder);
+void Game::CreateEndlessButton(AABB2 buttonBounds)
+{
+	m_menuUI->AddButton(buttonBounds, "Endless", Rgba8::SEAWEED, Rgba8(20, 60, 20, 120), MenuAction::PLAY_ENDLESS);
+	m_menuUI->AddBorder(buttonBounds, Rgba8::BLACK, 2.5f);
 }
 
-void Game::SetupCredits()
+void Game::RefreshLevelButtons()
 {
-	UIButton* backButton = new UIButton("BackButton", m_controlsButtonBounds, "Back", m_font);
-	backButton->SetButtonBackgroundColor(Rgba8::DARKRED);
-	backButton->SetButtonHoverColor(Rgba8(139, 0, 0, 120));
-	backButton->SetOnClickCallback([this]()
+	// Locked levels stay on screen greyed out and ignore clicks
+	for (int levelIndex = 0; levelIndex < static_cast<int>(m_levelButtons.size()); ++levelIndex)
 	{
-		g_theAudio->StartSound(m_clickSound, false, m_musicVolume);
-		EnterState(GameState::MAIN_MENU);
-	});
-	g_theUISystem->AddElement(backButton);
-
-	UIBorder* backBorder = new UIBorder("BackButtonBorder", m_controlsButtonBounds, Rgba8::BLACK, 5.5f);
-	g_theUISystem->AddElement(backBorder);
+		m_menuUI->SetButtonEnabled(m_levelButtons[levelIndex], m_isUnlockMode || m_levelsUnlocked[levelIndex]);
+	}
 }
 
-void Game::CreateLevelButton(std::string const& buttonName, int levelIndex, AABB2 buttonBounds)
+void Game::HandleMenuClick(MenuClick const& click)
 {
-	UIButton* levelButton = new UIButton(buttonName, buttonBounds, Stringf("%d", levelIndex + 1), m_font);
-	levelButton->SetButtonBackgroundColor(Rgba8::SAPPHIRE);
-	levelButton->SetButtonHoverColor(Rgba8(50, 80, 150, 120));
-
-	if (m_isUnlockMode || m_levelsUnlocked[levelIndex])
+	if (click.m_action == MenuAction::NONE)
 	{
-		levelButton->SetOnClickCallback([this, levelIndex]()
-		{
-			g_theAudio->StartSound(m_clickSound, false, m_musicVolume);
-			m_currentLevelIndex = levelIndex;
-			m_currentLevel = m_levels[levelIndex];
-			EnterState(GameState::LEVEL_PLAYING);
-		});
+		return;
 	}
-	else
+	if (click.m_action == MenuAction::QUIT)
 	{
-		levelButton->SetButtonBackgroundColor(Rgba8::DARKGRAY);
-		levelButton->SetButtonHoverColor(Rgba8::DARKGRAY);
+		g_theEventSystem->FireEvent("Quit");
+		return;
 	}
 
-	g_theUISystem->AddElement(levelButton);
+	g_theAudio->StartSound(m_clickSound, false, m_musicVolume);
+	switch (click.m_action)
+	{
+		case MenuAction::GO_TO_STATE:
+		{
+			EnterState(static_cast<GameState>(click.m_actionParam));
+			break;
+		}
+		case MenuAction::PICK_RUNNER:
+		{
+			InitializeRunner();
+			EnterState(GameState::LEVEL_SELECT);
+			break;
+		}
+		case MenuAction::PICK_SKATER:
+		{
+			InitializeSkater();
+			EnterState(GameState::LEVEL_SELECT);
+			break;
+		}
+		case MenuAction::BACK_TO_CHARACTER_SELECT:
+		{
+			DestroyPlayer();
+			EnterState(GameState::CHARACTER_SELECT);
+			break;
+		}
+		case MenuAction::PLAY_LEVEL:
+		{
+			SetCurrentLevel(click.m_actionParam);
+			m_isEndlessMode = false;
+			EnterState(GameState::LEVEL_PLAYING);
+			break;
+		}
+		case MenuAction::PLAY_ENDLESS:
+		{
+			m_currentLevel = nullptr;
+			m_isEndlessMode = true;
+			EnterState(GameState::LEVEL_PLAYING);
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
 }
 
 void Game::ToggleDebugText()
@@ -291,24 +312,272 @@ void Game::Update()
 {
 	double deltaSeconds = m_gameClock->GetDeltaSeconds();
 
+	uint64_t totalHeapAllocations = GetTotalHeapAllocations();
+	m_lastFrameHeapAllocations = static_cast<int>(totalHeapAllocations - m_heapAllocationsAtLastUpdate);
+	m_heapAllocationsAtLastUpdate = totalHeapAllocations;
+
+	m_textMeshCache->BeginFrame();
 	if (m_isDebugTextOn)
 	{
-		std::string timeScaleText = Stringf("[Game Clock] Time: %0.2f, FPS: %0.2f, TimeScale: %0.2f",
+		// Fixed buffers so an unchanged line costs a compare, a changed one is laid out and uploaded again whole
+		snprintf(m_debugTextLines[0], DEBUG_TEXT_LINE_LENGTH, "[Game Clock] Time: %0.2f, FPS: %0.2f, TimeScale: %0.2f",
 			m_gameClock->GetTotalSeconds(), m_gameClock->GetFrameRate(), m_gameClock->GetTimeScale());
-		DebugAddScreenText(timeScaleText, AABB2(0.f, 0.f, SCREEN_SIZE_X, SCREEN_SIZE_Y), 15.f, Vec2(0.98f, 0.97f), 0.f);
+		snprintf(m_debugTextLines[1], DEBUG_TEXT_LINE_LENGTH, "[Simulation] Rate: %0.0f Hz, Substeps: %d", 1.f / m_simulationTimestep, m_lastFrameSubsteps);
+		snprintf(m_debugTextLines[2], DEBUG_TEXT_LINE_LENGTH, "[Level] Chunks drawn: %d, culled: %d, draw calls: %d",
+			m_levelCullStats.m_numChunksSubmitted, m_levelCullStats.m_numChunksCulled, m_levelCullStats.m_numDrawCalls);
+		snprintf(m_debugTextLines[3], DEBUG_TEXT_LINE_LENGTH, "[Level] Memory: %0.2f MB of %0.2f MB budget",
+			static_cast<float>(m_levelCatalog->GetTotalMemoryBytes()) / (1024.f * 1024.f), static_cast<float>(m_levelCatalog->GetMemoryBudgetBytes()) / (1024.f * 1024.f));
+		snprintf(m_debugTextLines[4], DEBUG_TEXT_LINE_LENGTH, "[Shaders] Loaded: %d, requested: %d",
+			g_theShaderLibrary->GetNumShaders(), g_theShaderLibrary->GetNumRequests());
+		FrameScratchStats const& scratchStats = g_theFrameScratch->GetLastFrameStats();
+		snprintf(m_debugTextLines[5], DEBUG_TEXT_LINE_LENGTH, "[Frame Scratch] Arrays: %d, verts: %d, scratch growths: %d, reserved: %0.1f KB",
+			scratchStats.m_numArraysUsed, scratchStats.m_numVertsUsed, scratchStats.m_numScratchGrowths, static_cast<float>(scratchStats.m_reservedBytes) / 1024.f);
+		TextMeshStats const& textStats = m_textMeshCache->GetLastFrameStats();
+		snprintf(m_debugTextLines[6], DEBUG_TEXT_LINE_LENGTH, "[Text] Cached meshes: %d, draws: %d, layouts: %d, glyphs uploaded: %d",
+			textStats.m_numCachedMeshes, textStats.m_numDraws, textStats.m_numLayouts, textStats.m_numGlyphsUploaded);
+		RenderQueueStats const& renderStats = g_theRenderQueue->GetLastFrameStats();
+		snprintf(m_debugTextLines[7], DEBUG_TEXT_LINE_LENGTH, "[Render Queue] Draws: %d, state changes: %d, redundant skipped: %d",
+			renderStats.m_numDraws, renderStats.m_numStateChanges, renderStats.m_numRedundantStateChanges);
+		if (IsCountingAllocations())
+		{
+			snprintf(m_debugTextLines[8], DEBUG_TEXT_LINE_LENGTH, "[Heap] Allocations last frame: %d", m_lastFrameHeapAllocations);
+		}
+		else
+		{
+			snprintf(m_debugTextLines[8], DEBUG_TEXT_LINE_LENGTH, "[Heap] Allocations are only counted in debug builds");
+		}
+		if (m_endlessLevel != nullptr)
+		{
+			EndlessStreamingStats const& streamingStats = m_endlessLevel->GetStreamingStats();
+			snprintf(m_debugTextLines[9], DEBUG_TEXT_LINE_LENGTH, "[Endless] Chunks ahead: %d, main thread builds: %d, stalls: %d",
+				streamingStats.m_numChunksAhead, streamingStats.m_numMainThreadBuilds, streamingStats.m_numStalls);
+		}
+		else
+		{
+			snprintf(m_debugTextLines[9], DEBUG_TEXT_LINE_LENGTH, "[Endless] Not running");
+		}
 	}
 
-	UpdateUIPresses(static_cast<float>(deltaSeconds));
+	UpdateUIPresses();
+	m_assetLoader->Update();
+	PlayerDefinition::UpdatePendingVisuals(*m_assetLoader);
+	m_levelCatalog->Update();
 
 	if (m_player != nullptr)
 	{
 		m_player->Update(static_cast<float>(deltaSeconds));
-		m_currentLevel->Update(static_cast<float>(deltaSeconds));
 	}
+	UpdateSimulation(static_cast<float>(deltaSeconds));
 
 	AdjustForPauseAndTimeDistortion(static_cast<float>(deltaSeconds));
 	KeyInputPresses();
 	UpdateCameras(static_cast<float>(deltaSeconds));
+	if (m_currentGameState == GameState::LEVEL_PLAYING && m_player != nullptr)
+	{
+		m_player->UpdateSpriteFrame();
+	}
+	CullLevelBlocks();
+}
+
+void Game::UpdateSimulation(float deltaSeconds)
+{
+	m_lastFrameSubsteps = 0;
+	if (m_currentGameState != GameState::LEVEL_PLAYING || m_player == nullptr || GetActiveLevelDefinition() == nullptr)
+	{
+		return;
+	}
+
+	// Streams chunks around where the runner is now, finished chunks upload here and never block on the worker
+	if (m_isEndlessMode)
+	{
+		m_endlessLevel->Update(m_player->m_simState.m_position.x);
+	}
+	else
+	{
+		// Copies only blocks edited since last frame, nothing when the level is untouched
+		m_currentLevel->UploadGeometry();
+	}
+
+	// Physics always advances in whole fixed ticks, leftover time carries into the next frame
+	m_simulationAccumulator += deltaSeconds;
+	while (m_simulationAccumulator >= m_simulationTimestep && m_lastFrameSubsteps < m_maxSimulationSubsteps)
+	{
+		// Live input is always consumed so presses made during a replay don't pile up
+		SimInput simInput = m_player->ConsumeSimInput();
+		if (m_isReplayingInput)
+		{
+			simInput = m_inputReplayCursor.Next();
+		}
+		if (m_inputRecordingMode == InputRecordingMode::RECORD)
+		{
+			m_inputRecording.AppendTick(simInput);
+		}
+
+		// The runner can cross into a new chunk on any tick, it must collide with it whatever the worker's timing
+		if (m_isEndlessMode)
+		{
+			m_endlessLevel->EnsureChunkAt(m_player->m_simState.m_position.x);
+		}
+
+		unsigned int simEvents = m_player->FixedUpdate(GetActiveSimLevel(), simInput, m_simulationTimestep);
+		m_trajectoryHash = HashRunnerState(m_player->m_simState, m_trajectoryHash);
+		if (m_isReplayingInput && !m_isReplayHashChecked && m_inputReplayCursor.IsFinished())
+		{
+			CheckReplayTrajectoryHash();
+		}
+		m_simulationAccumulator -= m_simulationTimestep;
+		++m_lastFrameSubsteps;
+
+		if (simEvents & SIM_EVENT_REACHED_END_GOAL)
+		{
+			AdvanceToNextLevel();
+		}
+
+		// Finishing the last level leaves LEVEL_PLAYING and destroys the player mid-frame
+		if (m_currentGameState != GameState::LEVEL_PLAYING || m_player == nullptr)
+		{
+			m_simulationAccumulator = 0.f;
+			return;
+		}
+	}
+
+	// On a long hitch drop the time we could not simulate rather than spiralling further behind
+	if (m_simulationAccumulator >= m_simulationTimestep)
+	{
+		m_simulationAccumulator = 0.f;
+	}
+
+	m_player->UpdateRenderPosition(m_simulationAccumulator / m_simulationTimestep);
+	if (m_isEndlessMode)
+	{
+		m_endlessLevel->CastPlayerRays(m_player);
+	}
+	else
+	{
+		m_currentLevel->CastPlayerRays(m_player);
+	}
+}
+
+void Game::ResetSimulation()
+{
+	m_simulationAccumulator = 0.f;
+	m_lastFrameSubsteps = 0;
+}
+
+void Game::BeginLevelAttempt()
+{
+	ResetSimulation();
+	m_trajectoryHash = TRAJECTORY_HASH_SEED;
+	m_isReplayingInput = false;
+	m_isReplayHashChecked = false;
+	m_isLevelAttemptActive = true;
+
+	std::string const& levelName = GetActiveLevelDefinition()->m_levelName;
+	std::string const& playerName = m_player->m_playerDef->m_playerName;
+	float simulationHz = 1.f / m_simulationTimestep;
+
+	if (m_inputRecordingMode == InputRecordingMode::RECORD)
+	{
+		m_inputRecording.Begin(levelName, playerName, simulationHz);
+	}
+	else if (m_inputRecordingMode == InputRecordingMode::REPLAY)
+	{
+		std::string recordingPath = GetInputRecordingPath();
+		if (!m_inputRecording.LoadFromFile(recordingPath.c_str()))
+		{
+			g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("No input recording at %s, playing live", recordingPath.c_str()));
+			return;
+		}
+		if (m_inputRecording.m_simulationHz != simulationHz)
+		{
+			g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("Input recording %s was made at %0.0f Hz, the game runs at %0.0f Hz, playing live",
+				recordingPath.c_str(), m_inputRecording.m_simulationHz, simulationHz));
+			return;
+		}
+		m_inputReplayCursor.Reset(&m_inputRecording);
+		m_isReplayingInput = true;
+	}
+}
+
+void Game::EndLevelAttempt()
+{
+	if (!m_isLevelAttemptActive)
+	{
+		return;
+	}
+	m_isLevelAttemptActive = false;
+
+	if (m_inputRecordingMode == InputRecordingMode::RECORD && !m_inputRecording.IsEmpty())
+	{
+		// Lets the headless runner check its replay against what the game simulated
+		m_inputRecording.m_trajectoryHash = m_trajectoryHash;
+		m_inputRecording.m_hasTrajectoryHash = true;
+		std::string recordingPath = GetInputRecordingPath();
+		if (!m_inputRecording.SaveToFile(recordingPath.c_str()))
+		{
+			ERROR_RECOVERABLE(Stringf("Failed to write input recording \"%s\"", recordingPath.c_str()));
+		}
+	}
+
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Level attempt finished, trajectory hash %016llx", static_cast<unsigned long long>(m_trajectoryHash)));
+	m_isReplayingInput = false;
+}
+
+void Game::CheckReplayTrajectoryHash()
+{
+	// Recordings made by the headless runner, scripted respawns included, must replay to the same hash here
+	m_isReplayHashChecked = true;
+	if (!m_inputRecording.m_hasTrajectoryHash)
+	{
+		return;
+	}
+	if (m_trajectoryHash == m_inputRecording.m_trajectoryHash)
+	{
+		g_theDevConsole->AddLine(Rgba8::LIMEGREEN, Stringf("Replay matches the recorded trajectory hash %016llx", static_cast<unsigned long long>(m_trajectoryHash)));
+	}
+	else
+	{
+		ERROR_RECOVERABLE(Stringf("Replay diverged from its recording, trajectory hash %016llx, recorded %016llx",
+			static_cast<unsigned long long>(m_trajectoryHash), static_cast<unsigned long long>(m_inputRecording.m_trajectoryHash)));
+	}
+}
+
+std::string Game::GetInputRecordingPath() const
+{
+	return Stringf("%s%s_%s.runinput", m_inputRecordingFolder.c_str(), GetActiveLevelDefinition()->m_levelName.c_str(), m_player->m_playerDef->m_playerName.c_str());
+}
+
+SimLevel const& Game::GetActiveSimLevel() const
+{
+	if (m_isEndlessMode)
+	{
+		return m_endlessLevel->GetSimLevelAt(m_player->m_simState.m_position.x);
+	}
+	return m_currentLevel->GetSimLevel();
+}
+
+LevelDefinition const* Game::GetActiveLevelDefinition() const
+{
+	if (m_isEndlessMode)
+	{
+		return (m_endlessLevel != nullptr) ? m_endlessLevel->GetDefinition() : nullptr;
+	}
+	return (m_currentLevel != nullptr) ? m_currentLevel->GetDefinition() : nullptr;
+}
+
+void Game::AdvanceToNextLevel()
+{
+	EndLevelAttempt();
+	m_currentLevelIndex++;
+
+	if (m_currentLevelIndex < m_levelCatalog->GetNumLevels())
+	{
+		LoadNextLevel();
+	}
+	else
+	{
+		EnterState(GameState::GAME_COMPLETE);
+	}
 }
 
 void Game::LoadNextLevel()
@@ -322,7 +591,7 @@ void Game::LoadNextLevel()
 	}
 	else
 	{
-		if (m_currentLevelIndex < static_cast<int>(m_levels.size()))
+		if (m_currentLevelIndex < m_levelCatalog->GetNumLevels())
 		{
 			m_levelsUnlocked[m_currentLevelIndex] = true;
 		}
@@ -333,24 +602,54 @@ void Game::LoadNextLevel()
 		}
 	}
 
-	m_currentLevel = m_levels[m_currentLevelIndex];
+	// Prefetched while the previous level was played, so this is only a pointer swap
+	SetCurrentLevel(m_currentLevelIndex);
 
-	if (m_player)
+	if (m_player && m_currentGameState == GameState::LEVEL_PLAYING)
 	{
 		m_player->Respawn();
+		BeginLevelAttempt();
 	}
 }
 
+void Game::SetCurrentLevel(int levelIndex)
+{
+	m_currentLevelIndex = levelIndex;
+	m_currentLevel = m_levelCatalog->AcquireLevel(levelIndex);
+
+	// The one after it starts loading now, neither can be evicted while this level is played
+	m_levelCatalog->PrefetchLevel(levelIndex + 1);
+	m_levelCatalog->EnforceMemoryBudget(levelIndex, levelIndex + 1);
+}
+
+bool Game::Command_LevelMemory(EventArgs& args)
+{
+	UNUSED(args);
+	LevelCatalog const* levelCatalog = g_theGame->m_levelCatalog;
+	static char const* const stateNames[] = { "Unloaded", "Loading", "Ready", "Resident" };
+	for (int levelIndex = 0; levelIndex < levelCatalog->GetNumLevels(); ++levelIndex)
+	{
+		LevelMemoryUsage usage = levelCatalog->GetLevelMemoryUsage(levelIndex);
+		g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("%-12s %-9s collision %7.1f KB, CPU geometry %7.1f KB, GPU %7.1f KB",
+			levelCatalog->GetLevelDefinition(levelIndex)->m_levelName.c_str(), stateNames[static_cast<int>(levelCatalog->GetLevelState(levelIndex))],
+			static_cast<float>(usage.m_collisionBytes) / 1024.f, static_cast<float>(usage.m_cpuGeometryBytes) / 1024.f, static_cast<float>(usage.m_gpuBytes) / 1024.f));
+	}
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Total %0.1f KB of %0.1f KB budget",
+		static_cast<float>(levelCatalog->GetTotalMemoryBytes()) / 1024.f, static_cast<float>(levelCatalog->GetMemoryBudgetBytes()) / 1024.f));
+	return true;
+}
+
 void Game::ToggleUnlockMode()
 {
 	m_isUnlockMode = !m_isUnlockMode;
+	RefreshLevelButtons();
 }
 
 void Game::Render() const
 {
 	g_theRenderer->BeginCamera(m_screenCamera);
 	DrawBackgroundTexture();
-	g_theUISystem->Render();
+	m_menuUI->Render();
 	if (m_currentGameState == GameState::MAIN_MENU)
 	{
 		RenderMainMenu();
@@ -375,16 +674,47 @@ void Game::Render() const
 	{
 		RenderGameComplete();
 	}
+	g_theRenderQueue->Submit();
 	g_theRenderer->EndCamera(m_screenCamera);
 	if (m_currentGameState == GameState::LEVEL_PLAYING)
 	{
 		g_theRenderer->BeginCamera(m_gameWorldCamera);
-		m_currentLevel->Render();
+		if (m_isEndlessMode)
+		{
+			m_endlessLevel->Render();
+		}
+		else
+		{
+			m_currentLevel->Render();
+		}
 		m_player->Render();
+		g_theRenderQueue->Submit();
 		g_theRenderer->EndCamera(m_gameWorldCamera);
 		DebugRenderWorld(m_gameWorldCamera);
 		DebugRenderScreen(m_screenCamera);
+		RenderDebugText();
+	}
+}
+
+void Game::RenderDebugText() const
+{
+	if (!m_isDebugTextOn)
+	{
+		return;
+	}
+
+	g_theRenderer->BeginCamera(m_screenCamera);
+	for (int lineIndex = 0; lineIndex < NUM_DEBUG_TEXT_LINES; ++lineIndex)
+	{
+		TextLine debugLine;
+		debugLine.m_text = m_debugTextLines[lineIndex];
+		debugLine.m_box = AABB2(0.f, 0.f, SCREEN_SIZE_X, SCREEN_SIZE_Y);
+		debugLine.m_cellHeight = 15.f;
+		debugLine.m_alignment = Vec2(0.98f, 0.97f - (0.03f * static_cast<float>(lineIndex)));
+		m_textMeshCache->DrawDynamicText(lineIndex, debugLine);
 	}
+	g_theRenderQueue->Submit();
+	g_theRenderer->EndCamera(m_screenCamera);
 }
 
 void Game::Shutdown()
@@ -393,10 +723,23 @@ void Game::Shutdown()
 	m_gameClock = nullptr;
 
 	DestroyPlayer();
+	DestroyEndlessLevel();
 	DestroyLevel();
 
 	PlayerDefinition::ClearPlayerDefinitions();
 	LevelDefinition::ClearLevelDefinitions();
+
+	delete m_assetLoader;
+	m_assetLoader = nullptr;
+
+	delete m_playerMeshCache;
+	m_playerMeshCache = nullptr;
+
+	delete m_menuUI;
+	m_menuUI = nullptr;
+
+	delete m_textMeshCache;
+	m_textMeshCache = nullptr;
 }
 
 void Game::DestroyPlayer()
@@ -407,24 +750,25 @@ void Game::DestroyPlayer()
 
 void Game::DestroyLevel()
 {
-	for (int levelIndex = 0; levelIndex < static_cast<int>(m_levels.size()); ++levelIndex)
-	{
-		delete m_levels[levelIndex];
-		m_levels[levelIndex] = nullptr;
-	}
+	m_currentLevel = nullptr;
+	delete m_levelCatalog;
+	m_levelCatalog = nullptr;
+}
+
+void Game::DestroyEndlessLevel()
+{
+	delete m_endlessLevel;
+	m_endlessLevel = nullptr;
 }
 
 void Game::DrawBackgroundTexture() const
 {
-	std::vector<Vertex_PCU> bgVerts;
+	std::vector<Vertex_PCU>& bgVerts = g_theFrameScratch->AcquirePCU();
 	AddVertsForAABB2D(bgVerts, AABB2(Vec2::ZERO, Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y)), Rgba8::WHITE);
-	g_theRenderer->SetModelConstants();
-	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_NONE);
-	g_theRenderer->SetDepthMode(DepthMode::DISABLED);
-	g_theRenderer->BindTexture(m_backgroundTexture);
-	g_theRenderer->BindShader(nullptr);
-	g_theRenderer->DrawVertexArray(bgVerts);
+	RenderCommand command;
+	command.m_layer = RenderLayer::BACKGROUND;
+	command.m_state.m_texture = m_backgroundTexture;
+	g_theRenderQueue->AddVertexArray(command, bgVerts);
 }
 
 void Game::KeyInputPresses()
@@ -456,7 +800,7 @@ void Game::KeyInputPresses()
 		}
 		if (g_theInput->WasKeyJustPressed('R'))
 		{
-			m_player->Respawn();
+			m_player->RequestRespawn();
 		}
 		if (g_theInput->WasKeyJustPressed(KEYCODE_F2))
 		{
@@ -508,16 +852,11 @@ void Game::HandleCameraInput()
 	}
 }
 
-void Game::UpdateUIPresses(float deltaSeconds)
+void Game::UpdateUIPresses()
 {
 	Vec2 clientPos = g_theInput->GetCursorClientPosition();
 	Vec2 worldPos = m_screenCamera.GetClientToWorld(clientPos, g_theWindow->GetClientDimensions());
-	g_theUISystem->Update(deltaSeconds, worldPos);
-
-	if (g_theInput->WasKeyJustPressed(KEYCODE_LEFT_MOUSE))
-	{
-		g_theUISystem->HandleMouseClick(worldPos);
-	}
+	HandleMenuClick(m_menuUI->Update(worldPos, g_theInput->WasKeyJustPressed(KEYCODE_LEFT_MOUSE)));
 }
 
 GameState Game::GetCurrentGameState() const
@@ -530,37 +869,43 @@ void Game::EnterState(GameState state)
 	ExitState(m_currentGameState);
 	m_currentGameState = state;
 
+	// States without a menu screen show nothing
+	m_menuUI->SetActiveScreen(static_cast<int>(state));
+
 	switch (state)
 	{
 		case GameState::MAIN_MENU:
 		{
-			SetupUIMainMenu();
 			break;
 		}
 		case GameState::CONTROLS:
 		{
-			SetupUIControls();
 			break;
 		}
 		case GameState::CREDITS:
 		{
-			SetupCredits();
 			break;
 		}
 		case GameState::CHARACTER_SELECT:
 		{
-			SetupUICharacterSelect();
 			break;
 		}
 		case GameState::LEVEL_SELECT:
 		{
-			SetupUILevelSelect();
+			RefreshLevelButtons();
 			break;
 		}
 		case GameState::LEVEL_PLAYING:
 		{
 			m_gameMusicPlayback = g_theAudio->StartSound(m_gameMusic, true, m_musicVolume);
+			if (m_isEndlessMode)
+			{
+				unsigned int seed = (m_endlessSeed != 0) ? m_endlessSeed : static_cast<unsigned int>(g_rng->RollRandomIntInRange(1, 0x7FFFFFFF));
+				m_endlessLevel = new EndlessLevel(this, seed, m_player->m_simParams.m_moveSpeed);
+				g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Endless run, seed %u", seed));
+			}
 			m_player->Respawn();
+			BeginLevelAttempt();
 			break;
 		}
 		case GameState::GAME_COMPLETE:
@@ -572,9 +917,6 @@ void Game::EnterState(GameState state)
 
 void Game::ExitState(GameState state)
 {
-	// Clear UI for every state
-	g_theUISystem->Clear();
-
 	switch (state)
 	{
 		case GameState::MAIN_MENU:
@@ -600,7 +942,9 @@ void Game::ExitState(GameState state)
 		case GameState::LEVEL_PLAYING:
 		{
 			g_theAudio->StopSound(m_gameMusicPlayback);
+			EndLevelAttempt();
 			DestroyPlayer();
+			DestroyEndlessLevel();
 			break;
 		}
 		case GameState::GAME_COMPLETE:
@@ -626,22 +970,43 @@ void Game::UpdateCameras(float deltaSeconds)
 		m_cameraOrientation.m_pitchDegrees = GetClamped(m_cameraOrientation.m_pitchDegrees, -85.f, 85.f);
 		m_cameraOrientation.m_rollDegrees = GetClamped(m_cameraOrientation.m_rollDegrees, -45.f, 45.f);
 		m_gameWorldCamera.SetPositionAndOrientation(m_cameraPosition, m_cameraOrientation);
-		m_gameWorldCamera.SetPerspectiveView(2.f, 60.f, 0.1f, 1000.f);
+		m_gameWorldCamera.SetPerspectiveView(WORLD_CAMERA_ASPECT, WORLD_CAMERA_FOV_DEGREES, WORLD_CAMERA_NEAR, WORLD_CAMERA_FAR);
 	}
 
 	if (m_currentCameraState == CameraState::PLAYER_FOLLOW)
 	{
 		if (m_player != nullptr)
 		{
-			Vec3& playerPos = m_player->m_position;
+			Vec3& playerPos = m_player->m_renderPosition;
 			m_cameraPosition = playerPos - Vec3(10.f, 0.f, -0.75f);
 			m_cameraOrientation = m_player->m_orientation;
 			m_gameWorldCamera.SetPositionAndOrientation(m_cameraPosition, m_cameraOrientation);
-			m_gameWorldCamera.SetPerspectiveView(2.f, 60.f, 0.1f, 1000.f);
+			m_gameWorldCamera.SetPerspectiveView(WORLD_CAMERA_ASPECT, WORLD_CAMERA_FOV_DEGREES, WORLD_CAMERA_NEAR, WORLD_CAMERA_FAR);
 		}
 	}
 }
 
+void Game::CullLevelBlocks()
+{
+	m_levelCullStats = LevelCullStats();
+	if (m_currentGameState != GameState::LEVEL_PLAYING)
+	{
+		return;
+	}
+
+	// Same view the world camera was just given, with the far plane pulled in to the cull distance
+	float cullDistance = (m_levelCullDistance < WORLD_CAMERA_FAR) ? m_levelCullDistance : WORLD_CAMERA_FAR;
+	ViewFrustum frustum(m_cameraPosition, m_cameraOrientation, WORLD_CAMERA_ASPECT, WORLD_CAMERA_FOV_DEGREES, WORLD_CAMERA_NEAR, cullDistance);
+	if (m_isEndlessMode)
+	{
+		m_endlessLevel->CullBlocks(frustum, m_levelCullStats);
+	}
+	else if (m_currentLevel != nullptr)
+	{
+		m_currentLevel->CullBlocks(frustum, m_levelCullStats);
+	}
+}
+
 void Game::FreeFlyControls(float deltaSeconds)
 {
 	// Yaw and Pitch with mouse
@@ -688,75 +1053,60 @@ void Game::FreeFlyControls(float deltaSeconds)
 
 void Game::RenderMainMenu() const
 {
-	std::vector<Vertex_PCU> textVerts;
-	m_font->AddVertsForTextInBox2D(textVerts, "Runner", AABB2(Vec2::ZERO, Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y)), 70.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.7f));
-	g_theRenderer->SetModelConstants();
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_NONE);
-	g_theRenderer->BindTexture(&m_font->GetTexture());
-	g_theRenderer->DrawVertexArray(textVerts);
+	TextLine titleLine = { "Runner", AABB2(Vec2::ZERO, Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y)), 70.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.7f) };
+	m_textMeshCache->DrawStaticText(&titleLine, 1);
 }
 
 void Game::RenderLevelSelect() const
 {
-	std::vector<Vertex_PCU> textVerts;
-	m_font->AddVertsForTextInBox2D(textVerts, "Level Select", AABB2(Vec2::ZERO, Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y)), 70.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.7f));
-	g_theRenderer->SetModelConstants();
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_NONE);
-	g_theRenderer->BindTexture(&m_font->GetTexture());
-	g_theRenderer->DrawVertexArray(textVerts);
+	TextLine titleLine = { "Level Select", AABB2(Vec2::ZERO, Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y)), 70.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.7f) };
+	m_textMeshCache->DrawStaticText(&titleLine, 1);
 }
 
 void Game::RenderCharacterSelect() const
 {
-	std::vector<Vertex_PCU> textVerts;
-	m_font->AddVertsForTextInBox2D(textVerts, "Character Select", AABB2(Vec2::ZERO, Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y)), 70.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.7f));
-	g_theRenderer->SetModelConstants();
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_NONE);
-	g_theRenderer->BindTexture(&m_font->GetTexture());
-	g_theRenderer->DrawVertexArray(textVerts);
+	TextLine titleLine = { "Character Select", AABB2(Vec2::ZERO, Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y)), 70.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.7f) };
+	m_textMeshCache->DrawStaticText(&titleLine, 1);
 }
 
 void Game::RenderControls() const
 {
 	AABB2 screenBox = AABB2(Vec2::ZERO, Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y));
 
-	std::vector<Vertex_PCU> textVerts;
-	m_font->AddVertsForTextInBox2D(textVerts, "Move Left:   [A]", screenBox, 25.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.7f));
-	m_font->AddVertsForTextInBox2D(textVerts, "Jump:    [SPACE]", screenBox, 25.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.6f));
-	m_font->AddVertsForTextInBox2D(textVerts, "Move Right:  [D]", screenBox, 25.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.5f));
-	m_font->AddVertsForTextInBox2D(textVerts, "Pause:       [P]", screenBox, 25.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.4f));
-	m_font->AddVertsForTextInBox2D(textVerts, "Reset:       [R]", screenBox, 25.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.3f));
-	g_theRenderer->SetModelConstants();
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_NONE);
-	g_theRenderer->BindTexture(&m_font->GetTexture());
-	g_theRenderer->DrawVertexArray(textVerts);
+	TextLine controlLines[] =
+	{
+		{ "Move Left:   [A]", screenBox, 25.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.7f) },
+		{ "Jump:    [SPACE]", screenBox, 25.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.6f) },
+		{ "Move Right:  [D]", screenBox, 25.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.5f) },
+		{ "Pause:       [P]", screenBox, 25.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.4f) },
+		{ "Reset:       [R]", screenBox, 25.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.3f) },
+	};
+	m_textMeshCache->DrawStaticText(controlLines, 5);
 }
 
 void Game::RenderCredits() const
 {
 	AABB2 screenBox = AABB2(Vec2::ZERO, Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y));
 
-	std::vector<Vertex_PCU> textVerts;
-	m_font->AddVertsForTextInBox2D(textVerts, "Runner created by: Jacob Wilkin", screenBox, 25.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.7f));
-	m_font->AddVertsForTextInBox2D(textVerts, "Inspired by Joseph Cloutier's Run series on CoolmathGames", screenBox, 25.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.6f));
-	m_font->AddVertsForTextInBox2D(textVerts, "Audio using FMOD, Run 2 main theme from archive.org", screenBox, 25.f, Rgba8::LIMEGREEN);
-	m_font->AddVertsForTextInBox2D(textVerts, "Sprites from BrowserGames.com", screenBox, 25.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.4f));
-	g_theRenderer->SetModelConstants();
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_NONE);
-	g_theRenderer->BindTexture(&m_font->GetTexture());
-	g_theRenderer->DrawVertexArray(textVerts);
+	TextLine creditLines[] =
+	{
+		{ "Runner created by: Jacob Wilkin", screenBox, 25.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.7f) },
+		{ "Inspired by Joseph Cloutier's Run series on CoolmathGames", screenBox, 25.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.6f) },
+		{ "Audio using FMOD, Run 2 main theme from archive.org", screenBox, 25.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.5f) },
+		{ "Sprites from BrowserGames.com", screenBox, 25.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.4f) },
+	};
+	m_textMeshCache->DrawStaticText(creditLines, 4);
 }
 
 void Game::RenderGameComplete() const
 {
 	AABB2 screenBox = AABB2(Vec2::ZERO, Vec2(SCREEN_SIZE_X, SCREEN_SIZE_Y));
 
-	std::vector<Vertex_PCU> textVerts;
-	m_font->AddVertsForTextInBox2D(textVerts, "CONGRATULATIONS!", screenBox, 50.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.7f));
-	m_font->AddVertsForTextInBox2D(textVerts, "Press ESC to return to the Main Menu", screenBox, 25.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.5f));
-	m_font->AddVertsForTextInBox2D(textVerts, "Thanks for playing my game!", screenBox, 25.f, Rgba8::LIMEGREEN, 1.f, Vec2(0.5f, 0.3f));
-	g_theRenderer->SetModelConstants();
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_NONE);
-	g_theRenderer->BindTexture(&m_font->GetTexture());
-	g_theRenderer->DrawVertexArray(textVerts);
+	TextLine completeLines[] =
+	{
+		{ "CONGRATULATIONS!", screenBox, 50.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.7f) },
+		{ "Press ESC to return to the Main Menu", screenBox, 25.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.5f) },
+		{ "Thanks for playing my game!", screenBox, 25.f, Rgba8::LIMEGREEN, Vec2(0.5f, 0.3f) },
+	};
+	m_textMeshCache->DrawStaticText(completeLines, 3);
 }
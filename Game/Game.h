@@ -1,5 +1,7 @@
 #pragma once
 #include "Game/GameCommon.h"
+#include "Game/InputRecording.hpp"
+#include "Game/LevelBlockMesh.hpp"
 #include "Engine/Renderer/Camera.h"
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/OBB3.hpp"
@@ -7,12 +9,25 @@
 #include "Engine/Core/Vertex_PCU.h"
 #include "Engine/Core/Vertex_PCUTBN.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include <cstdint>
 #include <string>
 // -----------------------------------------------------------------------------
 class Player;
 class Level;
+class EndlessLevel;
+class LevelCatalog;
+class AsyncAssetLoader;
+class PlayerMeshCache;
+class SimLevel;
+struct LevelDefinition;
 class Texture;
 class BitmapFont;
+class TextMeshCache;
+class MenuUI;
+struct MenuClick;
+// -----------------------------------------------------------------------------
+constexpr int NUM_DEBUG_TEXT_LINES = 10;
 // -----------------------------------------------------------------------------
 class Game
 {
@@ -25,18 +40,34 @@ public:
 	void InitializeSkater();
 	void InitializeLevels();
 
+	void BuildMenuScreens();
 	void SetupUIMainMenu();
 	void SetupUILevelSelect();
 	void SetupUIControls();
 	void SetupUICharacterSelect();
 	void SetupCredits();
-	void CreateLevelButton(std::string const& buttonName, int levelIndex, AABB2 buttonBounds);
+	void CreateLevelButton(int levelIndex, AABB2 buttonBounds);
+	void CreateEndlessButton(AABB2 buttonBounds);
+	void RefreshLevelButtons();
+	void HandleMenuClick(MenuClick const& click);
 	void ToggleDebugText();
 
 	void Update();
+	void UpdateSimulation(float deltaSeconds);
+	void ResetSimulation();
+	void BeginLevelAttempt();
+	void EndLevelAttempt();
+	void CheckReplayTrajectoryHash();
+	std::string GetInputRecordingPath() const;
+	SimLevel const& GetActiveSimLevel() const;
+	LevelDefinition const* GetActiveLevelDefinition() const;
+	void AdvanceToNextLevel();
 	void LoadNextLevel();
+	void SetCurrentLevel(int levelIndex);
+	static bool Command_LevelMemory(EventArgs& args);
 	void ToggleUnlockMode();
 	void UpdateCameras(float deltaSeconds);
+	void CullLevelBlocks();
 	void FreeFlyControls(float deltaSeconds);
 
 	void Render() const;
@@ -46,16 +77,18 @@ public:
 	void RenderControls() const;
 	void RenderCredits() const;
 	void RenderGameComplete() const;
+	void RenderDebugText() const;
 	void DrawBackgroundTexture() const;
 
 	void Shutdown();
 	void DestroyPlayer();
 	void DestroyLevel();
+	void DestroyEndlessLevel();
 
 	void KeyInputPresses();
 	void AdjustForPauseAndTimeDistortion(float deltaSeconds);
 	void HandleCameraInput();
-	void UpdateUIPresses(float deltaSeconds);
+	void UpdateUIPresses();
 
 	GameState GetCurrentGameState() const;
 	void EnterState(GameState state);
@@ -64,14 +97,18 @@ public:
 public:
 	Clock* m_gameClock = nullptr;
 	Camera m_gameWorldCamera;
+	PlayerMeshCache* m_playerMeshCache = nullptr;
 	Player* m_player = nullptr;
 	Level*  m_currentLevel = nullptr;
 	int m_currentLevelIndex = 0;
-	std::vector<Level*> m_levels;
+	LevelCatalog* m_levelCatalog = nullptr;
+	EndlessLevel* m_endlessLevel = nullptr;
+	bool m_isEndlessMode = false;
 
 private:
 	GameState   m_currentGameState = GameState::MAIN_MENU;
 	Texture*    m_backgroundTexture = nullptr;
+	AsyncAssetLoader* m_assetLoader = nullptr;
 
 	// Level Locking
 	bool m_isUnlockMode = false;
@@ -83,10 +120,44 @@ private:
 	Vec3 m_cameraPosition = Vec3::ZERO;
 	EulerAngles m_cameraOrientation = EulerAngles::ZERO;
 
+	// Level culling, chunks past the cull distance are skipped even inside the camera's far plane
+	float m_levelCullDistance = 250.f;
+	LevelCullStats m_levelCullStats;
+
+	// Level residency, least recently played levels are evicted past this
+	float m_levelMemoryBudgetMB = 64.f;
+
 	// UI
 	AABB2 m_controlsButtonBounds = AABB2(200.f, 100.f, 400.f, 160.f);
 	BitmapFont* m_font = nullptr;
+	TextMeshCache* m_textMeshCache = nullptr;
+	MenuUI* m_menuUI = nullptr;
+	std::vector<int> m_levelButtons;		// Menu button per level, greyed out while locked
 	bool m_isDebugTextOn = false;
+	char m_debugTextLines[NUM_DEBUG_TEXT_LINES][DEBUG_TEXT_LINE_LENGTH] = {};	// Formatted in Update, drawn through dynamic text slots
+
+	// Simulation
+	float m_simulationTimestep = 1.f / 120.f;
+	int   m_maxSimulationSubsteps = 8;
+	float m_simulationAccumulator = 0.f;
+	int   m_lastFrameSubsteps = 0;
+
+	// Heap allocations between the last two Updates, counted in dev builds only
+	uint64_t m_heapAllocationsAtLastUpdate = 0;
+	int		 m_lastFrameHeapAllocations = 0;
+
+	// Input recording and replay
+	InputRecordingMode m_inputRecordingMode = InputRecordingMode::OFF;
+	std::string		   m_inputRecordingFolder;
+	InputRecording	   m_inputRecording;
+	InputReplayCursor  m_inputReplayCursor;
+	bool			   m_isReplayingInput = false;
+	bool			   m_isReplayHashChecked = false;
+	bool			   m_isLevelAttemptActive = false;
+	uint64_t		   m_trajectoryHash = TRAJECTORY_HASH_SEED;
+
+	// Endless mode, 0 picks a new seed every run
+	unsigned int m_endlessSeed = 0;
 
 	// Music
 	std::string m_gameMusicPath;
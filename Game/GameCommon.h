@@ -8,6 +8,9 @@ class InputSystem;
 class AudioSystem;
 class UISystem;
 class Window;
+class ShaderLibrary;
+class FrameScratch;
+class RenderQueue;
 struct Vec2;
 struct Rgba8;
 // -----------------------------------------------------------------------------
@@ -16,9 +19,16 @@ constexpr float SCREEN_SIZE_Y = 800.f;
 constexpr float SCREEN_CENTER_X = SCREEN_SIZE_X / 2.f;
 constexpr float SCREEN_CENTER_Y = SCREEN_SIZE_Y / 2.f;
 // -----------------------------------------------------------------------------
+constexpr float WORLD_CAMERA_ASPECT = 2.f;
+constexpr float WORLD_CAMERA_FOV_DEGREES = 60.f;
+constexpr float WORLD_CAMERA_NEAR = 0.1f;
+constexpr float WORLD_CAMERA_FAR = 1000.f;
+// -----------------------------------------------------------------------------
 constexpr float GRAVITY_FORCE = -24.0f;
 constexpr float MAX_FALL_SPEED = -30.f;
 // -----------------------------------------------------------------------------
+constexpr int DEBUG_TEXT_LINE_LENGTH = 128;		// Also the longest line a dynamic text slot caches
+// -----------------------------------------------------------------------------
 enum class GameState
 {
 	NONE,
@@ -38,6 +48,13 @@ enum class CameraState
 	PLAYER_FOLLOW
 };
 // -----------------------------------------------------------------------------
+enum class InputRecordingMode
+{
+	OFF,
+	RECORD,
+	REPLAY
+};
+// -----------------------------------------------------------------------------
 extern App* g_theApp;
 extern Game* g_theGame;
 extern Renderer* g_theRenderer;
@@ -46,6 +63,9 @@ extern InputSystem* g_theInput;
 extern AudioSystem* g_theAudio;
 extern UISystem* g_theUISystem;
 extern Window* g_theWindow;
+extern ShaderLibrary* g_theShaderLibrary;
+extern FrameScratch* g_theFrameScratch;
+extern RenderQueue* g_theRenderQueue;
 // -----------------------------------------------------------------------------
 void DebugDrawRing(Vec2 const& center, float radius, float thickness, Rgba8 const& color);
 void DebugDrawLine(Vec2 const& start, Vec2 const& end, float thickness, Rgba8 const& color);
@@ -0,0 +1,65 @@
+# Headless gameplay simulation for Linux build and analysis machines.
+# Only the simulation core is compiled; no renderer, window, input or audio.
+#
+#   make -f Game/Headless.mk                 (from the repository root)
+#   cd Run && ./RunnerHeadless --level LevelOne --ticks 1000000
+#   cd Run && ./RunnerHeadless --replay Data/Recordings/LevelOne_Runner.runinput
+#   cd Run && ./RunnerHeadless --runners 4096 --ticks 20000 --jump-spread 30
+#   cd Run && ./RunnerHeadless --cook Data/Definitions/LevelDefinitions.cooked
+#   cd Run && ./RunnerHeadless --check-shader-cache ../Temporary/ShaderCache/
+#
+# ENGINE_DIR defaults to the same Engine checkout Game.vcxproj references.
+
+ENGINE_DIR ?= ../Engine/Code
+BUILD_DIR  ?= Temporary/Headless
+TARGET     ?= Run/RunnerHeadless
+
+CXX      ?= g++
+# Contraction into FMA would change float results between builds and break replay hashes
+CXXFLAGS ?= -O2 -std=c++17 -Wall -ffp-contract=off
+CPPFLAGS += -I. -I$(ENGINE_DIR) -DENGINE_DISABLE_AUDIO
+
+GAME_SOURCES := \
+	Game/CookedLevel.cpp \
+	Game/InputRecording.cpp \
+	Game/LevelBVH.cpp \
+	Game/LevelBlocks.cpp \
+	Game/LevelDefinition.cpp \
+	Game/MappedFile.cpp \
+	Game/ShaderCache.cpp \
+	Game/SimBatch.cpp \
+	Game/SimLevel.cpp \
+	Game/SimRunner.cpp \
+	Game/WorkStealingPool.cpp \
+	Game/Main_Headless.cpp
+
+ENGINE_SOURCES := \
+	$(wildcard $(ENGINE_DIR)/Engine/Math/*.cpp) \
+	$(ENGINE_DIR)/Engine/Core/ErrorWarningAssert.cpp \
+	$(ENGINE_DIR)/Engine/Core/StringUtils.cpp \
+	$(ENGINE_DIR)/Engine/Core/Rgba8.cpp \
+	$(ENGINE_DIR)/Engine/Core/XmlUtils.cpp \
+	$(ENGINE_DIR)/ThirdParty/TinyXML2/tinyxml2.cpp
+
+GAME_OBJECTS   := $(patsubst Game/%.cpp,$(BUILD_DIR)/Game/%.o,$(GAME_SOURCES))
+ENGINE_OBJECTS := $(patsubst $(ENGINE_DIR)/%.cpp,$(BUILD_DIR)/Engine/%.o,$(ENGINE_SOURCES))
+
+.PHONY: all clean
+
+all: $(TARGET)
+
+$(TARGET): $(GAME_OBJECTS) $(ENGINE_OBJECTS)
+	$(CXX) $(CXXFLAGS) -o $@ $^ -lpthread
+
+$(BUILD_DIR)/Game/%.o: Game/%.cpp
+	@mkdir -p $(dir $@)
+	$(CXX) $(CPPFLAGS) $(CXXFLAGS) -MMD -MP -c $< -o $@
+
+$(BUILD_DIR)/Engine/%.o: $(ENGINE_DIR)/%.cpp
+	@mkdir -p $(dir $@)
+	$(CXX) $(CPPFLAGS) $(CXXFLAGS) -MMD -MP -c $< -o $@
+
+clean:
+	rm -rf $(BUILD_DIR) $(TARGET)
+
+-include $(GAME_OBJECTS:.o=.d) $(ENGINE_OBJECTS:.o=.d)
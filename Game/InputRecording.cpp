@@ -0,0 +1,279 @@
+#include "Game/InputRecording.hpp"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+// -----------------------------------------------------------------------------
+static char const INPUT_RECORDING_FOURCC[4] = { 'R', 'N', 'I', 'R' };
+// -----------------------------------------------------------------------------
+static void WriteU32(std::vector<unsigned char>& buffer, uint32_t value)
+{
+	for (int byteIndex = 0; byteIndex < 4; ++byteIndex)
+	{
+		buffer.push_back(static_cast<unsigned char>((value >> (byteIndex * 8)) & 0xFF));
+	}
+}
+
+static void WriteVarU32(std::vector<unsigned char>& buffer, uint32_t value)
+{
+	// 7 bits per byte, high bit set while more bytes follow
+	while (value >= 0x80)
+	{
+		buffer.push_back(static_cast<unsigned char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	buffer.push_back(static_cast<unsigned char>(value));
+}
+
+static void WriteString(std::vector<unsigned char>& buffer, std::string const& text)
+{
+	WriteVarU32(buffer, static_cast<uint32_t>(text.size()));
+	buffer.insert(buffer.end(), text.begin(), text.end());
+}
+
+static bool ReadU32(std::vector<unsigned char> const& buffer, size_t& readPos, uint32_t& out_value)
+{
+	if (readPos + 4 > buffer.size())
+	{
+		return false;
+	}
+	out_value = 0;
+	for (int byteIndex = 0; byteIndex < 4; ++byteIndex)
+	{
+		out_value |= static_cast<uint32_t>(buffer[readPos++]) << (byteIndex * 8);
+	}
+	return true;
+}
+
+static bool ReadVarU32(std::vector<unsigned char> const& buffer, size_t& readPos, uint32_t& out_value)
+{
+	out_value = 0;
+	for (int shift = 0; shift < 35; shift += 7)
+	{
+		if (readPos >= buffer.size())
+		{
+			return false;
+		}
+		unsigned char byte = buffer[readPos++];
+		out_value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool ReadString(std::vector<unsigned char> const& buffer, size_t& readPos, std::string& out_text)
+{
+	uint32_t length = 0;
+	if (!ReadVarU32(buffer, readPos, length) || readPos + length > buffer.size())
+	{
+		return false;
+	}
+	out_text.assign(reinterpret_cast<char const*>(buffer.data() + readPos), length);
+	readPos += length;
+	return true;
+}
+// -----------------------------------------------------------------------------
+void InputRecording::Begin(std::string const& levelName, std::string const& playerName, float simulationHz)
+{
+	Clear();
+	m_levelName = levelName;
+	m_playerName = playerName;
+	m_simulationHz = simulationHz;
+}
+
+void InputRecording::Clear()
+{
+	m_levelName.clear();
+	m_playerName.clear();
+	m_simulationHz = 0.f;
+	m_runs.clear();
+	m_trajectoryHash = 0;
+	m_hasTrajectoryHash = false;
+	m_numTicks = 0;
+}
+
+void InputRecording::AppendTick(SimInput input)
+{
+	if (!m_runs.empty() && m_runs.back().m_input == input)
+	{
+		m_runs.back().m_tickCount++;
+	}
+	else
+	{
+		InputRun inputRun;
+		inputRun.m_input = input;
+		inputRun.m_tickCount = 1;
+		m_runs.push_back(inputRun);
+	}
+	m_numTicks++;
+}
+
+bool InputRecording::SaveToFile(char const* filePath) const
+{
+	// Layout: fourcc, version, tick rate bits, level, player, run count, then (input byte, varint ticks) per run,
+	// then a flag byte and the trajectory hash as two u32s
+	std::vector<unsigned char> buffer;
+	buffer.insert(buffer.end(), INPUT_RECORDING_FOURCC, INPUT_RECORDING_FOURCC + 4);
+	WriteU32(buffer, INPUT_RECORDING_VERSION);
+	uint32_t simulationHzBits = 0;
+	memcpy(&simulationHzBits, &m_simulationHz, sizeof(simulationHzBits));
+	WriteU32(buffer, simulationHzBits);
+	WriteString(buffer, m_levelName);
+	WriteString(buffer, m_playerName);
+	WriteVarU32(buffer, static_cast<uint32_t>(m_runs.size()));
+	for (int runIndex = 0; runIndex < static_cast<int>(m_runs.size()); ++runIndex)
+	{
+		buffer.push_back(m_runs[runIndex].m_input);
+		WriteVarU32(buffer, m_runs[runIndex].m_tickCount);
+	}
+	buffer.push_back(m_hasTrajectoryHash ? 1 : 0);
+	WriteU32(buffer, static_cast<uint32_t>(m_trajectoryHash));
+	WriteU32(buffer, static_cast<uint32_t>(m_trajectoryHash >> 32));
+
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		return false;
+	}
+	file.write(reinterpret_cast<char const*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+	return file.good();
+}
+
+bool InputRecording::LoadFromFile(char const* filePath)
+{
+	Clear();
+
+	std::ifstream file(filePath, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	size_t readPos = 0;
+	uint32_t version = 0;
+	uint32_t simulationHzBits = 0;
+	uint32_t numRuns = 0;
+	if (buffer.size() < 4 || memcmp(buffer.data(), INPUT_RECORDING_FOURCC, 4) != 0)
+	{
+		return false;
+	}
+	readPos = 4;
+	if (!ReadU32(buffer, readPos, version) || version < 1 || version > INPUT_RECORDING_VERSION ||
+		!ReadU32(buffer, readPos, simulationHzBits) ||
+		!ReadString(buffer, readPos, m_levelName) ||
+		!ReadString(buffer, readPos, m_playerName) ||
+		!ReadVarU32(buffer, readPos, numRuns))
+	{
+		Clear();
+		return false;
+	}
+	memcpy(&m_simulationHz, &simulationHzBits, sizeof(m_simulationHz));
+
+	// Every run takes at least two bytes, a larger count is a corrupt file and must not size the reserve
+	if (numRuns > (buffer.size() - readPos) / 2)
+	{
+		Clear();
+		return false;
+	}
+	m_runs.reserve(numRuns);
+	for (uint32_t runIndex = 0; runIndex < numRuns; ++runIndex)
+	{
+		InputRun inputRun;
+		if (readPos >= buffer.size())
+		{
+			Clear();
+			return false;
+		}
+		inputRun.m_input = buffer[readPos++];
+		if (!ReadVarU32(buffer, readPos, inputRun.m_tickCount))
+		{
+			Clear();
+			return false;
+		}
+		m_runs.push_back(inputRun);
+		m_numTicks += static_cast<int>(inputRun.m_tickCount);
+	}
+
+	if (version >= 2)
+	{
+		uint32_t hashLow = 0;
+		uint32_t hashHigh = 0;
+		if (readPos >= buffer.size())
+		{
+			Clear();
+			return false;
+		}
+		m_hasTrajectoryHash = buffer[readPos++] != 0;
+		if (!ReadU32(buffer, readPos, hashLow) || !ReadU32(buffer, readPos, hashHigh))
+		{
+			Clear();
+			return false;
+		}
+		m_trajectoryHash = (static_cast<uint64_t>(hashHigh) << 32) | hashLow;
+	}
+	return true;
+}
+
+int InputRecording::GetNumTicks() const
+{
+	return m_numTicks;
+}
+
+bool InputRecording::IsEmpty() const
+{
+	return m_numTicks == 0;
+}
+// -----------------------------------------------------------------------------
+void InputReplayCursor::Reset(InputRecording const* recording)
+{
+	m_recording = recording;
+	m_runIndex = 0;
+	m_tickInRun = 0;
+}
+
+SimInput InputReplayCursor::Next()
+{
+	if (IsFinished())
+	{
+		return SIM_INPUT_NONE;
+	}
+
+	InputRun const& inputRun = m_recording->m_runs[m_runIndex];
+	SimInput input = inputRun.m_input;
+	m_tickInRun++;
+	if (m_tickInRun >= inputRun.m_tickCount)
+	{
+		m_runIndex++;
+		m_tickInRun = 0;
+	}
+	return input;
+}
+
+bool InputReplayCursor::IsFinished() const
+{
+	return m_recording == nullptr || m_runIndex >= static_cast<int>(m_recording->m_runs.size());
+}
+// -----------------------------------------------------------------------------
+static uint64_t HashBytes(void const* data, size_t numBytes, uint64_t hash)
+{
+	unsigned char const* bytes = static_cast<unsigned char const*>(data);
+	for (size_t byteIndex = 0; byteIndex < numBytes; ++byteIndex)
+	{
+		hash ^= bytes[byteIndex];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+uint64_t HashRunnerState(SimRunnerState const& state, uint64_t hash)
+{
+	// Hash fields one at a time so struct padding never leaks into the result
+	float stateFloats[6] = { state.m_position.x, state.m_position.y, state.m_position.z, state.m_velocity.x, state.m_velocity.y, state.m_velocity.z };
+	unsigned char stateFlags = static_cast<unsigned char>((state.m_isGrounded ? 1 : 0) | (state.m_isTurning ? 2 : 0));
+	hash = HashBytes(stateFloats, sizeof(stateFloats), hash);
+	hash = HashBytes(&stateFlags, sizeof(stateFlags), hash);
+	return hash;
+}
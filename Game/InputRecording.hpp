@@ -0,0 +1,62 @@
+#pragma once
+#include "Game/SimRunner.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+// -----------------------------------------------------------------------------
+constexpr unsigned int INPUT_RECORDING_VERSION = 2;		// 2 added the trajectory hash, 1 still loads without it
+// -----------------------------------------------------------------------------
+struct InputRun
+{
+	SimInput	 m_input = SIM_INPUT_NONE;
+	unsigned int m_tickCount = 0;
+};
+// -----------------------------------------------------------------------------
+// Per-tick SimInput stream stored as runs of identical input. Held keys and idle
+// stretches collapse to a handful of bytes, so a full level attempt stays tiny.
+// -----------------------------------------------------------------------------
+class InputRecording
+{
+public:
+	void Begin(std::string const& levelName, std::string const& playerName, float simulationHz);
+	void Clear();
+	void AppendTick(SimInput input);
+
+	bool SaveToFile(char const* filePath) const;
+	bool LoadFromFile(char const* filePath);
+
+	int  GetNumTicks() const;
+	bool IsEmpty() const;
+
+public:
+	std::string m_levelName;
+	std::string m_playerName;
+	float		m_simulationHz = 0.f;
+	std::vector<InputRun> m_runs;
+	uint64_t	m_trajectoryHash = 0;			// After the last tick, whoever replays the runs must reach the same value
+	bool		m_hasTrajectoryHash = false;
+
+private:
+	int			m_numTicks = 0;
+};
+// -----------------------------------------------------------------------------
+// Walks a recording one tick at a time, past the end it returns no input
+// -----------------------------------------------------------------------------
+class InputReplayCursor
+{
+public:
+	void	 Reset(InputRecording const* recording);
+	SimInput Next();
+	bool	 IsFinished() const;
+
+private:
+	InputRecording const* m_recording = nullptr;
+	int			 m_runIndex = 0;
+	unsigned int m_tickInRun = 0;
+};
+// -----------------------------------------------------------------------------
+// Folds the exact bits of a runner's state into a running FNV-1a hash, two runs
+// that match bit for bit on every tick produce the same trajectory hash
+// -----------------------------------------------------------------------------
+constexpr uint64_t TRAJECTORY_HASH_SEED = 14695981039346656037ull;
+uint64_t HashRunnerState(SimRunnerState const& state, uint64_t hash);
@@ -1,7 +1,10 @@
 #include "Game/Level.hpp"
 #include "Game/LevelDefinition.hpp"
+#include "Game/CookedLevel.hpp"
 #include "Game/Player.hpp"
 #include "Game/Game.h"
+#include "Game/ShaderLibrary.hpp"
+#include "Game/RenderQueue.hpp"
 #include "Engine/Core/EngineCommon.h"
 #include "Engine/Renderer/Renderer.h"
 #include "Engine/Math/MathUtils.h"
@@ -11,10 +14,22 @@ Level::Level(Game* owner, LevelDefinition* levelDef)
 	:m_theGame(owner),
 	 m_levelDef(levelDef)
 {
-	m_phongShader = g_theRenderer->CreateOrGetShader("Data/Shaders/Phong", VertexType::VERTEX_PCUTBN);
+	// No renderer calls, so this may run on a worker thread, CreateBuffers follows on the main thread
 	LayoutLevelsFromDefinitions(m_levelDef);
+	BuildBlockBVH();
 	CreateLevelGeometry();
-	CreateBuffers();
+}
+
+Level::Level(Game* owner, LevelDefinition* levelDef, int blockCapacity)
+	:m_theGame(owner),
+	 m_levelDef(levelDef)
+{
+	// Starts empty, buffers are reserved once so refilling them never allocates GPU memory
+	CreateShader();
+	m_blockMesh.Initialize(blockCapacity);
+	m_blockMesh.CreateBuffers();
+	m_blockMesh.ReserveBuffers();
+	m_blockMeshSlots.reserve(blockCapacity);
 }
 
 Level::~Level()
@@ -25,29 +40,48 @@ Level::~Level()
 
 void Level::CreateLevelGeometry()
 {
-	// Blocks
-	for (int blockIndex = 0; blockIndex < static_cast<int>(m_blocks.size()); ++blockIndex)
+	// Blocks, one record each, in block order since the BVH has already sorted them
+	LevelBlocks const& blocks = m_simLevel.GetBlocks();
+	m_blockMesh.Initialize(blocks.GetNumBlocks());
+	if (m_levelDef->m_cookedLevel != nullptr)
+	{
+		// Cooked records go straight into slots 0..n-1
+		m_blockMesh.AddBlocks(m_levelDef->m_cookedLevel->m_instances, blocks.GetNumBlocks());
+		for (int blockIndex = 0; blockIndex < blocks.GetNumBlocks(); ++blockIndex)
+		{
+			m_blockMeshSlots.push_back(blockIndex);
+		}
+	}
+	else
 	{
-		Block const* block = m_blocks[blockIndex];
-		AddVertsForOBB3D(m_blockTBNVerts, m_blockIndices, block->m_bounds, block->m_blockColor);
+		for (int blockIndex = 0; blockIndex < blocks.GetNumBlocks(); ++blockIndex)
+		{
+			m_blockMeshSlots.push_back(m_blockMesh.AddBlock(blocks.GetBlockBounds(blockIndex), blocks.GetBlockColor(blockIndex)));
+		}
 	}
 
 	// End Goal
-	AddVertsForSphere3D(m_blockTBNVerts, m_blockIndices, m_endGoal->m_center, m_endGoal->m_radius, m_endGoal->m_endGoalColor);
+	if (m_simLevel.HasEndGoal())
+	{
+		EndGoal const& endGoal = m_simLevel.GetEndGoal();
+		AddVertsForSphere3D(m_endGoalTBNVerts, m_endGoalIndices, endGoal.m_center, endGoal.m_radius, endGoal.m_endGoalColor);
+		m_numEndGoalIndices = static_cast<int>(m_endGoalIndices.size());
+	}
 }
 
 void Level::CreateBuffers()
 {
-	// Create buffers and copy to GPU
-	m_blockVBO = g_theRenderer->CreateVertexBuffer(static_cast<unsigned int>(m_blockTBNVerts.size()) * sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
-	m_blockIBO = g_theRenderer->CreateIndexBuffer(static_cast<unsigned int>(m_blockIndices.size()) * sizeof(unsigned int), sizeof(unsigned int));
-	g_theRenderer->CopyCPUToGPU(m_blockTBNVerts.data(), m_blockVBO->GetSize(), m_blockVBO);
-	g_theRenderer->CopyCPUToGPU(m_blockIndices.data(), m_blockIBO->GetSize(), m_blockIBO);
+	// Create buffers and copy to GPU, an evicted level gets its render data back first
+	RestoreCPUGeometry();
+	CreateShader();
+	m_blockMesh.CreateBuffers();
+	UploadGeometry();
 }
 
-void Level::LayoutLevelsFromDefinitions(LevelDefinition* levelDef)
+void Level::SpawnFromInfos(std::vector<SpawnInfo> const& spawnInfos)
 {
-	for (SpawnInfo const& spawnInfo : levelDef->m_itemSpawnInfo)
+	ClearGeometry();
+	for (SpawnInfo const& spawnInfo : spawnInfos)
 	{
 		if (spawnInfo.m_levelItem == "Block")
 		{
@@ -58,45 +92,87 @@ void Level::LayoutLevelsFromDefinitions(LevelDefinition* levelDef)
 			SpawnEndGoal(spawnInfo.m_center, spawnInfo.m_radius, spawnInfo.m_color);
 		}
 	}
+	BuildBlockBVH();
+	CreateLevelGeometry();
 }
 
-void Level::SpawnBlock(Vec3 center, Vec3 dimensions, EulerAngles blockOrientation, Rgba8 color)
+void Level::UploadGeometry()
 {
-	// AABB3
-	//Vec3 halfDims = dimensions * 0.5f;
-	//EulerAngles orientation = EulerAngles::ZERO;
-	//AABB3 bounds(center - halfDims, center + halfDims);
-	//m_blocks.push_back(new Block{ bounds, color });
-
-	// OBB3
-	Vec3 halfDims = dimensions * 0.5f;
-
-	Mat44 rotationMat = blockOrientation.GetAsMatrix_IFwd_JLeft_KUp();
-	Vec3 iBasis = rotationMat.GetIBasis3D();
-	Vec3 jBasis = rotationMat.GetJBasis3D();
-	Vec3 kBasis = rotationMat.GetKBasis3D();
-
-	OBB3 bounds(center, iBasis, jBasis, kBasis, halfDims);
-	m_blocks.push_back(new Block{ bounds, color, blockOrientation });
+	m_blockMesh.UploadDirtyChunks();
+
+	// The end goal never changes after layout, it is copied once
+	if (m_endGoalVBO == nullptr && !m_endGoalIndices.empty())
+	{
+		m_endGoalVBO = g_theRenderer->CreateVertexBuffer(static_cast<unsigned int>(m_endGoalTBNVerts.size()) * sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
+		m_endGoalIBO = g_theRenderer->CreateIndexBuffer(static_cast<unsigned int>(m_endGoalIndices.size()) * sizeof(unsigned int), sizeof(unsigned int));
+		g_theRenderer->CopyCPUToGPU(m_endGoalTBNVerts.data(), m_endGoalVBO->GetSize(), m_endGoalVBO);
+		g_theRenderer->CopyCPUToGPU(m_endGoalIndices.data(), m_endGoalIBO->GetSize(), m_endGoalIBO);
+	}
 }
 
-void Level::SpawnEndGoal(Vec3 center, float radius, Rgba8 color)
+void Level::SetDeathBounds(AABB3 const& deathBounds)
 {
-	m_endGoal = new EndGoal(center, radius, color);
+	m_simLevel.SetDeathBounds(deathBounds);
 }
 
-void Level::Update(float deltaSeconds)
+void Level::SetBlockColor(int blockIndex, Rgba8 const& color)
 {
-	UNUSED(deltaSeconds);
+	RestoreCPUGeometry();
+	m_simLevel.SetBlockColor(blockIndex, color);
+	int slotIndex = m_blockMeshSlots[blockIndex];
+	if (slotIndex >= 0)
+	{
+		LevelBlocks const& blocks = m_simLevel.GetBlocks();
+		m_blockMesh.UpdateBlock(slotIndex, blocks.GetBlockBounds(blockIndex), color);
+	}
+}
 
-	if (g_theGame->m_player != nullptr && g_theGame->GetCurrentGameState() == GameState::LEVEL_PLAYING)
+void Level::SetBlockVisible(int blockIndex, bool isVisible)
+{
+	RestoreCPUGeometry();
+	int& slotIndex = m_blockMeshSlots[blockIndex];
+	if (isVisible && slotIndex < 0)
+	{
+		LevelBlocks const& blocks = m_simLevel.GetBlocks();
+		slotIndex = m_blockMesh.AddBlock(blocks.GetBlockBounds(blockIndex), blocks.GetBlockColor(blockIndex));
+	}
+	else if (!isVisible && slotIndex >= 0)
 	{
-		CollidePlayerWithBlocks();
-		CheckDeathBounds(g_theGame->m_player);
-		CheckPlayerVsEndGoal(g_theGame->m_player);
+		m_blockMesh.RemoveBlock(slotIndex);
+		slotIndex = -1;
 	}
 }
 
+bool Level::IsBlockVisible(int blockIndex) const
+{
+	return m_blockMeshSlots[blockIndex] >= 0;
+}
+
+void Level::CullBlocks(ViewFrustum const& frustum, LevelCullStats& out_stats)
+{
+	m_blockMesh.CullChunks(frustum, out_stats);
+}
+
+void Level::LayoutLevelsFromDefinitions(LevelDefinition* levelDef)
+{
+	m_simLevel.LayoutFromDefinition(*levelDef);
+}
+
+void Level::BuildBlockBVH()
+{
+	m_simLevel.BuildBlockBVH();
+}
+
+void Level::SpawnBlock(Vec3 center, Vec3 dimensions, EulerAngles blockOrientation, Rgba8 color)
+{
+	m_simLevel.AddBlock(center, dimensions, blockOrientation, color);
+}
+
+void Level::SpawnEndGoal(Vec3 center, float radius, Rgba8 color)
+{
+	m_simLevel.SetEndGoal(center, radius, color);
+}
+
 void Level::Render() const
 {
 	DrawLevelItems();
@@ -104,153 +180,148 @@ void Level::Render() const
 
 void Level::DrawLevelItems() const
 {
+	if (m_blockMesh.IsEmpty() && m_endGoalVBO == nullptr)
+	{
+		return;
+	}
+
+	// Lighting and samplers are the same for every level and stay bound through the world submit
 	g_theRenderer->SetLightingConstants(m_sunDirection, m_sunIntensity, m_ambientIntensity);
-	g_theRenderer->SetModelConstants();
-	g_theRenderer->SetBlendMode(BlendMode::OPAQUE);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
 	g_theRenderer->BindSampler(SamplerMode::POINT_CLAMP, 0);
 	g_theRenderer->BindSampler(SamplerMode::BILINEAR_WRAP, 1);
 	g_theRenderer->BindSampler(SamplerMode::BILINEAR_WRAP, 2);
-	g_theRenderer->BindTexture(nullptr);
-	g_theRenderer->BindShader(m_phongShader);
-	g_theRenderer->DrawIndexedVertexBuffer(m_blockVBO, m_blockIBO, static_cast<unsigned int>(m_blockIndices.size()));
+
+	RenderCommand command;
+	command.m_layer = RenderLayer::WORLD;
+	command.m_state.m_blendMode = BlendMode::OPAQUE;
+	command.m_state.m_rasterizerMode = RasterizerMode::SOLID_CULL_BACK;
+	command.m_state.m_depthMode = DepthMode::READ_WRITE_LESS_EQUAL;
+	command.m_state.m_shader = m_blockShader;
+	m_blockMesh.Draw(command);
+	if (m_endGoalVBO != nullptr)
+	{
+		command.m_state.m_shader = m_phongShader;
+		g_theRenderQueue->AddIndexedVertexBuffer(command, m_endGoalVBO, m_endGoalIBO, static_cast<unsigned int>(m_numEndGoalIndices));
+	}
 }
 
 void Level::ClearBuffers()
 {
-	delete m_blockVBO;
-	m_blockVBO = nullptr;
+	m_blockMesh.DestroyBuffers();
+
+	delete m_endGoalVBO;
+	m_endGoalVBO = nullptr;
 
-	delete m_blockIBO;
-	m_blockIBO = nullptr;
+	delete m_endGoalIBO;
+	m_endGoalIBO = nullptr;
 }
 
 void Level::DestroyGeometry()
 {
-	for (int blockIndex = 0; blockIndex < static_cast<int>(m_blocks.size()); ++blockIndex)
-	{
-		Block*& block = m_blocks[blockIndex];
-		if (block != nullptr)
-		{
-			delete block;
-			block = nullptr;
-		}
-	}
+	m_simLevel.Clear();
+}
 
-	delete m_endGoal;
-	m_endGoal = nullptr;
+void Level::ClearGeometry()
+{
+	// Keeps the block mesh capacity and buffers for the next layout
+	m_blockMesh.Clear();
+	m_blockMeshSlots.clear();
+	m_endGoalTBNVerts.clear();
+	m_endGoalIndices.clear();
+	m_numEndGoalIndices = 0;
+	m_simLevel.Clear();
 }
 
-void Level::CollidePlayerWithBlocks()
+void Level::ReleaseCPUGeometry()
 {
-	if (g_theGame->m_player != nullptr)
+	// Only what is already on the GPU can go, collision stays for the simulation and for rebuilding
+	if (!HasBuffers())
 	{
-		CollidePlayerWithBlocks(g_theGame->m_player);
+		return;
 	}
+	UploadGeometry();
+	m_blockMesh.ReleaseCPUCopy();
+	std::vector<Vertex_PCUTBN>().swap(m_endGoalTBNVerts);
+	std::vector<unsigned int>().swap(m_endGoalIndices);
 }
 
-void Level::CollidePlayerWithBlocks(Player* playerCharacter)
+void Level::RestoreCPUGeometry()
 {
-	Vec3& playerPos = playerCharacter->m_position;
-	float radius = playerCharacter->m_physicsRadius;
-	float height = playerCharacter->m_physicsHeight;
-	playerCharacter->m_isGrounded = false;
-
-	for (int blockIndex = 0; blockIndex < static_cast<int>(m_blocks.size()); ++blockIndex)
+	if (!m_blockMesh.HasCPUCopy())
 	{
-		Block*& block = m_blocks[blockIndex];
-		Vec3 blockCenter = block->m_bounds.m_center;
-		Vec3 halfDims = block->m_bounds.m_halfDimensions;
-		AABB3 alignedBox = AABB3(blockCenter - halfDims, blockCenter + halfDims);
-
-		if (PushZCylinderOutOfFixedAABB3D(playerPos, radius, height, alignedBox))
+		// Slot layout is unchanged, removed slots come back with zero size like RemoveBlock leaves them
+		std::vector<BlockInstance> instances(m_blockMesh.GetNumSlots());
+		for (BlockInstance& instance : instances)
 		{
-			float playerBottomZ = playerPos.z - (height * 0.5f);
-			float blockTopZ = alignedBox.m_maxs.z;
-
-			if (fabsf(playerBottomZ - blockTopZ) < 0.05f)
-			{
-				playerCharacter->m_isGrounded = true;
-				playerCharacter->m_velocity.z = 0.f;
-			}
-
-			Vec3 alignedblockCenter = alignedBox.GetCenter();
-			Vec3 pushDirection = (playerPos - alignedblockCenter).GetNormalized();
-			Vec3 horizontalVelocity = Vec3(playerCharacter->m_velocity.x, playerCharacter->m_velocity.y, 0.f);
-
-			float pushAmount = DotProduct3D(playerCharacter->m_velocity, pushDirection);
-			if (pushAmount > 0.f)
+			instance.m_halfDimensions = Vec3::ZERO;
+		}
+		LevelBlocks const& blocks = m_simLevel.GetBlocks();
+		for (int blockIndex = 0; blockIndex < static_cast<int>(m_blockMeshSlots.size()); ++blockIndex)
+		{
+			int slotIndex = m_blockMeshSlots[blockIndex];
+			if (slotIndex >= 0)
 			{
-				Vec3 pushVelocity = pushAmount * pushDirection;
-				playerCharacter->m_velocity.x -= pushVelocity.x;
-				playerCharacter->m_velocity.y -= pushVelocity.y;
+				instances[slotIndex] = MakeBlockInstance(blocks.GetBlockBounds(blockIndex), blocks.GetBlockColor(blockIndex));
 			}
 		}
+		m_blockMesh.RestoreCPUCopy(instances.data(), static_cast<int>(instances.size()));
 	}
-}
-
-void Level::CheckDeathBounds(Player* playerCharacter)
-{
-	Vec3& playerPos = playerCharacter->m_position;
-	float radius = playerCharacter->m_physicsRadius;
-	float height = playerCharacter->m_physicsHeight;
 
-	if (DoZCylinderAndAABB3Overlap3D(playerPos, radius, height, m_deathBounds))
+	if (m_simLevel.HasEndGoal() && m_endGoalIndices.empty())
 	{
-		playerCharacter->Respawn();
+		EndGoal const& endGoal = m_simLevel.GetEndGoal();
+		AddVertsForSphere3D(m_endGoalTBNVerts, m_endGoalIndices, endGoal.m_center, endGoal.m_radius, endGoal.m_endGoalColor);
 	}
 }
 
-void Level::CheckPlayerVsEndGoal(Player* playerCharacter)
+bool Level::HasBuffers() const
 {
-	Vec3& playerPos = playerCharacter->m_position;
-	float radius = playerCharacter->m_physicsRadius;
-	float height = playerCharacter->m_physicsHeight;
+	return m_blockMesh.HasBuffers();
+}
 
-	if (DoZCylinderAndSphereOverlap3D(playerPos, radius, height, m_endGoal->m_center, m_endGoal->m_radius))
+LevelMemoryUsage Level::GetMemoryUsage() const
+{
+	LevelMemoryUsage usage;
+	usage.m_collisionBytes = m_simLevel.GetMemoryBytes();
+	usage.m_cpuGeometryBytes = m_blockMesh.GetCPUBytes() + m_blockMeshSlots.capacity() * sizeof(int)
+		+ m_endGoalTBNVerts.capacity() * sizeof(Vertex_PCUTBN) + m_endGoalIndices.capacity() * sizeof(unsigned int);
+	usage.m_gpuBytes = m_blockMesh.GetGPUBytes();
+	if (m_endGoalVBO != nullptr)
 	{
-		m_isLevelComplete = true;
-		AdvanceToNextLevel();
+		usage.m_gpuBytes += m_endGoalVBO->GetSize() + m_endGoalIBO->GetSize();
 	}
+	return usage;
 }
 
-void Level::AdvanceToNextLevel()
+void Level::CreateShader()
 {
-	if (m_isLevelComplete)
-	{
-		g_theGame->m_currentLevelIndex++;
+	std::string shaderName = (m_levelDef->m_shaderName == "Default") ? "Data/Shaders/Phong" : m_levelDef->m_shaderName;
+	m_phongShader = g_theShaderLibrary->CreateOrGetShader(shaderName, VertexType::VERTEX_PCUTBN);
 
-		if (g_theGame->m_currentLevelIndex < static_cast<int>(g_theGame->m_levels.size()))
-		{
-			g_theGame->LoadNextLevel();
-		}
-		else
-		{
-			g_theGame->EnterState(GameState::GAME_COMPLETE);
-		}
-	}
+	// Blocks are in the packed layout, which reads the Vertex_PCU input with its own vertex shader
+	m_blockShader = g_theShaderLibrary->CreateOrGetShader("Data/Shaders/PackedBlock", VertexType::VERTEX_PCU);
 }
 
-bool Level::RaycastDown(Vec3 const& rayStartPos, float maxDist, Vec3& impactPos)
+void Level::CastPlayerRays(Player* playerCharacter) const
 {
-	Vec3 direction = -Vec3::ZAXE;
+	// Every per-frame probe for the player goes through a single batched pass, cast from where the player is drawn
+	BlockRay playerRays[NUM_PLAYER_RAYS];
+	playerRays[PLAYER_RAY_SHADOW].m_start = playerCharacter->m_renderPosition;
+	playerRays[PLAYER_RAY_SHADOW].m_fwdNormal = -Vec3::ZAXE;
+	playerRays[PLAYER_RAY_SHADOW].m_maxDist = SHADOW_RAY_MAX_DIST;
 
-	for (int blockIndex = 0; blockIndex < static_cast<int>(m_blocks.size()); ++blockIndex)
-	{
-		Block*& block = m_blocks[blockIndex];
-		RaycastResult3D raycastResult;
-		raycastResult.m_rayStartPosition = rayStartPos;
-		raycastResult.m_rayFwdNormal = direction;
-		
-		raycastResult = RaycastVsOBB3D(rayStartPos, direction, maxDist, block->m_bounds);
-
-		if (raycastResult.m_didImpact)
-		{
-			impactPos = raycastResult.m_impactPos;
-			return true;
-		}
-	}
+	RaycastResult3D rayResults[NUM_PLAYER_RAYS];
+	m_simLevel.RaycastBlocks(playerRays, NUM_PLAYER_RAYS, rayResults);
 
-	return false;
+	playerCharacter->m_shadowRaycast = rayResults[PLAYER_RAY_SHADOW];
+}
+
+SimLevel const& Level::GetSimLevel() const
+{
+	return m_simLevel;
+}
+
+LevelDefinition const* Level::GetDefinition() const
+{
+	return m_levelDef;
 }
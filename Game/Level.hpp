@@ -1,5 +1,7 @@
 #pragma once
 #include "Game/GameCommon.h"
+#include "Game/SimLevel.hpp"
+#include "Game/LevelBlockMesh.hpp"
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/OBB3.hpp"
 #include "Engine/Math/EulerAngles.hpp"
@@ -8,72 +10,98 @@
 #include <vector>
 // -----------------------------------------------------------------------------
 struct LevelDefinition;
+struct SpawnInfo;
 class Player;
 class VertexBuffer;
 class IndexBuffer;
 class Shader;
-//------------------------------------------------------------------------------
-struct Block
+class ViewFrustum;
+// -----------------------------------------------------------------------------
+constexpr float SHADOW_RAY_MAX_DIST = 100.f;
+// -----------------------------------------------------------------------------
+enum PlayerRay
 {
-	//AABB3 m_bounds = AABB3(Vec3::ZERO, Vec3::ZERO);
-	OBB3  m_bounds = OBB3(Vec3::ZERO, Vec3::ZERO, Vec3::ZERO, Vec3::ZERO, Vec3::ZERO);
-	Rgba8 m_blockColor = Rgba8::WHITE;
-	EulerAngles m_blockOrientation = EulerAngles::ZERO;
+	PLAYER_RAY_SHADOW,
+	NUM_PLAYER_RAYS
 };
 // -----------------------------------------------------------------------------
-struct EndGoal
+struct LevelMemoryUsage
 {
-	EndGoal(Vec3 center, float radius, Rgba8 color)
-		:m_center(center), m_radius(radius), m_endGoalColor(color) {}
-	Vec3  m_center = Vec3::ZERO;
-	float m_radius = 0.0f;
-	Rgba8 m_endGoalColor = Rgba8::WHITE;
+	size_t m_collisionBytes = 0;
+	size_t m_cpuGeometryBytes = 0;
+	size_t m_gpuBytes = 0;
+
+	size_t GetTotalBytes() const { return m_collisionBytes + m_cpuGeometryBytes + m_gpuBytes; }
 };
 // -----------------------------------------------------------------------------
 class Level
 {
 public:
 
-	Level(Game* owner, LevelDefinition* levelDef);
+	Level(Game* owner, LevelDefinition* levelDef);		// CPU side only, call CreateBuffers before drawing
+	Level(Game* owner, LevelDefinition* levelDef, int blockCapacity);
 	~Level();
 
 	void CreateLevelGeometry();
 	void CreateBuffers();
 
+	// Streamed levels: SpawnFromInfos makes no renderer calls and may run on a worker thread,
+	// UploadGeometry then copies into the buffers made up front on the main thread
+	void SpawnFromInfos(std::vector<SpawnInfo> const& spawnInfos);
+	void UploadGeometry();
+	void SetDeathBounds(AABB3 const& deathBounds);
+
+	// Block edits rewrite only that block's slot, the next UploadGeometry copies just those bytes
+	void SetBlockColor(int blockIndex, Rgba8 const& color);
+	void SetBlockVisible(int blockIndex, bool isVisible);
+	bool IsBlockVisible(int blockIndex) const;
+
+	// Picks the block chunks the next Render draws
+	void CullBlocks(ViewFrustum const& frustum, LevelCullStats& out_stats);
+
 	void LayoutLevelsFromDefinitions(LevelDefinition* levelDef);
+	void BuildBlockBVH();
 	void SpawnBlock(Vec3 center, Vec3 dimensions, EulerAngles blockOrientation, Rgba8 color);
 	void SpawnEndGoal(Vec3 center, float radius, Rgba8 color);
 
-	void Update(float deltaSeconds);
-
 	void Render() const;
 	void DrawLevelItems() const;
 
 	void ClearBuffers();
 	void DestroyGeometry();
+	void ClearGeometry();
+
+	// Drops render data that is already on the GPU, edits and CreateBuffers rebuild it from the collision arrays
+	void ReleaseCPUGeometry();
+	void RestoreCPUGeometry();
+	bool HasBuffers() const;
+	LevelMemoryUsage GetMemoryUsage() const;
+
+	void CastPlayerRays(Player* playerCharacter) const;
 
-	void CollidePlayerWithBlocks();
-	void CollidePlayerWithBlocks(Player* playerCharacter);
-	void CheckDeathBounds(Player* playerCharacter);
-	void CheckPlayerVsEndGoal(Player* playerCharacter);
-	void AdvanceToNextLevel();
-	bool RaycastDown(Vec3 const& rayStartPos, float maxDist, Vec3& impactPos);
+	SimLevel const& GetSimLevel() const;
+	LevelDefinition const* GetDefinition() const;
+
+private:
+	void CreateShader();
 
 private:
 	Game* m_theGame = nullptr;
 	LevelDefinition* m_levelDef = nullptr;
-	Shader* m_phongShader = nullptr;
+	Shader* m_phongShader = nullptr;		// End goal, in Vertex_PCUTBN
+	Shader* m_blockShader = nullptr;		// Blocks, in the packed layout
 	Vec3   m_sunDirection = Vec3(3.f, 0.f, 2.f);
 	float  m_sunIntensity = 0.75f;
 	float  m_ambientIntensity = 0.35f;
 
-	std::vector<Vertex_PCUTBN> m_blockTBNVerts;
-	std::vector<unsigned int> m_blockIndices;
-	VertexBuffer* m_blockVBO = nullptr;
-	IndexBuffer* m_blockIBO = nullptr;
+	LevelBlockMesh m_blockMesh;
+	std::vector<int> m_blockMeshSlots;		// Instance slot of each block, -1 while hidden
+
+	std::vector<Vertex_PCUTBN> m_endGoalTBNVerts;
+	std::vector<unsigned int> m_endGoalIndices;
+	int m_numEndGoalIndices = 0;
+	VertexBuffer* m_endGoalVBO = nullptr;
+	IndexBuffer* m_endGoalIBO = nullptr;
 
-	EndGoal* m_endGoal = nullptr;
-	std::vector<Block*> m_blocks;
-	AABB3 m_deathBounds = AABB3(Vec3(-20.f, -20.f, -200.f), Vec3(1000.f, 1000.f, -20.f));
-	bool m_isLevelComplete = false;
+	SimLevel m_simLevel;
 };
\ No newline at end of file
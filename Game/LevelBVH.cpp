@@ -0,0 +1,309 @@
+#include "Game/LevelBVH.hpp"
+#include <algorithm>
+#include <cfloat>
+// -----------------------------------------------------------------------------
+void LevelBVH::Build(std::vector<AABB3> const& primBounds)
+{
+	Clear();
+
+	int numPrims = static_cast<int>(primBounds.size());
+	if (numPrims == 0)
+	{
+		return;
+	}
+
+	std::vector<Vec3> primCentroids;
+	primCentroids.reserve(numPrims);
+	m_primIndices.reserve(numPrims);
+	for (int primIndex = 0; primIndex < numPrims; ++primIndex)
+	{
+		primCentroids.push_back(primBounds[primIndex].GetCenter());
+		m_primIndices.push_back(primIndex);
+	}
+
+	// A binary tree with leaves of at least one prim never needs more than 2n - 1 nodes
+	m_nodes.reserve((numPrims * 2) - 1);
+	BuildNode(primBounds, primCentroids, 0, numPrims);
+
+	m_leafPrimBounds.reserve(numPrims);
+	for (int primIndex = 0; primIndex < numPrims; ++primIndex)
+	{
+		m_leafPrimBounds.push_back(primBounds[m_primIndices[primIndex]]);
+	}
+}
+
+void LevelBVH::Clear()
+{
+	m_nodes.clear();
+	m_primIndices.clear();
+	m_leafPrimBounds.clear();
+}
+
+int LevelBVH::BuildNode(std::vector<AABB3> const& primBounds, std::vector<Vec3> const& primCentroids, int firstPrim, int primCount)
+{
+	int nodeIndex = static_cast<int>(m_nodes.size());
+	m_nodes.push_back(BVHNode());
+
+	// Bounds of every prim in this node, and of their centroids for picking a split axis
+	AABB3 nodeBounds = primBounds[m_primIndices[firstPrim]];
+	AABB3 centroidBounds(primCentroids[m_primIndices[firstPrim]], primCentroids[m_primIndices[firstPrim]]);
+	for (int primIndex = firstPrim + 1; primIndex < firstPrim + primCount; ++primIndex)
+	{
+		AABB3 const& bounds = primBounds[m_primIndices[primIndex]];
+		Vec3 const& centroid = primCentroids[m_primIndices[primIndex]];
+		nodeBounds.m_mins = Vec3(std::min(nodeBounds.m_mins.x, bounds.m_mins.x), std::min(nodeBounds.m_mins.y, bounds.m_mins.y), std::min(nodeBounds.m_mins.z, bounds.m_mins.z));
+		nodeBounds.m_maxs = Vec3(std::max(nodeBounds.m_maxs.x, bounds.m_maxs.x), std::max(nodeBounds.m_maxs.y, bounds.m_maxs.y), std::max(nodeBounds.m_maxs.z, bounds.m_maxs.z));
+		centroidBounds.m_mins = Vec3(std::min(centroidBounds.m_mins.x, centroid.x), std::min(centroidBounds.m_mins.y, centroid.y), std::min(centroidBounds.m_mins.z, centroid.z));
+		centroidBounds.m_maxs = Vec3(std::max(centroidBounds.m_maxs.x, centroid.x), std::max(centroidBounds.m_maxs.y, centroid.y), std::max(centroidBounds.m_maxs.z, centroid.z));
+	}
+	m_nodes[nodeIndex].m_bounds = nodeBounds;
+
+	Vec3 centroidExtents = centroidBounds.m_maxs - centroidBounds.m_mins;
+	if (primCount <= BVH_MAX_PRIMS_PER_LEAF || (centroidExtents.x <= 0.f && centroidExtents.y <= 0.f && centroidExtents.z <= 0.f))
+	{
+		m_nodes[nodeIndex].m_firstPrimOrRightChild = firstPrim;
+		m_nodes[nodeIndex].m_primCount = primCount;
+		return nodeIndex;
+	}
+
+	// Median split along the axis with the widest centroid spread
+	int splitAxis = 0;
+	if (centroidExtents.y > centroidExtents.x && centroidExtents.y >= centroidExtents.z)
+	{
+		splitAxis = 1;
+	}
+	else if (centroidExtents.z > centroidExtents.x && centroidExtents.z > centroidExtents.y)
+	{
+		splitAxis = 2;
+	}
+
+	int halfCount = primCount / 2;
+	std::vector<int>::iterator first = m_primIndices.begin() + firstPrim;
+	std::nth_element(first, first + halfCount, first + primCount, [&primCentroids, splitAxis](int primA, int primB)
+	{
+		Vec3 const& centroidA = primCentroids[primA];
+		Vec3 const& centroidB = primCentroids[primB];
+		if (splitAxis == 0) return centroidA.x < centroidB.x;
+		if (splitAxis == 1) return centroidA.y < centroidB.y;
+		return centroidA.z < centroidB.z;
+	});
+
+	BuildNode(primBounds, primCentroids, firstPrim, halfCount);
+	int rightChild = BuildNode(primBounds, primCentroids, firstPrim + halfCount, primCount - halfCount);
+	m_nodes[nodeIndex].m_firstPrimOrRightChild = rightChild;
+	m_nodes[nodeIndex].m_primCount = 0;
+	return nodeIndex;
+}
+
+void LevelBVH::QueryOverlaps(AABB3 const& queryBounds, std::vector<int>& out_primIndices) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	int nodeStack[BVH_MAX_TRAVERSAL_DEPTH];
+	int stackSize = 0;
+	nodeStack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		int nodeIndex = nodeStack[--stackSize];
+		BVHNode const& node = m_nodes[nodeIndex];
+		if (!DoAABB3sOverlapInclusive(node.m_bounds, queryBounds))
+		{
+			continue;
+		}
+
+		if (node.m_primCount > 0)
+		{
+			for (int primIndex = node.m_firstPrimOrRightChild; primIndex < node.m_firstPrimOrRightChild + node.m_primCount; ++primIndex)
+			{
+				if (DoAABB3sOverlapInclusive(m_leafPrimBounds[primIndex], queryBounds))
+				{
+					out_primIndices.push_back(m_primIndices[primIndex]);
+				}
+			}
+			continue;
+		}
+
+		nodeStack[stackSize++] = node.m_firstPrimOrRightChild;
+		nodeStack[stackSize++] = nodeIndex + 1;
+	}
+}
+
+void LevelBVH::QueryRay(Vec3 const& rayStart, Vec3 const& rayFwdNormal, float maxDist, std::vector<int>& out_primIndices) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	// Division by zero gives +/-inf which the slab test handles correctly
+	Vec3 rayInvFwd = Vec3(1.f / rayFwdNormal.x, 1.f / rayFwdNormal.y, 1.f / rayFwdNormal.z);
+
+	int nodeStack[BVH_MAX_TRAVERSAL_DEPTH];
+	int stackSize = 0;
+	nodeStack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		int nodeIndex = nodeStack[--stackSize];
+		BVHNode const& node = m_nodes[nodeIndex];
+		if (!DoesRayHitAABB3(rayStart, rayInvFwd, maxDist, node.m_bounds))
+		{
+			continue;
+		}
+
+		if (node.m_primCount > 0)
+		{
+			for (int primIndex = node.m_firstPrimOrRightChild; primIndex < node.m_firstPrimOrRightChild + node.m_primCount; ++primIndex)
+			{
+				if (DoesRayHitAABB3(rayStart, rayInvFwd, maxDist, m_leafPrimBounds[primIndex]))
+				{
+					out_primIndices.push_back(m_primIndices[primIndex]);
+				}
+			}
+			continue;
+		}
+
+		nodeStack[stackSize++] = node.m_firstPrimOrRightChild;
+		nodeStack[stackSize++] = nodeIndex + 1;
+	}
+}
+
+int LevelBVH::QueryOverlappingLeaves(AABB3 const& queryBounds, BVHPrimRange* out_primRanges, int maxRanges) const
+{
+	int numRanges = 0;
+	if (m_nodes.empty() || maxRanges <= 0)
+	{
+		return numRanges;
+	}
+
+	int nodeStack[BVH_MAX_TRAVERSAL_DEPTH];
+	int stackSize = 0;
+	nodeStack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		int nodeIndex = nodeStack[--stackSize];
+		BVHNode const& node = m_nodes[nodeIndex];
+		if (!DoAABB3sOverlapInclusive(node.m_bounds, queryBounds))
+		{
+			continue;
+		}
+
+		if (node.m_primCount > 0)
+		{
+			// Leaves are visited in increasing prim order, so neighbours merge into one range. Once the
+			// caller's array is full the last range grows to cover the new leaf, a superset is still correct.
+			if (numRanges > 0 && (numRanges == maxRanges || out_primRanges[numRanges - 1].m_firstPrim + out_primRanges[numRanges - 1].m_primCount == node.m_firstPrimOrRightChild))
+			{
+				BVHPrimRange& lastRange = out_primRanges[numRanges - 1];
+				lastRange.m_primCount = node.m_firstPrimOrRightChild + node.m_primCount - lastRange.m_firstPrim;
+			}
+			else
+			{
+				out_primRanges[numRanges].m_firstPrim = node.m_firstPrimOrRightChild;
+				out_primRanges[numRanges].m_primCount = node.m_primCount;
+				numRanges++;
+			}
+			continue;
+		}
+
+		nodeStack[stackSize++] = node.m_firstPrimOrRightChild;
+		nodeStack[stackSize++] = nodeIndex + 1;
+	}
+	return numRanges;
+}
+
+std::vector<int> const& LevelBVH::GetPrimOrder() const
+{
+	return m_primIndices;
+}
+
+void LevelBVH::AdoptPrimOrder()
+{
+	// The caller has stored its prims in GetPrimOrder() order, so leaf ranges now index them directly
+	for (int primIndex = 0; primIndex < static_cast<int>(m_primIndices.size()); ++primIndex)
+	{
+		m_primIndices[primIndex] = primIndex;
+	}
+}
+
+void LevelBVH::AdoptPrebuilt(BVHNode const* nodes, int numNodes, AABB3 const* leafPrimBounds, int numPrims)
+{
+	m_nodes.assign(nodes, nodes + numNodes);
+	m_leafPrimBounds.assign(leafPrimBounds, leafPrimBounds + numPrims);
+	m_primIndices.resize(numPrims);
+	for (int primIndex = 0; primIndex < numPrims; ++primIndex)
+	{
+		m_primIndices[primIndex] = primIndex;
+	}
+}
+
+std::vector<BVHNode> const& LevelBVH::GetNodes() const
+{
+	return m_nodes;
+}
+
+std::vector<AABB3> const& LevelBVH::GetLeafPrimBounds() const
+{
+	return m_leafPrimBounds;
+}
+
+BVHNode const& LevelBVH::GetNode(int nodeIndex) const
+{
+	return m_nodes[nodeIndex];
+}
+
+int LevelBVH::GetNumNodes() const
+{
+	return static_cast<int>(m_nodes.size());
+}
+
+int LevelBVH::GetNumPrims() const
+{
+	return static_cast<int>(m_primIndices.size());
+}
+
+bool LevelBVH::IsEmpty() const
+{
+	return m_nodes.empty();
+}
+
+size_t LevelBVH::GetMemoryBytes() const
+{
+	return m_nodes.capacity() * sizeof(BVHNode) + m_primIndices.capacity() * sizeof(int) + m_leafPrimBounds.capacity() * sizeof(AABB3);
+}
+
+// -----------------------------------------------------------------------------
+bool DoAABB3sOverlapInclusive(AABB3 const& boxA, AABB3 const& boxB)
+{
+	return boxA.m_mins.x <= boxB.m_maxs.x && boxA.m_maxs.x >= boxB.m_mins.x &&
+		   boxA.m_mins.y <= boxB.m_maxs.y && boxA.m_maxs.y >= boxB.m_mins.y &&
+		   boxA.m_mins.z <= boxB.m_maxs.z && boxA.m_maxs.z >= boxB.m_mins.z;
+}
+
+bool DoesRayHitAABB3(Vec3 const& rayStart, Vec3 const& rayInvFwd, float maxDist, AABB3 const& box)
+{
+	float tMin = 0.f;
+	float tMax = maxDist;
+
+	float tx1 = (box.m_mins.x - rayStart.x) * rayInvFwd.x;
+	float tx2 = (box.m_maxs.x - rayStart.x) * rayInvFwd.x;
+	tMin = std::max(tMin, std::min(tx1, tx2));
+	tMax = std::min(tMax, std::max(tx1, tx2));
+
+	float ty1 = (box.m_mins.y - rayStart.y) * rayInvFwd.y;
+	float ty2 = (box.m_maxs.y - rayStart.y) * rayInvFwd.y;
+	tMin = std::max(tMin, std::min(ty1, ty2));
+	tMax = std::min(tMax, std::max(ty1, ty2));
+
+	float tz1 = (box.m_mins.z - rayStart.z) * rayInvFwd.z;
+	float tz2 = (box.m_maxs.z - rayStart.z) * rayInvFwd.z;
+	tMin = std::max(tMin, std::min(tz1, tz2));
+	tMax = std::min(tMax, std::max(tz1, tz2));
+
+	return tMin <= tMax;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "Engine/Math/AABB3.hpp"
+#include <vector>
+// -----------------------------------------------------------------------------
+constexpr int BVH_MAX_PRIMS_PER_LEAF = 4;
+constexpr int BVH_MAX_TRAVERSAL_DEPTH = 64;
+// -----------------------------------------------------------------------------
+struct BVHNode
+{
+	AABB3 m_bounds;
+	int   m_firstPrimOrRightChild = 0;	// Leaf: first entry in m_primIndices, Internal: right child (left child is always the next node)
+	int   m_primCount = 0;				// 0 for internal nodes
+};
+// -----------------------------------------------------------------------------
+struct BVHPrimRange
+{
+	int m_firstPrim = 0;
+	int m_primCount = 0;
+};
+// -----------------------------------------------------------------------------
+class LevelBVH
+{
+public:
+	void Build(std::vector<AABB3> const& primBounds);
+	void Clear();
+
+	void QueryOverlaps(AABB3 const& queryBounds, std::vector<int>& out_primIndices) const;
+	void QueryRay(Vec3 const& rayStart, Vec3 const& rayFwdNormal, float maxDist, std::vector<int>& out_primIndices) const;
+	int  QueryOverlappingLeaves(AABB3 const& queryBounds, BVHPrimRange* out_primRanges, int maxRanges) const;
+
+	std::vector<int> const& GetPrimOrder() const;
+	void AdoptPrimOrder();
+
+	// Cooked levels store the tree built offline, their prims are already in leaf order
+	void AdoptPrebuilt(BVHNode const* nodes, int numNodes, AABB3 const* leafPrimBounds, int numPrims);
+	std::vector<BVHNode> const& GetNodes() const;
+	std::vector<AABB3> const& GetLeafPrimBounds() const;
+
+	BVHNode const& GetNode(int nodeIndex) const;
+	int  GetNumNodes() const;
+	int  GetNumPrims() const;
+	bool IsEmpty() const;
+	size_t GetMemoryBytes() const;
+
+private:
+	int  BuildNode(std::vector<AABB3> const& primBounds, std::vector<Vec3> const& primCentroids, int firstPrim, int primCount);
+
+private:
+	std::vector<BVHNode> m_nodes;
+	std::vector<int>	 m_primIndices;
+	std::vector<AABB3>	 m_leafPrimBounds;		// Prim bounds in leaf order, parallel to m_primIndices
+};
+// -----------------------------------------------------------------------------
+bool DoAABB3sOverlapInclusive(AABB3 const& boxA, AABB3 const& boxB);
+bool DoesRayHitAABB3(Vec3 const& rayStart, Vec3 const& rayInvFwd, float maxDist, AABB3 const& box);
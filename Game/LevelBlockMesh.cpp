@@ -0,0 +1,399 @@
+#include "Game/LevelBlockMesh.hpp"
+#include "Game/ViewFrustum.hpp"
+#include "Game/GameCommon.h"
+#include "Game/RenderQueue.hpp"
+#include "Game/PackedVertexUtils.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Renderer/Renderer.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+// -----------------------------------------------------------------------------
+LevelBlockMesh::~LevelBlockMesh()
+{
+	DestroyBuffers();
+}
+
+void LevelBlockMesh::Initialize(int blockCapacity)
+{
+	if (blockCapacity > m_slotCapacity)
+	{
+		m_slotCapacity = blockCapacity;
+	}
+	int chunkCapacity = blockCapacity / BLOCKS_PER_DRAW_CHUNK + 1;
+	m_instances.reserve(blockCapacity);
+	m_freeSlots.reserve(blockCapacity);
+	m_dirtyChunks.reserve(chunkCapacity);
+	m_isChunkDirty.reserve(chunkCapacity);
+	m_chunkBounds.reserve(chunkCapacity);
+	m_isChunkBoundsDirty.reserve(chunkCapacity);
+	m_chunkVerts.reserve(BLOCKS_PER_DRAW_CHUNK * VERTS_PER_BLOCK);
+	m_chunkIndices.reserve(BLOCKS_PER_DRAW_CHUNK * INDICES_PER_BLOCK);
+}
+
+void LevelBlockMesh::CreateBuffers()
+{
+	GUARANTEE_OR_DIE(!m_isCPUCopyReleased, "LevelBlockMesh::CreateBuffers needs the CPU copy restored first");
+	DestroyBuffers();
+
+	// Each chunk gets buffers sized to fit it when it is first uploaded
+	m_hasBuffers = true;
+	MarkAllChunksDirty();
+}
+
+void LevelBlockMesh::ReserveBuffers()
+{
+	GUARANTEE_OR_DIE(m_hasBuffers, "LevelBlockMesh::ReserveBuffers needs CreateBuffers first");
+
+	unsigned int vertexBytes = static_cast<unsigned int>(BLOCKS_PER_DRAW_CHUNK * VERTS_PER_BLOCK) * sizeof(Vertex_PCU);
+	unsigned int indexBytes = static_cast<unsigned int>(BLOCKS_PER_DRAW_CHUNK * INDICES_PER_BLOCK) * sizeof(unsigned int);
+	int numChunks = (m_slotCapacity + BLOCKS_PER_DRAW_CHUNK - 1) / BLOCKS_PER_DRAW_CHUNK;
+	for (int chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex)
+	{
+		EnsureChunkBuffers(chunkIndex, vertexBytes, indexBytes);
+	}
+}
+
+void LevelBlockMesh::DestroyBuffers()
+{
+	for (int chunkIndex = 0; chunkIndex < static_cast<int>(m_chunkVBOs.size()); ++chunkIndex)
+	{
+		delete m_chunkVBOs[chunkIndex];		// Null for chunks that never had blocks
+		delete m_chunkIBOs[chunkIndex];
+	}
+	m_chunkVBOs.clear();
+	m_chunkIBOs.clear();
+	m_chunkNumIndices.clear();
+	m_hasBuffers = false;
+}
+
+void LevelBlockMesh::Clear()
+{
+	// Keeps CPU capacity and GPU buffers for the next fill
+	m_instances.clear();
+	m_freeSlots.clear();
+	m_numSlots = 0;
+	m_isCPUCopyReleased = false;
+	m_dirtyChunks.clear();
+	m_isChunkDirty.clear();
+	m_chunkBounds.clear();
+	m_isChunkBoundsDirty.clear();
+	m_visibleChunks.clear();
+	std::fill(m_chunkNumIndices.begin(), m_chunkNumIndices.end(), 0u);
+}
+
+int LevelBlockMesh::AddBlock(OBB3 const& bounds, Rgba8 const& color)
+{
+	GUARANTEE_OR_DIE(!m_isCPUCopyReleased, "LevelBlockMesh::AddBlock needs the CPU copy restored first");
+
+	int slotIndex = -1;
+	if (!m_freeSlots.empty())
+	{
+		slotIndex = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		slotIndex = m_numSlots;
+		m_numSlots++;
+		m_instances.push_back(BlockInstance());
+		if (slotIndex % BLOCKS_PER_DRAW_CHUNK == 0)
+		{
+			AddChunk();
+		}
+	}
+
+	UpdateBlock(slotIndex, bounds, color);
+	return slotIndex;
+}
+
+void LevelBlockMesh::UpdateBlock(int slotIndex, OBB3 const& bounds, Rgba8 const& color)
+{
+	GUARANTEE_OR_DIE(slotIndex >= 0 && slotIndex < m_numSlots, "LevelBlockMesh::UpdateBlock slot out of range");
+	GUARANTEE_OR_DIE(!m_isCPUCopyReleased, "LevelBlockMesh::UpdateBlock needs the CPU copy restored first");
+
+	m_instances[slotIndex] = MakeBlockInstance(bounds, color);
+	MarkSlotDirty(slotIndex);
+}
+
+void LevelBlockMesh::AddBlocks(BlockInstance const* instances, int numInstances)
+{
+	GUARANTEE_OR_DIE(m_numSlots == 0, "LevelBlockMesh::AddBlocks needs an empty mesh");
+
+	m_instances.assign(instances, instances + numInstances);
+	m_numSlots = numInstances;
+	int numChunks = (numInstances + BLOCKS_PER_DRAW_CHUNK - 1) / BLOCKS_PER_DRAW_CHUNK;
+	for (int chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex)
+	{
+		AddChunk();
+	}
+}
+
+void LevelBlockMesh::RemoveBlock(int slotIndex)
+{
+	GUARANTEE_OR_DIE(slotIndex >= 0 && slotIndex < m_numSlots, "LevelBlockMesh::RemoveBlock slot out of range");
+	GUARANTEE_OR_DIE(!m_isCPUCopyReleased, "LevelBlockMesh::RemoveBlock needs the CPU copy restored first");
+
+	// A zero sized block is left out when its chunk is rebuilt
+	m_instances[slotIndex].m_halfDimensions = Vec3::ZERO;
+	m_freeSlots.push_back(slotIndex);
+	MarkSlotDirty(slotIndex);
+}
+
+void LevelBlockMesh::UploadDirtyChunks()
+{
+	if (!m_hasBuffers || m_dirtyChunks.empty())
+	{
+		return;
+	}
+
+	// Each dirty chunk is rebuilt whole and replaces its buffers' contents in one copy
+	for (int chunkIndex : m_dirtyChunks)
+	{
+		BuildChunkMesh(chunkIndex);
+		unsigned int vertexBytes = static_cast<unsigned int>(m_chunkVerts.size() * sizeof(Vertex_PCU));
+		unsigned int indexBytes = static_cast<unsigned int>(m_chunkIndices.size() * sizeof(unsigned int));
+		if (!m_chunkIndices.empty())
+		{
+			EnsureChunkBuffers(chunkIndex, vertexBytes, indexBytes);
+			g_theRenderer->CopyCPUToGPU(m_chunkVerts.data(), vertexBytes, m_chunkVBOs[chunkIndex]);
+			g_theRenderer->CopyCPUToGPU(m_chunkIndices.data(), indexBytes, m_chunkIBOs[chunkIndex]);
+		}
+		if (chunkIndex < static_cast<int>(m_chunkNumIndices.size()))
+		{
+			m_chunkNumIndices[chunkIndex] = static_cast<unsigned int>(m_chunkIndices.size());
+		}
+		m_isChunkDirty[chunkIndex] = 0;
+	}
+	m_dirtyChunks.clear();
+}
+
+void LevelBlockMesh::CullChunks(ViewFrustum const& frustum, LevelCullStats& out_stats)
+{
+	m_visibleChunks.clear();
+	for (int chunkIndex = 0; chunkIndex < static_cast<int>(m_chunkBounds.size()); ++chunkIndex)
+	{
+		if (m_isChunkBoundsDirty[chunkIndex])
+		{
+			UpdateChunkBounds(chunkIndex);
+		}
+
+		AABB3 const& chunkBounds = m_chunkBounds[chunkIndex];
+		bool isChunkEmpty = chunkBounds.m_mins.x > chunkBounds.m_maxs.x;
+		if (isChunkEmpty || frustum.IsAABB3Outside(chunkBounds))
+		{
+			out_stats.m_numChunksCulled++;
+			continue;
+		}
+
+		out_stats.m_numChunksSubmitted++;
+		m_visibleChunks.push_back(chunkIndex);
+	}
+	out_stats.m_numDrawCalls += static_cast<int>(m_visibleChunks.size());
+}
+
+void LevelBlockMesh::Draw(RenderCommand const& command) const
+{
+	if (IsEmpty() || !m_hasBuffers)
+	{
+		return;
+	}
+	for (int chunkIndex : m_visibleChunks)
+	{
+		if (chunkIndex < static_cast<int>(m_chunkNumIndices.size()) && m_chunkNumIndices[chunkIndex] > 0)
+		{
+			g_theRenderQueue->AddIndexedVertexBuffer(command, m_chunkVBOs[chunkIndex], m_chunkIBOs[chunkIndex], m_chunkNumIndices[chunkIndex]);
+		}
+	}
+}
+
+void LevelBlockMesh::ReleaseCPUCopy()
+{
+	if (m_isCPUCopyReleased || !m_hasBuffers || !m_dirtyChunks.empty())
+	{
+		return;
+	}
+
+	// Culling only reads chunk bounds, settle them now while the records are still here
+	for (int chunkIndex = 0; chunkIndex < static_cast<int>(m_chunkBounds.size()); ++chunkIndex)
+	{
+		if (m_isChunkBoundsDirty[chunkIndex])
+		{
+			UpdateChunkBounds(chunkIndex);
+		}
+	}
+
+	std::vector<BlockInstance>().swap(m_instances);
+	std::vector<Vertex_PCU>().swap(m_chunkVerts);
+	std::vector<unsigned int>().swap(m_chunkIndices);
+	m_isCPUCopyReleased = true;
+}
+
+void LevelBlockMesh::RestoreCPUCopy(BlockInstance const* instances, int numInstances)
+{
+	GUARANTEE_OR_DIE(numInstances == m_numSlots, "LevelBlockMesh::RestoreCPUCopy needs one record per slot");
+	if (!m_isCPUCopyReleased)
+	{
+		return;
+	}
+
+	// Matches what the GPU already holds, so nothing is marked dirty
+	m_instances.assign(instances, instances + numInstances);
+	m_isCPUCopyReleased = false;
+}
+
+bool LevelBlockMesh::HasCPUCopy() const
+{
+	return !m_isCPUCopyReleased;
+}
+
+bool LevelBlockMesh::HasBuffers() const
+{
+	return m_hasBuffers;
+}
+
+int LevelBlockMesh::GetNumSlots() const
+{
+	return m_numSlots;
+}
+
+int LevelBlockMesh::GetNumUsedSlots() const
+{
+	return m_numSlots - static_cast<int>(m_freeSlots.size());
+}
+
+bool LevelBlockMesh::IsEmpty() const
+{
+	return GetNumUsedSlots() == 0;
+}
+
+size_t LevelBlockMesh::GetCPUBytes() const
+{
+	return m_instances.capacity() * sizeof(BlockInstance) + m_isChunkDirty.capacity() + (m_freeSlots.capacity() + m_dirtyChunks.capacity()) * sizeof(int)
+		+ m_chunkBounds.capacity() * sizeof(AABB3) + m_isChunkBoundsDirty.capacity() + m_visibleChunks.capacity() * sizeof(int)
+		+ m_chunkVerts.capacity() * sizeof(Vertex_PCU) + m_chunkIndices.capacity() * sizeof(unsigned int);
+}
+
+size_t LevelBlockMesh::GetGPUBytes() const
+{
+	size_t gpuBytes = 0;
+	for (int chunkIndex = 0; chunkIndex < static_cast<int>(m_chunkVBOs.size()); ++chunkIndex)
+	{
+		if (m_chunkVBOs[chunkIndex] != nullptr)
+		{
+			gpuBytes += m_chunkVBOs[chunkIndex]->GetSize() + m_chunkIBOs[chunkIndex]->GetSize();
+		}
+	}
+	return gpuBytes;
+}
+
+void LevelBlockMesh::AddChunk()
+{
+	m_chunkBounds.push_back(AABB3());
+	m_isChunkBoundsDirty.push_back(1);
+	m_isChunkDirty.push_back(1);
+	m_dirtyChunks.push_back(static_cast<int>(m_chunkBounds.size()) - 1);
+}
+
+void LevelBlockMesh::EnsureChunkBuffers(int chunkIndex, unsigned int vertexBytes, unsigned int indexBytes)
+{
+	if (chunkIndex >= static_cast<int>(m_chunkVBOs.size()))
+	{
+		m_chunkVBOs.resize(chunkIndex + 1, nullptr);
+		m_chunkIBOs.resize(chunkIndex + 1, nullptr);
+		m_chunkNumIndices.resize(chunkIndex + 1, 0);
+	}
+
+	// Recreated only when a rebuild no longer fits, a shrinking chunk keeps its buffers
+	VertexBuffer*& vbo = m_chunkVBOs[chunkIndex];
+	if (vbo == nullptr || vbo->GetSize() < vertexBytes)
+	{
+		delete vbo;
+		vbo = g_theRenderer->CreateVertexBuffer(vertexBytes, sizeof(Vertex_PCU));
+	}
+	IndexBuffer*& ibo = m_chunkIBOs[chunkIndex];
+	if (ibo == nullptr || ibo->GetSize() < indexBytes)
+	{
+		delete ibo;
+		ibo = g_theRenderer->CreateIndexBuffer(indexBytes, sizeof(unsigned int));
+	}
+}
+
+void LevelBlockMesh::BuildChunkMesh(int chunkIndex)
+{
+	m_chunkVerts.clear();
+	m_chunkIndices.clear();
+
+	int firstSlot = chunkIndex * BLOCKS_PER_DRAW_CHUNK;
+	int lastSlot = std::min(firstSlot + BLOCKS_PER_DRAW_CHUNK, m_numSlots);
+	for (int slotIndex = firstSlot; slotIndex < lastSlot; ++slotIndex)
+	{
+		BlockInstance const& instance = m_instances[slotIndex];
+		if (instance.m_halfDimensions == Vec3::ZERO)
+		{
+			continue;
+		}
+
+		// Appends straight onto the chunk, the packed helpers offset indices by the verts already there
+		Vec3 kBasisNormal = CrossProduct3D(instance.m_iBasisNormal, instance.m_jBasisNormal);
+		OBB3 bounds(instance.m_center, instance.m_iBasisNormal, instance.m_jBasisNormal, kBasisNormal, instance.m_halfDimensions);
+		AddVertsForOBB3DPacked(m_chunkVerts, m_chunkIndices, bounds, instance.m_color);
+	}
+}
+
+void LevelBlockMesh::MarkSlotDirty(int slotIndex)
+{
+	int chunkIndex = slotIndex / BLOCKS_PER_DRAW_CHUNK;
+	m_isChunkBoundsDirty[chunkIndex] = 1;
+	if (m_isChunkDirty[chunkIndex] == 0)
+	{
+		m_isChunkDirty[chunkIndex] = 1;
+		m_dirtyChunks.push_back(chunkIndex);
+	}
+}
+
+void LevelBlockMesh::MarkAllChunksDirty()
+{
+	for (int chunkIndex = 0; chunkIndex < static_cast<int>(m_chunkBounds.size()); ++chunkIndex)
+	{
+		if (m_isChunkDirty[chunkIndex] == 0)
+		{
+			m_isChunkDirty[chunkIndex] = 1;
+			m_dirtyChunks.push_back(chunkIndex);
+		}
+	}
+}
+
+void LevelBlockMesh::UpdateChunkBounds(int chunkIndex)
+{
+	int firstInstance = chunkIndex * BLOCKS_PER_DRAW_CHUNK;
+	int lastInstance = firstInstance + BLOCKS_PER_DRAW_CHUNK;
+	if (lastInstance > m_numSlots)
+	{
+		lastInstance = m_numSlots;
+	}
+
+	// World box of each oriented block, removed blocks have zero size and are skipped
+	AABB3 chunkBounds(Vec3(FLT_MAX, FLT_MAX, FLT_MAX), Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX));
+	for (int instanceIndex = firstInstance; instanceIndex < lastInstance; ++instanceIndex)
+	{
+		BlockInstance const& instance = m_instances[instanceIndex];
+		if (instance.m_halfDimensions == Vec3::ZERO)
+		{
+			continue;
+		}
+
+		Vec3 i = instance.m_iBasisNormal * instance.m_halfDimensions.x;
+		Vec3 j = instance.m_jBasisNormal * instance.m_halfDimensions.y;
+		Vec3 k = CrossProduct3D(instance.m_iBasisNormal, instance.m_jBasisNormal) * instance.m_halfDimensions.z;
+		Vec3 extents(fabsf(i.x) + fabsf(j.x) + fabsf(k.x), fabsf(i.y) + fabsf(j.y) + fabsf(k.y), fabsf(i.z) + fabsf(j.z) + fabsf(k.z));
+		Vec3 mins = instance.m_center - extents;
+		Vec3 maxs = instance.m_center + extents;
+		chunkBounds.m_mins = Vec3(std::min(chunkBounds.m_mins.x, mins.x), std::min(chunkBounds.m_mins.y, mins.y), std::min(chunkBounds.m_mins.z, mins.z));
+		chunkBounds.m_maxs = Vec3(std::max(chunkBounds.m_maxs.x, maxs.x), std::max(chunkBounds.m_maxs.y, maxs.y), std::max(chunkBounds.m_maxs.z, maxs.z));
+	}
+	m_chunkBounds[chunkIndex] = chunkBounds;
+	m_isChunkBoundsDirty[chunkIndex] = 0;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/OBB3.hpp"
+#include "Engine/Math/Vec3.h"
+#include "Engine/Core/Rgba8.h"
+#include "Engine/Core/Vertex_PCU.h"
+#include <vector>
+// -----------------------------------------------------------------------------
+class VertexBuffer;
+class IndexBuffer;
+class ViewFrustum;
+struct RenderCommand;
+// -----------------------------------------------------------------------------
+constexpr int VERTS_PER_BLOCK = 24;
+constexpr int INDICES_PER_BLOCK = 36;
+constexpr int BLOCKS_PER_DRAW_CHUNK = 32;		// Slots are in BVH order, so neighbouring slots are neighbouring blocks
+// -----------------------------------------------------------------------------
+// Compact record of one block, the k basis is i x j. Chunk meshes are built from it
+// -----------------------------------------------------------------------------
+struct BlockInstance
+{
+	Vec3  m_center;
+	Vec3  m_iBasisNormal;
+	Vec3  m_jBasisNormal;
+	Vec3  m_halfDimensions;
+	Rgba8 m_color;
+};
+static_assert(sizeof(BlockInstance) == 52, "BlockInstance is stored raw in cooked level files");
+
+inline BlockInstance MakeBlockInstance(OBB3 const& bounds, Rgba8 const& color)
+{
+	BlockInstance instance;
+	instance.m_center = bounds.m_center;
+	instance.m_iBasisNormal = bounds.m_iBasisNormal;
+	instance.m_jBasisNormal = bounds.m_jBasisNormal;
+	instance.m_halfDimensions = bounds.m_halfDimensions;
+	instance.m_color = color;
+	return instance;
+}
+// -----------------------------------------------------------------------------
+struct LevelCullStats
+{
+	int m_numChunksSubmitted = 0;
+	int m_numChunksCulled = 0;
+	int m_numDrawCalls = 0;
+};
+// -----------------------------------------------------------------------------
+// Level blocks kept as one 52 byte record per fixed slot. Slots are grouped into
+// draw chunks, each with its own vertex and index buffer and bounds. Chunk
+// vertices use the packed 24 byte layout from PackedVertexUtils. Editing a
+// block rewrites only its slot and marks its chunk dirty, and only dirty chunks
+// are rebuilt and copied to the GPU. Removed slots get zero size, are left out
+// of their chunk's mesh and go on a free list for the next added block.
+//
+// Blocks are not drawn instanced, the Engine has no instanced draw call, so a
+// chunk is still expanded to 24 vertices per block when it is rebuilt. Chunk
+// buffers are sized to what they hold and only recreated when a rebuild
+// outgrows them. ReserveBuffers sizes every chunk for a full chunk up front,
+// for meshes that are emptied and refilled in place.
+//
+// CullChunks keeps the chunks inside the view and Draw submits only those.
+// -----------------------------------------------------------------------------
+class LevelBlockMesh
+{
+public:
+	~LevelBlockMesh();
+
+	void Initialize(int blockCapacity);
+	void CreateBuffers();
+	void ReserveBuffers();		// Full chunk buffers for the whole capacity, after CreateBuffers
+	void DestroyBuffers();
+	void Clear();
+
+	int  AddBlock(OBB3 const& bounds, Rgba8 const& color);
+	void AddBlocks(BlockInstance const* instances, int numInstances);		// Into fresh slots 0..n-1 of an empty mesh
+	void UpdateBlock(int slotIndex, OBB3 const& bounds, Rgba8 const& color);
+	void RemoveBlock(int slotIndex);
+
+	void UploadDirtyChunks();
+	void CullChunks(ViewFrustum const& frustum, LevelCullStats& out_stats);
+	void Draw(RenderCommand const& command) const;
+
+	// Frees the block records once every chunk is on the GPU. Edits and CreateBuffers need it back
+	// through RestoreCPUCopy, with one record per slot and zero size in removed slots
+	void ReleaseCPUCopy();
+	void RestoreCPUCopy(BlockInstance const* instances, int numInstances);
+	bool HasCPUCopy() const;
+	bool HasBuffers() const;
+
+	int    GetNumSlots() const;
+	int    GetNumUsedSlots() const;
+	bool   IsEmpty() const;
+	size_t GetCPUBytes() const;
+	size_t GetGPUBytes() const;
+
+private:
+	void AddChunk();
+	void EnsureChunkBuffers(int chunkIndex, unsigned int vertexBytes, unsigned int indexBytes);
+	void BuildChunkMesh(int chunkIndex);
+	void MarkSlotDirty(int slotIndex);
+	void MarkAllChunksDirty();
+	void UpdateChunkBounds(int chunkIndex);
+
+private:
+	std::vector<BlockInstance> m_instances;			// Empty while the CPU copy is released
+	std::vector<int>		   m_freeSlots;
+	int						   m_numSlots = 0;
+	int						   m_slotCapacity = 0;
+	bool					   m_isCPUCopyReleased = false;
+
+	std::vector<int>		   m_dirtyChunks;
+	std::vector<unsigned char> m_isChunkDirty;
+
+	std::vector<AABB3>		   m_chunkBounds;			// Inverted while the chunk has no visible block
+	std::vector<unsigned char> m_isChunkBoundsDirty;
+	std::vector<int>		   m_visibleChunks;
+
+	// Scratch for building one chunk before it is copied to the GPU
+	std::vector<Vertex_PCU>	   m_chunkVerts;
+	std::vector<unsigned int>  m_chunkIndices;
+
+	// One buffer pair per chunk, null until the chunk first has blocks to upload
+	std::vector<VertexBuffer*> m_chunkVBOs;
+	std::vector<IndexBuffer*>  m_chunkIBOs;
+	std::vector<unsigned int>  m_chunkNumIndices;
+	bool					   m_hasBuffers = false;
+};
@@ -0,0 +1,431 @@
+#include "Game/LevelBlocks.hpp"
+#include "Engine/Math/MathUtils.h"
+#include <math.h>
+#if defined(LEVEL_BLOCKS_USE_SSE)
+#include <xmmintrin.h>
+#endif
+// -----------------------------------------------------------------------------
+static std::vector<float> LevelBlocks::* const BLOCK_FLOAT_ARRAYS[NUM_BLOCK_FLOAT_ARRAYS] =
+{
+	&LevelBlocks::m_centerX, &LevelBlocks::m_centerY, &LevelBlocks::m_centerZ,
+	&LevelBlocks::m_iBasisX, &LevelBlocks::m_iBasisY, &LevelBlocks::m_iBasisZ,
+	&LevelBlocks::m_jBasisX, &LevelBlocks::m_jBasisY, &LevelBlocks::m_jBasisZ,
+	&LevelBlocks::m_kBasisX, &LevelBlocks::m_kBasisY, &LevelBlocks::m_kBasisZ,
+	&LevelBlocks::m_halfDimX, &LevelBlocks::m_halfDimY, &LevelBlocks::m_halfDimZ,
+};
+// -----------------------------------------------------------------------------
+void LevelBlocks::AddBlock(Vec3 const& center, Vec3 const& dimensions, EulerAngles const& orientation, Rgba8 const& color)
+{
+	Mat44 rotationMat = orientation.GetAsMatrix_IFwd_JLeft_KUp();
+	Vec3 iBasis = rotationMat.GetIBasis3D();
+	Vec3 jBasis = rotationMat.GetJBasis3D();
+	Vec3 kBasis = rotationMat.GetKBasis3D();
+	Vec3 halfDims = dimensions * 0.5f;
+
+	RemovePadding();
+
+	m_centerX.push_back(center.x);
+	m_centerY.push_back(center.y);
+	m_centerZ.push_back(center.z);
+
+	m_iBasisX.push_back(iBasis.x);
+	m_iBasisY.push_back(iBasis.y);
+	m_iBasisZ.push_back(iBasis.z);
+	m_jBasisX.push_back(jBasis.x);
+	m_jBasisY.push_back(jBasis.y);
+	m_jBasisZ.push_back(jBasis.z);
+	m_kBasisX.push_back(kBasis.x);
+	m_kBasisY.push_back(kBasis.y);
+	m_kBasisZ.push_back(kBasis.z);
+
+	m_halfDimX.push_back(halfDims.x);
+	m_halfDimY.push_back(halfDims.y);
+	m_halfDimZ.push_back(halfDims.z);
+
+	m_colors.push_back(color);
+	m_orientations.push_back(orientation);
+	m_numBlocks++;
+
+	AddPadding();
+}
+
+void LevelBlocks::Reorder(std::vector<int> const& newOrder)
+{
+	// newOrder[newIndex] is the old index of the block that should end up at newIndex
+	LevelBlocks reordered;
+	for (int newIndex = 0; newIndex < static_cast<int>(newOrder.size()); ++newIndex)
+	{
+		int oldIndex = newOrder[newIndex];
+		reordered.m_centerX.push_back(m_centerX[oldIndex]);
+		reordered.m_centerY.push_back(m_centerY[oldIndex]);
+		reordered.m_centerZ.push_back(m_centerZ[oldIndex]);
+		reordered.m_iBasisX.push_back(m_iBasisX[oldIndex]);
+		reordered.m_iBasisY.push_back(m_iBasisY[oldIndex]);
+		reordered.m_iBasisZ.push_back(m_iBasisZ[oldIndex]);
+		reordered.m_jBasisX.push_back(m_jBasisX[oldIndex]);
+		reordered.m_jBasisY.push_back(m_jBasisY[oldIndex]);
+		reordered.m_jBasisZ.push_back(m_jBasisZ[oldIndex]);
+		reordered.m_kBasisX.push_back(m_kBasisX[oldIndex]);
+		reordered.m_kBasisY.push_back(m_kBasisY[oldIndex]);
+		reordered.m_kBasisZ.push_back(m_kBasisZ[oldIndex]);
+		reordered.m_halfDimX.push_back(m_halfDimX[oldIndex]);
+		reordered.m_halfDimY.push_back(m_halfDimY[oldIndex]);
+		reordered.m_halfDimZ.push_back(m_halfDimZ[oldIndex]);
+		reordered.m_colors.push_back(m_colors[oldIndex]);
+		reordered.m_orientations.push_back(m_orientations[oldIndex]);
+	}
+	reordered.m_numBlocks = static_cast<int>(newOrder.size());
+	reordered.AddPadding();
+
+	*this = reordered;
+}
+
+void LevelBlocks::Clear()
+{
+	*this = LevelBlocks();
+}
+
+std::vector<float> const& LevelBlocks::GetFloatArray(int arrayIndex) const
+{
+	return this->*BLOCK_FLOAT_ARRAYS[arrayIndex];
+}
+
+void LevelBlocks::AssignArrays(int numBlocks, float const* const floatArrays[NUM_BLOCK_FLOAT_ARRAYS], Rgba8 const* colors, EulerAngles const* orientations)
+{
+	// Float arrays arrive already padded, one bulk copy each instead of a push per block
+	int paddedCount = numBlocks + BLOCK_SIMD_WIDTH - 1;
+	for (int arrayIndex = 0; arrayIndex < NUM_BLOCK_FLOAT_ARRAYS; ++arrayIndex)
+	{
+		(this->*BLOCK_FLOAT_ARRAYS[arrayIndex]).assign(floatArrays[arrayIndex], floatArrays[arrayIndex] + paddedCount);
+	}
+	m_colors.assign(colors, colors + numBlocks);
+	m_orientations.assign(orientations, orientations + numBlocks);
+	m_numBlocks = numBlocks;
+}
+
+int LevelBlocks::GetNumBlocks() const
+{
+	return m_numBlocks;
+}
+
+size_t LevelBlocks::GetMemoryBytes() const
+{
+	size_t memoryBytes = m_colors.capacity() * sizeof(Rgba8) + m_orientations.capacity() * sizeof(EulerAngles);
+	for (int arrayIndex = 0; arrayIndex < NUM_BLOCK_FLOAT_ARRAYS; ++arrayIndex)
+	{
+		memoryBytes += GetFloatArray(arrayIndex).capacity() * sizeof(float);
+	}
+	return memoryBytes;
+}
+
+OBB3 LevelBlocks::GetBlockBounds(int blockIndex) const
+{
+	Vec3 center = Vec3(m_centerX[blockIndex], m_centerY[blockIndex], m_centerZ[blockIndex]);
+	Vec3 iBasis = Vec3(m_iBasisX[blockIndex], m_iBasisY[blockIndex], m_iBasisZ[blockIndex]);
+	Vec3 jBasis = Vec3(m_jBasisX[blockIndex], m_jBasisY[blockIndex], m_jBasisZ[blockIndex]);
+	Vec3 kBasis = Vec3(m_kBasisX[blockIndex], m_kBasisY[blockIndex], m_kBasisZ[blockIndex]);
+	Vec3 halfDims = Vec3(m_halfDimX[blockIndex], m_halfDimY[blockIndex], m_halfDimZ[blockIndex]);
+	return OBB3(center, iBasis, jBasis, kBasis, halfDims);
+}
+
+AABB3 LevelBlocks::GetBlockWorldBounds(int blockIndex) const
+{
+	float halfX = m_halfDimX[blockIndex];
+	float halfY = m_halfDimY[blockIndex];
+	float halfZ = m_halfDimZ[blockIndex];
+
+	Vec3 worldHalfDims;
+	worldHalfDims.x = fabsf(m_iBasisX[blockIndex]) * halfX + fabsf(m_jBasisX[blockIndex]) * halfY + fabsf(m_kBasisX[blockIndex]) * halfZ;
+	worldHalfDims.y = fabsf(m_iBasisY[blockIndex]) * halfX + fabsf(m_jBasisY[blockIndex]) * halfY + fabsf(m_kBasisY[blockIndex]) * halfZ;
+	worldHalfDims.z = fabsf(m_iBasisZ[blockIndex]) * halfX + fabsf(m_jBasisZ[blockIndex]) * halfY + fabsf(m_kBasisZ[blockIndex]) * halfZ;
+
+	Vec3 center = Vec3(m_centerX[blockIndex], m_centerY[blockIndex], m_centerZ[blockIndex]);
+	return AABB3(center - worldHalfDims, center + worldHalfDims);
+}
+
+Rgba8 LevelBlocks::GetBlockColor(int blockIndex) const
+{
+	return m_colors[blockIndex];
+}
+
+// -----------------------------------------------------------------------------
+// Separating axis test of a Z-up cylinder against each block, using the three
+// block face axes, world Z and the horizontal axis from the closest point on the
+// block's local XY rectangle to the cylinder centre. That last one is the circle
+// against rectangle test and keeps corners and vertical edges from reaching out
+// further than the block does. The support of the cylinder along a unit axis a
+// is halfHeight * |a.z| + radius * sqrt(1 - a.z^2).
+// Returns one bit per block in [firstBlock, firstBlock + blockCount), blockCount <= BLOCK_SIMD_WIDTH.
+// -----------------------------------------------------------------------------
+unsigned int LevelBlocks::GetZCylinderOverlapMask(int firstBlock, int blockCount, Vec3 const& cylinderCenter, float radius, float halfHeight) const
+{
+	unsigned int laneMask = (1u << blockCount) - 1u;
+
+#if defined(LEVEL_BLOCKS_USE_SSE)
+	__m128 const signMask = _mm_set1_ps(-0.f);
+	__m128 const zero = _mm_setzero_ps();
+	__m128 const one = _mm_set1_ps(1.f);
+	__m128 const cylRadius = _mm_set1_ps(radius);
+	__m128 const cylHalfHeight = _mm_set1_ps(halfHeight);
+	__m128 const minAxisLengthSquared = _mm_set1_ps(1e-12f);
+
+	__m128 dispX = _mm_sub_ps(_mm_set1_ps(cylinderCenter.x), _mm_loadu_ps(&m_centerX[firstBlock]));
+	__m128 dispY = _mm_sub_ps(_mm_set1_ps(cylinderCenter.y), _mm_loadu_ps(&m_centerY[firstBlock]));
+	__m128 dispZ = _mm_sub_ps(_mm_set1_ps(cylinderCenter.z), _mm_loadu_ps(&m_centerZ[firstBlock]));
+
+	__m128 halfDimX = _mm_loadu_ps(&m_halfDimX[firstBlock]);
+	__m128 halfDimY = _mm_loadu_ps(&m_halfDimY[firstBlock]);
+	__m128 halfDimZ = _mm_loadu_ps(&m_halfDimZ[firstBlock]);
+
+	__m128 iZ = _mm_loadu_ps(&m_iBasisZ[firstBlock]);
+	__m128 jZ = _mm_loadu_ps(&m_jBasisZ[firstBlock]);
+	__m128 kZ = _mm_loadu_ps(&m_kBasisZ[firstBlock]);
+
+	// Block face axes
+	__m128 overlapping = _mm_cmpeq_ps(zero, zero);
+	float const* axisX[3] = { &m_iBasisX[firstBlock], &m_jBasisX[firstBlock], &m_kBasisX[firstBlock] };
+	float const* axisY[3] = { &m_iBasisY[firstBlock], &m_jBasisY[firstBlock], &m_kBasisY[firstBlock] };
+	__m128 axisZ[3] = { iZ, jZ, kZ };
+	__m128 halfDim[3] = { halfDimX, halfDimY, halfDimZ };
+	for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
+	{
+		__m128 aX = _mm_loadu_ps(axisX[axisIndex]);
+		__m128 aY = _mm_loadu_ps(axisY[axisIndex]);
+		__m128 aZ = axisZ[axisIndex];
+
+		__m128 projected = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dispX, aX), _mm_mul_ps(dispY, aY)), _mm_mul_ps(dispZ, aZ));
+		__m128 distance = _mm_andnot_ps(signMask, projected);
+
+		__m128 horizontalLength = _mm_sqrt_ps(_mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(aZ, aZ))));
+		__m128 cylinderSupport = _mm_add_ps(_mm_mul_ps(cylHalfHeight, _mm_andnot_ps(signMask, aZ)), _mm_mul_ps(cylRadius, horizontalLength));
+
+		__m128 overlap = _mm_sub_ps(_mm_add_ps(halfDim[axisIndex], cylinderSupport), distance);
+		overlapping = _mm_and_ps(overlapping, _mm_cmpgt_ps(overlap, zero));
+	}
+
+	// World Z, the cylinder's own axis
+	__m128 blockSupportZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(halfDimX, _mm_andnot_ps(signMask, iZ)), _mm_mul_ps(halfDimY, _mm_andnot_ps(signMask, jZ))), _mm_mul_ps(halfDimZ, _mm_andnot_ps(signMask, kZ)));
+	__m128 overlapZ = _mm_sub_ps(_mm_add_ps(blockSupportZ, cylHalfHeight), _mm_andnot_ps(signMask, dispZ));
+	overlapping = _mm_and_ps(overlapping, _mm_cmpgt_ps(overlapZ, zero));
+
+	// Closest point on the local XY rectangle, the axis from it to the centre
+	__m128 iX = _mm_loadu_ps(&m_iBasisX[firstBlock]);
+	__m128 iY = _mm_loadu_ps(&m_iBasisY[firstBlock]);
+	__m128 jX = _mm_loadu_ps(&m_jBasisX[firstBlock]);
+	__m128 jY = _mm_loadu_ps(&m_jBasisY[firstBlock]);
+	__m128 kX = _mm_loadu_ps(&m_kBasisX[firstBlock]);
+	__m128 kY = _mm_loadu_ps(&m_kBasisY[firstBlock]);
+
+	__m128 localX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dispX, iX), _mm_mul_ps(dispY, iY)), _mm_mul_ps(dispZ, iZ));
+	__m128 localY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dispX, jX), _mm_mul_ps(dispY, jY)), _mm_mul_ps(dispZ, jZ));
+	__m128 closestX = _mm_max_ps(_mm_sub_ps(zero, halfDimX), _mm_min_ps(halfDimX, localX));
+	__m128 closestY = _mm_max_ps(_mm_sub_ps(zero, halfDimY), _mm_min_ps(halfDimY, localY));
+
+	__m128 edgeAxisX = _mm_sub_ps(_mm_sub_ps(dispX, _mm_mul_ps(closestX, iX)), _mm_mul_ps(closestY, jX));
+	__m128 edgeAxisY = _mm_sub_ps(_mm_sub_ps(dispY, _mm_mul_ps(closestX, iY)), _mm_mul_ps(closestY, jY));
+	__m128 edgeAxisLengthSquared = _mm_add_ps(_mm_mul_ps(edgeAxisX, edgeAxisX), _mm_mul_ps(edgeAxisY, edgeAxisY));
+	__m128 hasEdgeAxis = _mm_cmpgt_ps(edgeAxisLengthSquared, minAxisLengthSquared);
+	__m128 oneOverLength = _mm_div_ps(one, _mm_sqrt_ps(_mm_max_ps(edgeAxisLengthSquared, minAxisLengthSquared)));
+	edgeAxisX = _mm_mul_ps(edgeAxisX, oneOverLength);
+	edgeAxisY = _mm_mul_ps(edgeAxisY, oneOverLength);
+
+	// The axis is horizontal, so the cylinder's support along it is its radius
+	__m128 edgeDistance = _mm_andnot_ps(signMask, _mm_add_ps(_mm_mul_ps(dispX, edgeAxisX), _mm_mul_ps(dispY, edgeAxisY)));
+	__m128 blockSupportI = _mm_mul_ps(halfDimX, _mm_andnot_ps(signMask, _mm_add_ps(_mm_mul_ps(edgeAxisX, iX), _mm_mul_ps(edgeAxisY, iY))));
+	__m128 blockSupportJ = _mm_mul_ps(halfDimY, _mm_andnot_ps(signMask, _mm_add_ps(_mm_mul_ps(edgeAxisX, jX), _mm_mul_ps(edgeAxisY, jY))));
+	__m128 blockSupportK = _mm_mul_ps(halfDimZ, _mm_andnot_ps(signMask, _mm_add_ps(_mm_mul_ps(edgeAxisX, kX), _mm_mul_ps(edgeAxisY, kY))));
+	__m128 edgeOverlap = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(blockSupportI, blockSupportJ), blockSupportK), cylRadius), edgeDistance);
+	__m128 edgeSeparated = _mm_and_ps(hasEdgeAxis, _mm_cmple_ps(edgeOverlap, zero));
+	overlapping = _mm_andnot_ps(edgeSeparated, overlapping);
+
+	return static_cast<unsigned int>(_mm_movemask_ps(overlapping)) & laneMask;
+#else
+	unsigned int overlapMask = 0;
+	for (int lane = 0; lane < blockCount; ++lane)
+	{
+		Vec3 pushNormal;
+		float pushDepth = 0.f;
+		if (GetZCylinderPenetration(firstBlock + lane, cylinderCenter, radius, halfHeight, pushNormal, pushDepth))
+		{
+			overlapMask |= (1u << lane);
+		}
+	}
+	return overlapMask & laneMask;
+#endif
+}
+
+bool LevelBlocks::GetZCylinderPenetration(int blockIndex, Vec3 const& cylinderCenter, float radius, float halfHeight, Vec3& out_pushNormal, float& out_pushDepth) const
+{
+	Vec3 displacement = cylinderCenter - Vec3(m_centerX[blockIndex], m_centerY[blockIndex], m_centerZ[blockIndex]);
+
+	Vec3 axes[3] =
+	{
+		Vec3(m_iBasisX[blockIndex], m_iBasisY[blockIndex], m_iBasisZ[blockIndex]),
+		Vec3(m_jBasisX[blockIndex], m_jBasisY[blockIndex], m_jBasisZ[blockIndex]),
+		Vec3(m_kBasisX[blockIndex], m_kBasisY[blockIndex], m_kBasisZ[blockIndex])
+	};
+	float halfDims[3] = { m_halfDimX[blockIndex], m_halfDimY[blockIndex], m_halfDimZ[blockIndex] };
+
+	// World Z first so ties on flat blocks resolve straight up
+	float blockSupportZ = fabsf(axes[0].z) * halfDims[0] + fabsf(axes[1].z) * halfDims[1] + fabsf(axes[2].z) * halfDims[2];
+	float minOverlap = blockSupportZ + halfHeight - fabsf(displacement.z);
+	if (minOverlap <= 0.f)
+	{
+		return false;
+	}
+	Vec3 minOverlapNormal = (displacement.z >= 0.f) ? Vec3::ZAXE : -Vec3::ZAXE;
+
+	for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
+	{
+		Vec3 const& axis = axes[axisIndex];
+		float projected = DotProduct3D(displacement, axis);
+		float horizontalLength = sqrtf(fmaxf(0.f, 1.f - (axis.z * axis.z)));
+		float cylinderSupport = (halfHeight * fabsf(axis.z)) + (radius * horizontalLength);
+
+		float overlap = halfDims[axisIndex] + cylinderSupport - fabsf(projected);
+		if (overlap <= 0.f)
+		{
+			return false;
+		}
+		if (overlap < minOverlap)
+		{
+			minOverlap = overlap;
+			minOverlapNormal = (projected >= 0.f) ? axis : -axis;
+		}
+	}
+
+	// Closest point on the local XY rectangle, the axis from it to the centre. Skipped when the
+	// centre is over the rectangle, the face axes already cover that
+	float closestX = GetClamped(DotProduct3D(displacement, axes[0]), -halfDims[0], halfDims[0]);
+	float closestY = GetClamped(DotProduct3D(displacement, axes[1]), -halfDims[1], halfDims[1]);
+	Vec3 edgeAxis = displacement - (axes[0] * closestX) - (axes[1] * closestY);
+	edgeAxis.z = 0.f;
+	float edgeAxisLengthSquared = (edgeAxis.x * edgeAxis.x) + (edgeAxis.y * edgeAxis.y);
+	if (edgeAxisLengthSquared > 1e-12f)
+	{
+		edgeAxis = edgeAxis * (1.f / sqrtf(edgeAxisLengthSquared));
+		float projected = DotProduct3D(displacement, edgeAxis);
+		float blockSupport = (fabsf(DotProduct3D(edgeAxis, axes[0])) * halfDims[0]) + (fabsf(DotProduct3D(edgeAxis, axes[1])) * halfDims[1]) +
+			(fabsf(DotProduct3D(edgeAxis, axes[2])) * halfDims[2]);
+
+		// Horizontal, so the cylinder's support along it is its radius
+		float overlap = blockSupport + radius - fabsf(projected);
+		if (overlap <= 0.f)
+		{
+			return false;
+		}
+		if (overlap < minOverlap)
+		{
+			minOverlap = overlap;
+			minOverlapNormal = (projected >= 0.f) ? edgeAxis : -edgeAxis;
+		}
+	}
+
+	out_pushNormal = minOverlapNormal;
+	out_pushDepth = minOverlap;
+	return true;
+}
+
+bool LevelBlocks::RaycastBlock(int blockIndex, BlockRay const& ray, float& out_impactDist, Vec3& out_impactNormal) const
+{
+	Vec3 axes[3] =
+	{
+		Vec3(m_iBasisX[blockIndex], m_iBasisY[blockIndex], m_iBasisZ[blockIndex]),
+		Vec3(m_jBasisX[blockIndex], m_jBasisY[blockIndex], m_jBasisZ[blockIndex]),
+		Vec3(m_kBasisX[blockIndex], m_kBasisY[blockIndex], m_kBasisZ[blockIndex])
+	};
+	float halfDims[3] = { m_halfDimX[blockIndex], m_halfDimY[blockIndex], m_halfDimZ[blockIndex] };
+	Vec3 displacement = ray.m_start - Vec3(m_centerX[blockIndex], m_centerY[blockIndex], m_centerZ[blockIndex]);
+
+	// Slab test in block local space, remembering which face the ray entered through
+	float enterDist = 0.f;
+	float exitDist = ray.m_maxDist;
+	Vec3 enterNormal = -ray.m_fwdNormal;
+	for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
+	{
+		float localStart = DotProduct3D(displacement, axes[axisIndex]);
+		float localFwd = DotProduct3D(ray.m_fwdNormal, axes[axisIndex]);
+
+		if (fabsf(localFwd) < 1e-8f)
+		{
+			if (localStart < -halfDims[axisIndex] || localStart > halfDims[axisIndex])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		float oneOverFwd = 1.f / localFwd;
+		float nearDist = (-halfDims[axisIndex] - localStart) * oneOverFwd;
+		float farDist = (halfDims[axisIndex] - localStart) * oneOverFwd;
+		Vec3 nearNormal = -axes[axisIndex];
+		if (nearDist > farDist)
+		{
+			float swapDist = nearDist;
+			nearDist = farDist;
+			farDist = swapDist;
+			nearNormal = axes[axisIndex];
+		}
+
+		if (nearDist > enterDist)
+		{
+			enterDist = nearDist;
+			enterNormal = nearNormal;
+		}
+		exitDist = fminf(exitDist, farDist);
+		if (enterDist > exitDist)
+		{
+			return false;
+		}
+	}
+
+	out_impactDist = enterDist;
+	out_impactNormal = enterNormal;
+	return true;
+}
+
+void LevelBlocks::RemovePadding()
+{
+	int paddedCount = static_cast<int>(m_centerX.size());
+	if (paddedCount == m_numBlocks)
+	{
+		return;
+	}
+
+	m_centerX.resize(m_numBlocks);
+	m_centerY.resize(m_numBlocks);
+	m_centerZ.resize(m_numBlocks);
+	m_iBasisX.resize(m_numBlocks);
+	m_iBasisY.resize(m_numBlocks);
+	m_iBasisZ.resize(m_numBlocks);
+	m_jBasisX.resize(m_numBlocks);
+	m_jBasisY.resize(m_numBlocks);
+	m_jBasisZ.resize(m_numBlocks);
+	m_kBasisX.resize(m_numBlocks);
+	m_kBasisY.resize(m_numBlocks);
+	m_kBasisZ.resize(m_numBlocks);
+	m_halfDimX.resize(m_numBlocks);
+	m_halfDimY.resize(m_numBlocks);
+	m_halfDimZ.resize(m_numBlocks);
+}
+
+void LevelBlocks::AddPadding()
+{
+	// Padding lanes are masked off by the caller, zeroes keep the math finite
+	int paddedCount = m_numBlocks + BLOCK_SIMD_WIDTH - 1;
+	m_centerX.resize(paddedCount, 0.f);
+	m_centerY.resize(paddedCount, 0.f);
+	m_centerZ.resize(paddedCount, 0.f);
+	m_iBasisX.resize(paddedCount, 0.f);
+	m_iBasisY.resize(paddedCount, 0.f);
+	m_iBasisZ.resize(paddedCount, 0.f);
+	m_jBasisX.resize(paddedCount, 0.f);
+	m_jBasisY.resize(paddedCount, 0.f);
+	m_jBasisZ.resize(paddedCount, 0.f);
+	m_kBasisX.resize(paddedCount, 0.f);
+	m_kBasisY.resize(paddedCount, 0.f);
+	m_kBasisZ.resize(paddedCount, 0.f);
+	m_halfDimX.resize(paddedCount, 0.f);
+	m_halfDimY.resize(paddedCount, 0.f);
+	m_halfDimZ.resize(paddedCount, 0.f);
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/OBB3.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Core/Rgba8.h"
+#include <vector>
+// -----------------------------------------------------------------------------
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#define LEVEL_BLOCKS_USE_SSE
+#endif
+// -----------------------------------------------------------------------------
+constexpr int BLOCK_SIMD_WIDTH = 4;
+constexpr int NUM_BLOCK_FLOAT_ARRAYS = 15;		// Center, three basis vectors and half dimensions, one array per component
+// -----------------------------------------------------------------------------
+struct BlockRay
+{
+	Vec3  m_start = Vec3::ZERO;
+	Vec3  m_fwdNormal = Vec3::XAXE;
+	float m_maxDist = 0.f;
+};
+// -----------------------------------------------------------------------------
+// Structure-of-arrays storage for level blocks. Every array is padded with
+// BLOCK_SIMD_WIDTH - 1 trailing entries so a batch can always be loaded whole.
+// -----------------------------------------------------------------------------
+struct LevelBlocks
+{
+	void  AddBlock(Vec3 const& center, Vec3 const& dimensions, EulerAngles const& orientation, Rgba8 const& color);
+	void  Reorder(std::vector<int> const& newOrder);
+	void  Clear();
+
+	// Whole-array access for cooking, arrays are in the order the cooked format stores them
+	std::vector<float> const& GetFloatArray(int arrayIndex) const;
+	void  AssignArrays(int numBlocks, float const* const floatArrays[NUM_BLOCK_FLOAT_ARRAYS], Rgba8 const* colors, EulerAngles const* orientations);
+
+	int   GetNumBlocks() const;
+	size_t GetMemoryBytes() const;
+	OBB3  GetBlockBounds(int blockIndex) const;
+	AABB3 GetBlockWorldBounds(int blockIndex) const;
+	Rgba8 GetBlockColor(int blockIndex) const;
+
+	unsigned int GetZCylinderOverlapMask(int firstBlock, int blockCount, Vec3 const& cylinderCenter, float radius, float halfHeight) const;
+	bool  GetZCylinderPenetration(int blockIndex, Vec3 const& cylinderCenter, float radius, float halfHeight, Vec3& out_pushNormal, float& out_pushDepth) const;
+	bool  RaycastBlock(int blockIndex, BlockRay const& ray, float& out_impactDist, Vec3& out_impactNormal) const;
+
+private:
+	void  RemovePadding();
+	void  AddPadding();
+
+public:
+	int m_numBlocks = 0;
+
+	std::vector<float> m_centerX;
+	std::vector<float> m_centerY;
+	std::vector<float> m_centerZ;
+
+	std::vector<float> m_iBasisX;
+	std::vector<float> m_iBasisY;
+	std::vector<float> m_iBasisZ;
+	std::vector<float> m_jBasisX;
+	std::vector<float> m_jBasisY;
+	std::vector<float> m_jBasisZ;
+	std::vector<float> m_kBasisX;
+	std::vector<float> m_kBasisY;
+	std::vector<float> m_kBasisZ;
+
+	std::vector<float> m_halfDimX;
+	std::vector<float> m_halfDimY;
+	std::vector<float> m_halfDimZ;
+
+	std::vector<Rgba8> m_colors;
+	std::vector<EulerAngles> m_orientations;
+};
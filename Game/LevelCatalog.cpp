@@ -0,0 +1,239 @@
+#include "Game/LevelCatalog.hpp"
+#include "Game/Level.hpp"
+#include "Game/LevelDefinition.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <algorithm>
+// -----------------------------------------------------------------------------
+LevelCatalog::LevelCatalog(Game* owner, std::vector<std::string> const& levelNames, size_t memoryBudgetBytes)
+	:m_theGame(owner),
+	 m_entries(levelNames.size()),
+	 m_memoryBudgetBytes(memoryBudgetBytes)
+{
+	for (int levelIndex = 0; levelIndex < static_cast<int>(levelNames.size()); ++levelIndex)
+	{
+		m_entries[levelIndex].m_levelDef = LevelDefinition::GetLevelByName(levelNames[levelIndex]);
+		GUARANTEE_OR_DIE(m_entries[levelIndex].m_levelDef != nullptr, Stringf("No level definition named \"%s\"", levelNames[levelIndex].c_str()));
+	}
+
+	m_workerThread = std::thread(&LevelCatalog::WorkerThreadMain, this);
+}
+
+LevelCatalog::~LevelCatalog()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_requestMutex);
+		m_isQuitting = true;
+	}
+	m_requestCondition.notify_all();
+	m_workerThread.join();
+
+	for (LevelCatalogEntry& entry : m_entries)
+	{
+		delete entry.m_level;
+		entry.m_level = nullptr;
+	}
+}
+
+void LevelCatalog::Update()
+{
+	for (LevelCatalogEntry& entry : m_entries)
+	{
+		if (entry.m_state.load() == LevelLoadState::READY_TO_UPLOAD)
+		{
+			FinishLevel(entry);
+		}
+	}
+}
+
+Level* LevelCatalog::AcquireLevel(int levelIndex)
+{
+	LevelCatalogEntry& entry = m_entries[levelIndex];
+	if (entry.m_state.load() == LevelLoadState::LOADING)
+	{
+		std::unique_lock<std::mutex> lock(m_requestMutex);
+		std::deque<int>::iterator requestIter = std::find(m_requestedLevels.begin(), m_requestedLevels.end(), levelIndex);
+		if (requestIter != m_requestedLevels.end())
+		{
+			// Still queued, building it here is quicker than waiting behind the rest of the queue
+			m_requestedLevels.erase(requestIter);
+			entry.m_state.store(LevelLoadState::UNLOADED);
+		}
+		else
+		{
+			m_loadedCondition.wait(lock, [&entry]() { return entry.m_state.load() != LevelLoadState::LOADING; });
+		}
+	}
+
+	if (entry.m_state.load() == LevelLoadState::UNLOADED)
+	{
+		entry.m_level = new Level(m_theGame, entry.m_levelDef);
+		entry.m_state.store(LevelLoadState::READY_TO_UPLOAD);
+	}
+	if (entry.m_state.load() == LevelLoadState::READY_TO_UPLOAD)
+	{
+		FinishLevel(entry);
+	}
+	else if (!entry.m_level->HasBuffers())
+	{
+		// Evicted over budget earlier, collision survived so only render data is rebuilt
+		FinishLevel(entry);
+	}
+
+	m_playTick++;
+	entry.m_lastPlayedTick = m_playTick;
+	return entry.m_level;
+}
+
+void LevelCatalog::PrefetchLevel(int levelIndex)
+{
+	if (levelIndex < 0 || levelIndex >= GetNumLevels())
+	{
+		return;
+	}
+
+	LevelCatalogEntry& entry = m_entries[levelIndex];
+	if (entry.m_state.load() != LevelLoadState::UNLOADED)
+	{
+		return;
+	}
+
+	entry.m_state.store(LevelLoadState::LOADING);
+	{
+		std::lock_guard<std::mutex> lock(m_requestMutex);
+		m_requestedLevels.push_back(levelIndex);
+	}
+	m_requestCondition.notify_one();
+}
+
+void LevelCatalog::EnforceMemoryBudget(int keepLevelIndex, int keepOtherLevelIndex)
+{
+	while (GetTotalMemoryBytes() > m_memoryBudgetBytes)
+	{
+		// GPU buffers go first since they are the cheapest to rebuild
+		int levelIndex = FindLeastRecentlyPlayed(keepLevelIndex, keepOtherLevelIndex, true);
+		if (levelIndex >= 0)
+		{
+			m_entries[levelIndex].m_level->ClearBuffers();
+			continue;
+		}
+
+		levelIndex = FindLeastRecentlyPlayed(keepLevelIndex, keepOtherLevelIndex, false);
+		if (levelIndex < 0)
+		{
+			return;
+		}
+		LevelCatalogEntry& entry = m_entries[levelIndex];
+		delete entry.m_level;
+		entry.m_level = nullptr;
+		entry.m_state.store(LevelLoadState::UNLOADED);
+	}
+}
+
+int LevelCatalog::GetNumLevels() const
+{
+	return static_cast<int>(m_entries.size());
+}
+
+bool LevelCatalog::IsLevelResident(int levelIndex) const
+{
+	return m_entries[levelIndex].m_state.load() == LevelLoadState::RESIDENT;
+}
+
+LevelDefinition const* LevelCatalog::GetLevelDefinition(int levelIndex) const
+{
+	return m_entries[levelIndex].m_levelDef;
+}
+
+LevelLoadState LevelCatalog::GetLevelState(int levelIndex) const
+{
+	return m_entries[levelIndex].m_state.load();
+}
+
+LevelMemoryUsage LevelCatalog::GetLevelMemoryUsage(int levelIndex) const
+{
+	LevelCatalogEntry const& entry = m_entries[levelIndex];
+	LevelLoadState state = entry.m_state.load();
+	if (state == LevelLoadState::READY_TO_UPLOAD || state == LevelLoadState::RESIDENT)
+	{
+		return entry.m_level->GetMemoryUsage();
+	}
+	return LevelMemoryUsage();
+}
+
+size_t LevelCatalog::GetTotalMemoryBytes() const
+{
+	size_t totalBytes = 0;
+	for (int levelIndex = 0; levelIndex < GetNumLevels(); ++levelIndex)
+	{
+		totalBytes += GetLevelMemoryUsage(levelIndex).GetTotalBytes();
+	}
+	return totalBytes;
+}
+
+size_t LevelCatalog::GetMemoryBudgetBytes() const
+{
+	return m_memoryBudgetBytes;
+}
+
+void LevelCatalog::FinishLevel(LevelCatalogEntry& entry)
+{
+	entry.m_level->CreateBuffers();
+	entry.m_level->ReleaseCPUGeometry();
+	entry.m_state.store(LevelLoadState::RESIDENT);
+}
+
+int LevelCatalog::FindLeastRecentlyPlayed(int keepLevelIndex, int keepOtherLevelIndex, bool needsBuffers) const
+{
+	// A level still on the worker is left to finish, a later pass can evict it
+	int lruIndex = -1;
+	for (int levelIndex = 0; levelIndex < GetNumLevels(); ++levelIndex)
+	{
+		LevelCatalogEntry const& entry = m_entries[levelIndex];
+		if (levelIndex == keepLevelIndex || levelIndex == keepOtherLevelIndex)
+		{
+			continue;
+		}
+		LevelLoadState state = entry.m_state.load();
+		if (state != LevelLoadState::READY_TO_UPLOAD && state != LevelLoadState::RESIDENT)
+		{
+			continue;
+		}
+		if (needsBuffers && !entry.m_level->HasBuffers())
+		{
+			continue;
+		}
+		if (lruIndex < 0 || entry.m_lastPlayedTick < m_entries[lruIndex].m_lastPlayedTick)
+		{
+			lruIndex = levelIndex;
+		}
+	}
+	return lruIndex;
+}
+
+void LevelCatalog::WorkerThreadMain()
+{
+	for (;;)
+	{
+		int levelIndex = -1;
+		{
+			std::unique_lock<std::mutex> lock(m_requestMutex);
+			m_requestCondition.wait(lock, [this]() { return m_isQuitting || !m_requestedLevels.empty(); });
+			if (m_isQuitting)
+			{
+				return;
+			}
+			levelIndex = m_requestedLevels.front();
+			m_requestedLevels.pop_front();
+		}
+
+		// The main thread leaves a LOADING entry alone until the state flips below
+		LevelCatalogEntry& entry = m_entries[levelIndex];
+		entry.m_level = new Level(m_theGame, entry.m_levelDef);
+		{
+			std::lock_guard<std::mutex> lock(m_requestMutex);
+			entry.m_state.store(LevelLoadState::READY_TO_UPLOAD);
+		}
+		m_loadedCondition.notify_all();
+	}
+}
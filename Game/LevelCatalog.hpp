@@ -0,0 +1,83 @@
+#pragma once
+#include "Game/GameCommon.h"
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+// -----------------------------------------------------------------------------
+class Level;
+struct LevelDefinition;
+struct LevelMemoryUsage;
+// -----------------------------------------------------------------------------
+enum class LevelLoadState
+{
+	UNLOADED,
+	LOADING,			// Owned by the worker thread
+	READY_TO_UPLOAD,	// Layout, collision and block records built, waiting for its GPU buffers
+	RESIDENT
+};
+// -----------------------------------------------------------------------------
+struct LevelCatalogEntry
+{
+	LevelDefinition* m_levelDef = nullptr;
+	Level*			 m_level = nullptr;
+	uint64_t		 m_lastPlayedTick = 0;
+	std::atomic<LevelLoadState> m_state{ LevelLoadState::UNLOADED };
+};
+// -----------------------------------------------------------------------------
+// The campaign levels, built only when first asked for. A worker thread
+// prefetches the level most likely to be played next, the main thread only
+// creates its buffers once it is ready, so switching to it costs nothing.
+//
+// Loaded levels keep collision and GPU buffers but drop their CPU render data
+// once uploaded. Past the memory budget, the least recently played levels
+// lose their GPU buffers first and are unloaded entirely after that. Either
+// way AcquireLevel rebuilds them, so startup time and memory no longer grow
+// with the number of levels.
+// -----------------------------------------------------------------------------
+class LevelCatalog
+{
+public:
+	LevelCatalog(Game* owner, std::vector<std::string> const& levelNames, size_t memoryBudgetBytes);
+	~LevelCatalog();
+
+	// Uploads levels the worker has finished, call once a frame on the main thread
+	void Update();
+
+	// Builds the level right away if the worker has not got to it yet
+	Level* AcquireLevel(int levelIndex);
+	void   PrefetchLevel(int levelIndex);
+
+	// Evicts least recently played levels until under budget, never the two given, -1 protects none
+	void EnforceMemoryBudget(int keepLevelIndex, int keepOtherLevelIndex);
+
+	int  GetNumLevels() const;
+	bool IsLevelResident(int levelIndex) const;
+	LevelDefinition const* GetLevelDefinition(int levelIndex) const;
+	LevelLoadState GetLevelState(int levelIndex) const;
+	LevelMemoryUsage GetLevelMemoryUsage(int levelIndex) const;		// Zero while the worker owns the level
+	size_t GetTotalMemoryBytes() const;
+	size_t GetMemoryBudgetBytes() const;
+
+private:
+	void FinishLevel(LevelCatalogEntry& entry);
+	int  FindLeastRecentlyPlayed(int keepLevelIndex, int keepOtherLevelIndex, bool needsBuffers) const;
+	void WorkerThreadMain();
+
+private:
+	Game* m_theGame = nullptr;
+	std::vector<LevelCatalogEntry> m_entries;
+	size_t	 m_memoryBudgetBytes = 0;
+	uint64_t m_playTick = 0;
+
+	std::thread				m_workerThread;
+	std::mutex				m_requestMutex;
+	std::condition_variable m_requestCondition;
+	std::condition_variable m_loadedCondition;
+	std::deque<int>			m_requestedLevels;
+	bool					m_isQuitting = false;
+};
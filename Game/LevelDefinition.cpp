@@ -1,9 +1,10 @@
 #include "Game/LevelDefinition.hpp"
+#include "Game/CookedLevel.hpp"
 #include "Game/GameCommon.h"
 #include "Engine/Core/ErrorWarningAssert.hpp"
-#include "Engine/Renderer/Renderer.h"
 // -----------------------------------------------------------------------------
 std::vector<LevelDefinition*> LevelDefinition::s_levelDefinitions;
+static CookedLevelFile s_cookedLevelFile;
 // -----------------------------------------------------------------------------
 SpawnInfo::SpawnInfo(XmlElement const& spawnElement)
 {
@@ -20,16 +21,8 @@ LevelDefinition::LevelDefinition(XmlElement const& levelDefElement)
 	// Parsing name
 	m_levelName = ParseXmlAttribute(levelDefElement, "name", m_levelName);
 
-	// Parsing shader
-	std::string shader = ParseXmlAttribute(levelDefElement, "shader", shader);
-	if (shader == "Default")
-	{
-		m_shader = nullptr;
-	}
-	else
-	{
-		m_shader = g_theRenderer->CreateShader(shader.c_str(), VertexType::VERTEX_PCUTBN);
-	}
+	// Parsing shader, only the name so definitions load without a renderer
+	m_shaderName = ParseXmlAttribute(levelDefElement, "shader", m_shaderName);
 
 	// Parsing spawn info
 	XmlElement const* spawnInfosElement = levelDefElement.FirstChildElement("SpawnInfos");
@@ -43,10 +36,25 @@ LevelDefinition::LevelDefinition(XmlElement const& levelDefElement)
 	}
 }
 
+LevelDefinition::LevelDefinition(CookedLevelView const* cookedLevel)
+	:m_cookedLevel(cookedLevel)
+{
+	m_levelName = cookedLevel->m_entry->m_levelName;
+	m_shaderName = cookedLevel->m_entry->m_shaderName;
+}
+
 void LevelDefinition::InitializeLevelDefinitions()
+{
+	if (!InitializeLevelDefinitionsFromCooked())
+	{
+		InitializeLevelDefinitionsFromXml();
+	}
+}
+
+void LevelDefinition::InitializeLevelDefinitionsFromXml()
 {
 	XmlDocument levelDefsXml;
-	char const* filePath = "Data/Definitions/LevelDefinitions.xml";
+	char const* filePath = LEVEL_DEFINITIONS_XML_PATH;
 	XmlError result = levelDefsXml.LoadFile(filePath);
 	GUARANTEE_OR_DIE(result == tinyxml2::XML_SUCCESS, Stringf("Failed to open required level definitions file \"%s\"", filePath));
 
@@ -64,9 +72,24 @@ void LevelDefinition::InitializeLevelDefinitions()
 	}
 }
 
+bool LevelDefinition::InitializeLevelDefinitionsFromCooked()
+{
+	// Mapped and used in place, the file stays open until ClearLevelDefinitions
+	if (!s_cookedLevelFile.Open(LEVEL_DEFINITIONS_COOKED_PATH, LEVEL_DEFINITIONS_XML_PATH))
+	{
+		return false;
+	}
+	for (int levelIndex = 0; levelIndex < s_cookedLevelFile.GetNumLevels(); ++levelIndex)
+	{
+		s_levelDefinitions.push_back(new LevelDefinition(s_cookedLevelFile.GetLevel(levelIndex)));
+	}
+	return true;
+}
+
 void LevelDefinition::ClearLevelDefinitions()
 {
 	s_levelDefinitions.clear();
+	s_cookedLevelFile.Close();
 }
 
 LevelDefinition* LevelDefinition::GetLevelByName(std::string const& name)
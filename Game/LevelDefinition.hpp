@@ -1,10 +1,14 @@
 #pragma once
 #include "Engine/Core/XmlUtils.hpp"
 // -----------------------------------------------------------------------------
-class Shader;
+struct CookedLevelView;
+// -----------------------------------------------------------------------------
+constexpr char const* LEVEL_DEFINITIONS_XML_PATH = "Data/Definitions/LevelDefinitions.xml";
+constexpr char const* LEVEL_DEFINITIONS_COOKED_PATH = "Data/Definitions/LevelDefinitions.cooked";
 // -----------------------------------------------------------------------------
 struct SpawnInfo
 {
+	SpawnInfo() = default;
 	SpawnInfo(XmlElement const& spawnElement);
 	
 	std::string m_levelItem = "default";
@@ -17,14 +21,19 @@ struct SpawnInfo
 // -----------------------------------------------------------------------------
 struct LevelDefinition
 {
+	LevelDefinition() = default;
 	LevelDefinition(XmlElement const& levelDefElement);
+	LevelDefinition(CookedLevelView const* cookedLevel);
 	static std::vector<LevelDefinition*> s_levelDefinitions;
-	static void InitializeLevelDefinitions();
+	static void InitializeLevelDefinitions();			// Cooked file when there is one, XML otherwise
+	static void InitializeLevelDefinitionsFromXml();
+	static bool InitializeLevelDefinitionsFromCooked();
 	static void ClearLevelDefinitions();
 	static LevelDefinition* GetLevelByName(std::string const& name);
 // -----------------------------------------------------------------------------
 	std::string m_levelName = "default";
-	Shader* m_shader = nullptr;
+	std::string m_shaderName = "Default";
 	std::vector<SpawnInfo> m_itemSpawnInfo;
+	CookedLevelView const* m_cookedLevel = nullptr;		// Cooked levels have no spawn infos, they lay out straight from this
 };
 // -----------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,457 @@
+#include "Game/SimLevel.hpp"
+#include "Game/SimRunner.hpp"
+#include "Game/InputRecording.hpp"
+#include "Game/SimBatch.hpp"
+#include "Game/WorkStealingPool.hpp"
+#include "Game/LevelDefinition.hpp"
+#include "Game/CookedLevel.hpp"
+#include "Game/ShaderCache.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+// -----------------------------------------------------------------------------
+// Console entry point that runs the gameplay simulation with no window, renderer,
+// input or audio. Run from the Run folder so Data/ paths resolve.
+// -----------------------------------------------------------------------------
+struct HeadlessOptions
+{
+	std::string m_levelName;
+	std::string m_playerName;
+	std::string m_recordPath;
+	std::string m_replayPath;
+	std::string m_cookPath;
+	std::string m_shaderCacheCheckFolder;
+	int   m_numTicks = 0;			// 0 runs the whole replay, or DEFAULT_HEADLESS_TICKS without one
+	float m_simulationHz = 0.f;
+	int   m_jumpInterval = 60;		// Ticks between scripted jump presses, 0 never jumps
+	int   m_jumpSpread = 0;			// Runner N jumps every m_jumpInterval + (N % (m_jumpSpread + 1)) ticks
+	int   m_respawnInterval = 0;	// Ticks between scripted respawn presses, 0 never respawns
+	int   m_numRunners = 1;
+	int   m_numThreads = 0;			// 0 uses every hardware thread
+};
+// -----------------------------------------------------------------------------
+constexpr int	DEFAULT_HEADLESS_TICKS = 1000000;
+constexpr float DEFAULT_HEADLESS_HZ = 120.f;
+// -----------------------------------------------------------------------------
+static void PrintUsage()
+{
+	printf("Usage: RunnerHeadless [--level <name>] [--player <name>] [--ticks <count>] [--hz <rate>] [--jump-every <ticks>]\n");
+	printf("                      [--respawn-every <ticks>] [--record <file>] [--replay <file>]\n");
+	printf("                      [--runners <count>] [--threads <count>] [--jump-spread <ticks>]\n");
+	printf("       RunnerHeadless --cook <file>\n");
+	printf("       RunnerHeadless --check-shader-cache <folder>\n");
+	printf("--player takes a comma separated list, batch runners cycle through it.\n");
+	printf("A replay supplies the level, player and rate it was recorded with unless they are given explicitly.\n");
+	printf("Replaying a whole recording as it was made checks the trajectory hash stored with it, the exit code is 1 on a mismatch.\n");
+	printf("--cook writes %s as a binary file the game and this runner load in place of the XML.\n", LEVEL_DEFINITIONS_XML_PATH);
+	printf("--check-shader-cache runs the shader bytecode cache against a stub compiler in <folder>, the exit code is 1 on a failure.\n");
+}
+
+static bool ParseCommandLine(int argc, char** argv, HeadlessOptions& out_options)
+{
+	for (int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		char const* arg = argv[argIndex];
+		char const* value = (argIndex + 1 < argc) ? argv[argIndex + 1] : nullptr;
+		if (value == nullptr)
+		{
+			return false;
+		}
+
+		if (strcmp(arg, "--level") == 0)
+		{
+			out_options.m_levelName = value;
+		}
+		else if (strcmp(arg, "--player") == 0)
+		{
+			out_options.m_playerName = value;
+		}
+		else if (strcmp(arg, "--ticks") == 0)
+		{
+			out_options.m_numTicks = atoi(value);
+		}
+		else if (strcmp(arg, "--hz") == 0)
+		{
+			out_options.m_simulationHz = static_cast<float>(atof(value));
+		}
+		else if (strcmp(arg, "--jump-every") == 0)
+		{
+			out_options.m_jumpInterval = atoi(value);
+		}
+		else if (strcmp(arg, "--respawn-every") == 0)
+		{
+			out_options.m_respawnInterval = atoi(value);
+		}
+		else if (strcmp(arg, "--record") == 0)
+		{
+			out_options.m_recordPath = value;
+		}
+		else if (strcmp(arg, "--replay") == 0)
+		{
+			out_options.m_replayPath = value;
+		}
+		else if (strcmp(arg, "--runners") == 0)
+		{
+			out_options.m_numRunners = atoi(value);
+		}
+		else if (strcmp(arg, "--threads") == 0)
+		{
+			out_options.m_numThreads = atoi(value);
+		}
+		else if (strcmp(arg, "--jump-spread") == 0)
+		{
+			out_options.m_jumpSpread = atoi(value);
+		}
+		else if (strcmp(arg, "--cook") == 0)
+		{
+			out_options.m_cookPath = value;
+		}
+		else if (strcmp(arg, "--check-shader-cache") == 0)
+		{
+			out_options.m_shaderCacheCheckFolder = value;
+		}
+		else
+		{
+			return false;
+		}
+		++argIndex;
+	}
+	if (out_options.m_numRunners > 1 && !out_options.m_recordPath.empty())
+	{
+		return false;
+	}
+	return out_options.m_numTicks >= 0 && out_options.m_simulationHz >= 0.f && out_options.m_jumpInterval >= 0 && out_options.m_respawnInterval >= 0 &&
+		out_options.m_jumpSpread >= 0 && out_options.m_numRunners > 0 && out_options.m_numThreads >= 0;
+}
+
+static std::vector<std::string> SplitPlayerNames(std::string const& playerNames)
+{
+	std::vector<std::string> names;
+	size_t start = 0;
+	while (start <= playerNames.size())
+	{
+		size_t comma = playerNames.find(',', start);
+		if (comma == std::string::npos)
+		{
+			comma = playerNames.size();
+		}
+		if (comma > start)
+		{
+			names.push_back(playerNames.substr(start, comma - start));
+		}
+		start = comma + 1;
+	}
+	return names;
+}
+// -----------------------------------------------------------------------------
+static int CookLevels(HeadlessOptions const& options)
+{
+	// Always cooks from the authoring XML, never from an older cooked file
+	LevelDefinition::InitializeLevelDefinitionsFromXml();
+	bool wasCooked = CookLevelDefinitions(LevelDefinition::s_levelDefinitions, LEVEL_DEFINITIONS_XML_PATH, options.m_cookPath.c_str());
+	if (wasCooked)
+	{
+		printf("Cooked %d levels into %s\n", static_cast<int>(LevelDefinition::s_levelDefinitions.size()), options.m_cookPath.c_str());
+	}
+	else
+	{
+		printf("Could not cook levels into \"%s\"\n", options.m_cookPath.c_str());
+	}
+	LevelDefinition::ClearLevelDefinitions();
+	return wasCooked ? 0 : 1;
+}
+// -----------------------------------------------------------------------------
+// Stands in for a real backend, the bytecode is the stage's inputs so a wrong
+// hit shows up as different bytes
+// -----------------------------------------------------------------------------
+class StubShaderCompiler : public ShaderCompiler
+{
+public:
+	char const* GetCompilerId() const override
+	{
+		return "stub-1";
+	}
+
+	bool CompileStage(std::string const& source, char const* sourceName, char const* entryPoint, char const* target, std::vector<unsigned char>& out_bytecode) override
+	{
+		(void)sourceName;
+		std::string bytecode = std::string(entryPoint) + "|" + target + "|" + source;
+		out_bytecode.assign(bytecode.begin(), bytecode.end());
+		m_numCompiles++;
+		return true;
+	}
+
+	int m_numCompiles = 0;
+};
+
+static bool CheckShaderCacheStep(char const* stepName, bool isPassing)
+{
+	printf("%-48s %s\n", stepName, isPassing ? "ok" : "FAILED");
+	return isPassing;
+}
+
+static int CheckShaderCache(HeadlessOptions const& options)
+{
+	std::string cacheFolder = options.m_shaderCacheCheckFolder;
+	if (cacheFolder.back() != '/' && cacheFolder.back() != '\\')
+	{
+		cacheFolder += "/";
+	}
+	std::string const source = "float4 PixelMain() : SV_Target { return float4(1, 1, 1, 1); }\n";
+	std::vector<ShaderDefine> defines = { { "USE_FOG", "1" } };
+	std::string const definedSource = ShaderBytecodeCache::ApplyDefines(source, defines);
+
+	// Only the files for this check's keys are touched, anything else in the folder is left alone
+	StubShaderCompiler compiler;
+	ShaderBytecodeCache coldCache(compiler, cacheFolder);
+	uint64_t key = coldCache.GetKey(source, "PixelMain", "ps_5_0");
+	uint64_t definedKey = coldCache.GetKey(definedSource, "PixelMain", "ps_5_0");
+	std::error_code errorCode;
+	std::filesystem::remove(coldCache.GetCacheFilePath(key), errorCode);
+	std::filesystem::remove(coldCache.GetCacheFilePath(definedKey), errorCode);
+
+	bool isPassing = true;
+	std::vector<unsigned char> expected;
+	std::vector<unsigned char> bytecode;
+	coldCache.GetBytecode(source, "Check.hlsl", "PixelMain", "ps_5_0", expected);
+	isPassing &= CheckShaderCacheStep("Cold cache compiles", compiler.m_numCompiles == 1);
+	coldCache.GetBytecode(source, "Check.hlsl", "PixelMain", "ps_5_0", bytecode);
+	isPassing &= CheckShaderCacheStep("Second request hits memory", compiler.m_numCompiles == 1 && coldCache.GetStats().m_numMemoryHits == 1 && bytecode == expected);
+	isPassing &= CheckShaderCacheStep("Entry point and target are part of the key", coldCache.GetKey(source, "VertexMain", "vs_5_0") != key);
+	isPassing &= CheckShaderCacheStep("Defines are part of the key", definedKey != key);
+
+	// A new cache stands in for the next run, it should only find the file
+	ShaderBytecodeCache warmCache(compiler, cacheFolder);
+	warmCache.GetBytecode(source, "Check.hlsl", "PixelMain", "ps_5_0", bytecode);
+	isPassing &= CheckShaderCacheStep("Warm cache reads the disk", compiler.m_numCompiles == 1 && warmCache.GetStats().m_numDiskHits == 1 && bytecode == expected);
+	warmCache.GetBytecode(definedSource, "Check.hlsl", "PixelMain", "ps_5_0", bytecode);
+	isPassing &= CheckShaderCacheStep("Changed defines compile again", compiler.m_numCompiles == 2 && bytecode != expected);
+
+	// Cut the file short as a crash mid write would, it must read as a miss
+	std::filesystem::resize_file(coldCache.GetCacheFilePath(key), 8, errorCode);
+	ShaderBytecodeCache tornCache(compiler, cacheFolder);
+	tornCache.GetBytecode(source, "Check.hlsl", "PixelMain", "ps_5_0", bytecode);
+	isPassing &= CheckShaderCacheStep("Torn cache file is a miss", compiler.m_numCompiles == 3 && tornCache.GetStats().m_numDiskHits == 0 && bytecode == expected);
+
+	std::filesystem::remove(coldCache.GetCacheFilePath(key), errorCode);
+	std::filesystem::remove(coldCache.GetCacheFilePath(definedKey), errorCode);
+	printf("Shader cache check %s\n", isPassing ? "passed" : "FAILED");
+	return isPassing ? 0 : 1;
+}
+// -----------------------------------------------------------------------------
+static int RunBatch(HeadlessOptions const& options, SimLevel const& level, std::vector<SimRunnerParams> const& playerParams, InputRecording const* replayRecording)
+{
+	int numThreads = options.m_numThreads;
+	if (numThreads == 0)
+	{
+		numThreads = static_cast<int>(std::thread::hardware_concurrency());
+	}
+	WorkStealingPool pool(numThreads);
+
+	SimRunnerBatch batch;
+	for (SimRunnerParams const& params : playerParams)
+	{
+		batch.AddRunnerParams(params);
+	}
+	for (int runnerIndex = 0; runnerIndex < options.m_numRunners; ++runnerIndex)
+	{
+		int paramsIndex = runnerIndex % static_cast<int>(playerParams.size());
+		if (replayRecording)
+		{
+			batch.AddReplayRunner(paramsIndex, replayRecording);
+		}
+		else
+		{
+			int jumpInterval = (options.m_jumpInterval > 0) ? options.m_jumpInterval + (runnerIndex % (options.m_jumpSpread + 1)) : 0;
+			batch.AddScriptedRunner(paramsIndex, jumpInterval);
+		}
+	}
+
+	float tickSeconds = 1.f / options.m_simulationHz;
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	batch.Simulate(level, options.m_numTicks, tickSeconds, pool);
+	std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+
+	double elapsedSeconds = std::chrono::duration<double>(endTime - startTime).count();
+	double runnerTicks = static_cast<double>(options.m_numTicks) * static_cast<double>(options.m_numRunners);
+	double runnerTicksPerSecond = (elapsedSeconds > 0.0) ? runnerTicks / elapsedSeconds : 0.0;
+	printf("Level %s, players %s, %d blocks\n", options.m_levelName.c_str(), options.m_playerName.c_str(), level.GetBlocks().GetNumBlocks());
+	printf("Runners: %d on %d threads, %d ticks each at %0.0f Hz\n", options.m_numRunners, pool.GetNumThreads(), options.m_numTicks, options.m_simulationHz);
+	printf("Deaths: %d, Completions: %d, Furthest X: %0.2f\n", batch.GetTotalDeaths(), batch.GetTotalCompletions(), batch.GetFurthestX());
+	printf("Combined trajectory hash: %016llx\n", static_cast<unsigned long long>(batch.GetCombinedTrajectoryHash()));
+	printf("Wall time: %0.3f s, %0.0f runner-ticks/s\n", elapsedSeconds, runnerTicksPerSecond);
+	return 0;
+}
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	HeadlessOptions options;
+	if (!ParseCommandLine(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+	if (!options.m_cookPath.empty())
+	{
+		return CookLevels(options);
+	}
+	if (!options.m_shaderCacheCheckFolder.empty())
+	{
+		return CheckShaderCache(options);
+	}
+
+	// Fill anything not given on the command line from the replay, then from defaults
+	InputRecording replayRecording;
+	InputReplayCursor replayCursor;
+	bool isReplaying = !options.m_replayPath.empty();
+	bool isReplayingAsRecorded = false;
+	if (isReplaying)
+	{
+		if (!replayRecording.LoadFromFile(options.m_replayPath.c_str()))
+		{
+			printf("Could not read input recording \"%s\"\n", options.m_replayPath.c_str());
+			return 1;
+		}
+
+		// Only an unchanged replay of every recorded tick is expected to reach the recorded hash
+		isReplayingAsRecorded = replayRecording.m_hasTrajectoryHash &&
+			(options.m_levelName.empty() || options.m_levelName == replayRecording.m_levelName) &&
+			(options.m_playerName.empty() || options.m_playerName == replayRecording.m_playerName) &&
+			(options.m_simulationHz == 0.f || options.m_simulationHz == replayRecording.m_simulationHz) &&
+			(options.m_numTicks == 0 || options.m_numTicks == replayRecording.GetNumTicks()) &&
+			options.m_numRunners == 1;
+		if (options.m_levelName.empty())	options.m_levelName = replayRecording.m_levelName;
+		if (options.m_playerName.empty())	options.m_playerName = replayRecording.m_playerName;
+		if (options.m_simulationHz == 0.f)	options.m_simulationHz = replayRecording.m_simulationHz;
+		if (options.m_numTicks == 0)		options.m_numTicks = replayRecording.GetNumTicks();
+		replayCursor.Reset(&replayRecording);
+	}
+	if (options.m_levelName.empty())	options.m_levelName = "LevelOne";
+	if (options.m_playerName.empty())	options.m_playerName = "Runner";
+	if (options.m_simulationHz == 0.f)	options.m_simulationHz = DEFAULT_HEADLESS_HZ;
+	if (options.m_numTicks == 0)		options.m_numTicks = DEFAULT_HEADLESS_TICKS;
+
+	LevelDefinition::InitializeLevelDefinitions();
+	LevelDefinition* levelDef = LevelDefinition::GetLevelByName(options.m_levelName);
+	if (levelDef == nullptr)
+	{
+		printf("Unknown level \"%s\"\n", options.m_levelName.c_str());
+		return 1;
+	}
+
+	std::vector<SimRunnerParams> playerParams;
+	for (std::string const& playerName : SplitPlayerNames(options.m_playerName))
+	{
+		SimRunnerParams runnerParams;
+		if (!LoadSimRunnerParams("Data/Definitions/PlayerDefinitions.xml", playerName, runnerParams))
+		{
+			printf("Unknown player \"%s\"\n", playerName.c_str());
+			return 1;
+		}
+		playerParams.push_back(runnerParams);
+	}
+	if (playerParams.empty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	SimLevel level;
+	level.LayoutFromDefinition(*levelDef);
+	level.BuildBlockBVH();
+
+	if (options.m_numRunners > 1)
+	{
+		int result = RunBatch(options, level, playerParams, isReplaying ? &replayRecording : nullptr);
+		LevelDefinition::ClearLevelDefinitions();
+		return result;
+	}
+	SimRunnerParams const& runnerParams = playerParams[0];
+
+	InputRecording recording;
+	recording.Begin(options.m_levelName, options.m_playerName, options.m_simulationHz);
+
+	SimRunnerState runnerState;
+	uint64_t trajectoryHash = TRAJECTORY_HASH_SEED;
+	float tickSeconds = 1.f / options.m_simulationHz;
+	int numDeaths = 0;
+	int numCompletions = 0;
+	float furthestX = 0.f;
+
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	for (int tickIndex = 0; tickIndex < options.m_numTicks; ++tickIndex)
+	{
+		SimInput input = SIM_INPUT_NONE;
+		if (isReplaying)
+		{
+			input = replayCursor.Next();
+		}
+		else
+		{
+			if (options.m_jumpInterval > 0 && (tickIndex % options.m_jumpInterval) == 0)
+			{
+				input |= SIM_INPUT_JUMP;
+			}
+			if (options.m_respawnInterval > 0 && tickIndex > 0 && (tickIndex % options.m_respawnInterval) == 0)
+			{
+				input |= SIM_INPUT_RESPAWN;
+			}
+		}
+		if (!options.m_recordPath.empty())
+		{
+			recording.AppendTick(input);
+		}
+
+		unsigned int simEvents = SimulateRunnerTick(level, runnerParams, input, runnerState, tickSeconds);
+		trajectoryHash = HashRunnerState(runnerState, trajectoryHash);
+		if (runnerState.m_position.x > furthestX)
+		{
+			furthestX = runnerState.m_position.x;
+		}
+		if (simEvents & SIM_EVENT_DIED)
+		{
+			++numDeaths;
+		}
+		if (simEvents & SIM_EVENT_REACHED_END_GOAL)
+		{
+			++numCompletions;
+			runnerState.Respawn();
+		}
+	}
+	std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+
+	double elapsedSeconds = std::chrono::duration<double>(endTime - startTime).count();
+	double ticksPerSecond = (elapsedSeconds > 0.0) ? static_cast<double>(options.m_numTicks) / elapsedSeconds : 0.0;
+	printf("Level %s, player %s, %d blocks\n", options.m_levelName.c_str(), options.m_playerName.c_str(), level.GetBlocks().GetNumBlocks());
+	printf("Ticks: %d at %0.0f Hz (%0.1f simulated seconds)\n", options.m_numTicks, options.m_simulationHz, options.m_numTicks * tickSeconds);
+	printf("Deaths: %d, Completions: %d, Furthest X: %0.2f\n", numDeaths, numCompletions, furthestX);
+	printf("Trajectory hash: %016llx\n", static_cast<unsigned long long>(trajectoryHash));
+	printf("Wall time: %0.3f s, %0.0f ticks/s\n", elapsedSeconds, ticksPerSecond);
+
+	// The game and this runner share SimulateRunnerTick, a recording made by one replays to the same hash in the other
+	bool doesHashMatch = true;
+	if (isReplayingAsRecorded)
+	{
+		doesHashMatch = trajectoryHash == replayRecording.m_trajectoryHash;
+		printf("Recorded trajectory hash: %016llx, %s\n", static_cast<unsigned long long>(replayRecording.m_trajectoryHash), doesHashMatch ? "match" : "MISMATCH");
+	}
+
+	if (!options.m_recordPath.empty())
+	{
+		recording.m_trajectoryHash = trajectoryHash;
+		recording.m_hasTrajectoryHash = true;
+		if (!recording.SaveToFile(options.m_recordPath.c_str()))
+		{
+			printf("Could not write input recording \"%s\"\n", options.m_recordPath.c_str());
+			return 1;
+		}
+	}
+
+	LevelDefinition::ClearLevelDefinitions();
+	return doesHashMatch ? 0 : 1;
+}
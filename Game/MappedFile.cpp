@@ -0,0 +1,125 @@
+#include "Game/MappedFile.hpp"
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+// -----------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#if defined(_WIN32)
+bool MappedFile::Open(char const* filePath)
+{
+	Close();
+
+	HANDLE fileHandle = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle == nullptr)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr)
+	{
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	m_fileHandle = fileHandle;
+	m_mappingHandle = mappingHandle;
+	m_data = static_cast<unsigned char const*>(view);
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_data != nullptr)
+	{
+		UnmapViewOfFile(m_data);
+		CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+		CloseHandle(static_cast<HANDLE>(m_fileHandle));
+	}
+	m_data = nullptr;
+	m_size = 0;
+	m_fileHandle = nullptr;
+	m_mappingHandle = nullptr;
+}
+#else
+bool MappedFile::Open(char const* filePath)
+{
+	Close();
+
+	int fileDescriptor = open(filePath, O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStats;
+	if (fstat(fileDescriptor, &fileStats) != 0 || fileStats.st_size == 0)
+	{
+		close(fileDescriptor);
+		return false;
+	}
+
+	// The mapping keeps its own reference to the file, the descriptor is not needed past here
+	void* view = mmap(nullptr, static_cast<size_t>(fileStats.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	close(fileDescriptor);
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+
+	m_data = static_cast<unsigned char const*>(view);
+	m_size = static_cast<size_t>(fileStats.st_size);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_data != nullptr)
+	{
+		munmap(const_cast<unsigned char*>(m_data), m_size);
+	}
+	m_data = nullptr;
+	m_size = 0;
+}
+#endif
+
+bool MappedFile::IsOpen() const
+{
+	return m_data != nullptr;
+}
+
+unsigned char const* MappedFile::GetData() const
+{
+	return m_data;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return m_size;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+// -----------------------------------------------------------------------------
+// Read-only memory mapping of a whole file. Pages are loaded by the OS on first
+// touch, so opening costs the same however large the file is.
+// -----------------------------------------------------------------------------
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(MappedFile const& copyFrom) = delete;
+	MappedFile& operator=(MappedFile const& copyFrom) = delete;
+
+	bool Open(char const* filePath);
+	void Close();
+
+	bool IsOpen() const;
+	unsigned char const* GetData() const;
+	size_t GetSize() const;
+
+private:
+	unsigned char const* m_data = nullptr;
+	size_t				 m_size = 0;
+#if defined(_WIN32)
+	void* m_fileHandle = nullptr;
+	void* m_mappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,249 @@
+#include "Game/MenuUI.hpp"
+#include "Game/GameCommon.h"
+#include "Game/RenderQueue.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/VertexUtils.h"
+#include "Engine/Renderer/Renderer.h"
+// -----------------------------------------------------------------------------
+MenuUI::MenuUI(TextMeshCache* textMeshCache)
+	: m_textMeshCache(textMeshCache)
+{
+}
+
+MenuUI::~MenuUI()
+{
+	delete m_batchVertexBuffer;
+	m_batchVertexBuffer = nullptr;
+}
+
+void MenuUI::BeginScreen(int screenIndex)
+{
+	GUARANTEE_OR_DIE(screenIndex >= 0 && screenIndex < MAX_MENU_SCREENS, Stringf("Menu screen %d is out of range", screenIndex));
+	GUARANTEE_OR_DIE(!m_screens[screenIndex].m_isBuilt, Stringf("Menu screen %d was already built", screenIndex));
+
+	MenuScreen& screen = m_screens[screenIndex];
+	screen.m_firstButton = m_numButtons;
+	screen.m_firstBorder = m_numBorders;
+	m_buildingScreen = screenIndex;
+}
+
+void MenuUI::EndScreen()
+{
+	MenuScreen& screen = m_screens[m_buildingScreen];
+	screen.m_numButtons = m_numButtons - screen.m_firstButton;
+	screen.m_numBorders = m_numBorders - screen.m_firstBorder;
+
+	// Labels point at the pooled button text, which never moves
+	screen.m_labels.reserve(screen.m_numButtons);
+	for (int buttonIndex = screen.m_firstButton; buttonIndex < m_numButtons; ++buttonIndex)
+	{
+		MenuButton const& button = m_buttons[buttonIndex];
+		TextLine label;
+		label.m_text = button.m_text.c_str();
+		label.m_box = button.m_bounds;
+		label.m_cellHeight = (button.m_bounds.m_maxs.y - button.m_bounds.m_mins.y) * 0.5f;
+		screen.m_labels.push_back(label);
+	}
+	screen.m_isBuilt = true;
+	m_buildingScreen = -1;
+}
+
+int MenuUI::AddButton(AABB2 const& bounds, std::string const& text, Rgba8 const& backgroundColor, Rgba8 const& hoverColor, MenuAction action, int actionParam)
+{
+	GUARANTEE_OR_DIE(m_buildingScreen >= 0, "Menu buttons must be added between BeginScreen and EndScreen");
+	GUARANTEE_OR_DIE(m_numButtons < MAX_MENU_BUTTONS, "Out of menu buttons, raise MAX_MENU_BUTTONS");
+
+	MenuButton& button = m_buttons[m_numButtons];
+	button.m_bounds = bounds;
+	button.m_text = text;
+	button.m_backgroundColor = backgroundColor;
+	button.m_hoverColor = hoverColor;
+	button.m_action = action;
+	button.m_actionParam = actionParam;
+	button.m_isEnabled = true;
+	return m_numButtons++;
+}
+
+int MenuUI::AddBorder(AABB2 const& bounds, Rgba8 const& color, float thickness)
+{
+	return AddDashedBorder(bounds, color, thickness, 0.f, 0.f);
+}
+
+int MenuUI::AddDashedBorder(AABB2 const& bounds, Rgba8 const& color, float thickness, float dashLength, float gapLength)
+{
+	GUARANTEE_OR_DIE(m_buildingScreen >= 0, "Menu borders must be added between BeginScreen and EndScreen");
+	GUARANTEE_OR_DIE(m_numBorders < MAX_MENU_BORDERS, "Out of menu borders, raise MAX_MENU_BORDERS");
+
+	MenuBorder& border = m_borders[m_numBorders];
+	border.m_bounds = bounds;
+	border.m_color = color;
+	border.m_thickness = thickness;
+	border.m_dashLength = dashLength;
+	border.m_gapLength = gapLength;
+	return m_numBorders++;
+}
+
+void MenuUI::SetActiveScreen(int screenIndex)
+{
+	if (screenIndex == m_activeScreen)
+	{
+		return;
+	}
+	m_activeScreen = screenIndex;
+	m_hoveredButton = INVALID_MENU_ELEMENT;
+	m_isBatchDirty = true;
+}
+
+void MenuUI::SetButtonEnabled(int buttonIndex, bool isEnabled)
+{
+	MenuButton& button = m_buttons[buttonIndex];
+	if (button.m_isEnabled != isEnabled)
+	{
+		button.m_isEnabled = isEnabled;
+		m_isBatchDirty = true;
+	}
+}
+
+MenuClick MenuUI::Update(Vec2 const& cursorPos, bool wasClicked)
+{
+	MenuClick click;
+	if (m_activeScreen < 0 || !m_screens[m_activeScreen].m_isBuilt)
+	{
+		return click;
+	}
+
+	MenuScreen const& screen = m_screens[m_activeScreen];
+	int hoveredButton = INVALID_MENU_ELEMENT;
+	for (int buttonIndex = screen.m_firstButton; buttonIndex < screen.m_firstButton + screen.m_numButtons; ++buttonIndex)
+	{
+		if (m_buttons[buttonIndex].m_bounds.IsPointInside(cursorPos))
+		{
+			hoveredButton = buttonIndex;
+			break;
+		}
+	}
+
+	if (hoveredButton != m_hoveredButton)
+	{
+		m_hoveredButton = hoveredButton;
+		m_isBatchDirty = true;
+	}
+
+	if (wasClicked && m_hoveredButton != INVALID_MENU_ELEMENT && m_buttons[m_hoveredButton].m_isEnabled)
+	{
+		click.m_action = m_buttons[m_hoveredButton].m_action;
+		click.m_actionParam = m_buttons[m_hoveredButton].m_actionParam;
+	}
+	return click;
+}
+
+void MenuUI::Render()
+{
+	if (m_activeScreen < 0 || !m_screens[m_activeScreen].m_isBuilt)
+	{
+		return;
+	}
+
+	if (m_isBatchDirty)
+	{
+		RebuildBatch();
+	}
+
+	if (m_numBatchVerts > 0)
+	{
+		RenderCommand command;
+		command.m_layer = RenderLayer::MENU;
+		g_theRenderQueue->AddVertexBuffer(command, m_batchVertexBuffer, static_cast<unsigned int>(m_numBatchVerts));
+	}
+
+	MenuScreen const& screen = m_screens[m_activeScreen];
+	if (!screen.m_labels.empty())
+	{
+		m_textMeshCache->DrawStaticText(screen.m_labels.data(), static_cast<int>(screen.m_labels.size()));
+	}
+}
+
+void MenuUI::AddVertsForBorder(std::vector<Vertex_PCU>& verts, MenuBorder const& border)
+{
+	Vec2 const& mins = border.m_bounds.m_mins;
+	Vec2 const& maxs = border.m_bounds.m_maxs;
+	float halfThickness = border.m_thickness * 0.5f;
+
+	if (border.m_dashLength <= 0.f)
+	{
+		// Corners are covered by the top and bottom edges
+		AddVertsForAABB2D(verts, AABB2(mins.x - halfThickness, mins.y - halfThickness, maxs.x + halfThickness, mins.y + halfThickness), border.m_color);
+		AddVertsForAABB2D(verts, AABB2(mins.x - halfThickness, maxs.y - halfThickness, maxs.x + halfThickness, maxs.y + halfThickness), border.m_color);
+		AddVertsForAABB2D(verts, AABB2(mins.x - halfThickness, mins.y + halfThickness, mins.x + halfThickness, maxs.y - halfThickness), border.m_color);
+		AddVertsForAABB2D(verts, AABB2(maxs.x - halfThickness, mins.y + halfThickness, maxs.x + halfThickness, maxs.y - halfThickness), border.m_color);
+		return;
+	}
+
+	AddVertsForDashedEdge(verts, Vec2(mins.x, mins.y), Vec2(maxs.x, mins.y), border);
+	AddVertsForDashedEdge(verts, Vec2(maxs.x, mins.y), Vec2(maxs.x, maxs.y), border);
+	AddVertsForDashedEdge(verts, Vec2(maxs.x, maxs.y), Vec2(mins.x, maxs.y), border);
+	AddVertsForDashedEdge(verts, Vec2(mins.x, maxs.y), Vec2(mins.x, mins.y), border);
+}
+
+void MenuUI::AddVertsForDashedEdge(std::vector<Vertex_PCU>& verts, Vec2 const& start, Vec2 const& end, MenuBorder const& border)
+{
+	// Edges are axis aligned, so each dash is a box along the edge
+	float halfThickness = border.m_thickness * 0.5f;
+	Vec2 edge = end - start;
+	float edgeLength = edge.GetLength();
+	Vec2 direction = edge.GetNormalized();
+
+	float dashStart = 0.f;
+	while (dashStart < edgeLength)
+	{
+		float dashEnd = (dashStart + border.m_dashLength < edgeLength) ? dashStart + border.m_dashLength : edgeLength;
+		Vec2 dashStartPos = start + direction * dashStart;
+		Vec2 dashEndPos = start + direction * dashEnd;
+
+		float minX = (dashStartPos.x < dashEndPos.x) ? dashStartPos.x : dashEndPos.x;
+		float minY = (dashStartPos.y < dashEndPos.y) ? dashStartPos.y : dashEndPos.y;
+		float maxX = (dashStartPos.x > dashEndPos.x) ? dashStartPos.x : dashEndPos.x;
+		float maxY = (dashStartPos.y > dashEndPos.y) ? dashStartPos.y : dashEndPos.y;
+		AABB2 dashBox = AABB2(minX - halfThickness, minY - halfThickness, maxX + halfThickness, maxY + halfThickness);
+		AddVertsForAABB2D(verts, dashBox, border.m_color);
+
+		dashStart = dashEnd + border.m_gapLength;
+	}
+}
+
+void MenuUI::RebuildBatch()
+{
+	MenuScreen const& screen = m_screens[m_activeScreen];
+
+	m_batchVerts.clear();
+	for (int buttonIndex = screen.m_firstButton; buttonIndex < screen.m_firstButton + screen.m_numButtons; ++buttonIndex)
+	{
+		MenuButton const& button = m_buttons[buttonIndex];
+		Rgba8 color = button.m_isEnabled ? button.m_backgroundColor : Rgba8::DARKGRAY;
+		if (button.m_isEnabled && buttonIndex == m_hoveredButton)
+		{
+			color = button.m_hoverColor;
+		}
+		AddVertsForAABB2D(m_batchVerts, button.m_bounds, color);
+	}
+
+	// Borders after buttons so they draw on top
+	for (int borderIndex = screen.m_firstBorder; borderIndex < screen.m_firstBorder + screen.m_numBorders; ++borderIndex)
+	{
+		AddVertsForBorder(m_batchVerts, m_borders[borderIndex]);
+	}
+
+	m_numBatchVerts = static_cast<int>(m_batchVerts.size());
+	unsigned int vertsBytes = static_cast<unsigned int>(m_numBatchVerts) * sizeof(Vertex_PCU);
+	if (m_numBatchVerts > 0)
+	{
+		if (m_batchVertexBuffer == nullptr || m_batchVertexBuffer->GetSize() < vertsBytes)
+		{
+			delete m_batchVertexBuffer;
+			m_batchVertexBuffer = g_theRenderer->CreateVertexBuffer(vertsBytes, sizeof(Vertex_PCU));
+		}
+		g_theRenderer->CopyCPUToGPU(m_batchVerts.data(), vertsBytes, m_batchVertexBuffer);
+	}
+	m_isBatchDirty = false;
+}
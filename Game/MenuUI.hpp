@@ -0,0 +1,109 @@
+#pragma once
+#include "Game/TextMeshCache.hpp"
+#include "Engine/Core/Rgba8.h"
+#include "Engine/Core/Vertex_PCU.h"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <string>
+#include <vector>
+// -----------------------------------------------------------------------------
+class VertexBuffer;
+// -----------------------------------------------------------------------------
+constexpr int MAX_MENU_SCREENS = 8;
+constexpr int MAX_MENU_BUTTONS = 32;
+constexpr int MAX_MENU_BORDERS = 32;
+constexpr int INVALID_MENU_ELEMENT = -1;
+// -----------------------------------------------------------------------------
+enum class MenuAction
+{
+	NONE,
+	QUIT,
+	GO_TO_STATE,			// Param is the GameState to enter
+	PICK_RUNNER,
+	PICK_SKATER,
+	BACK_TO_CHARACTER_SELECT,
+	PLAY_LEVEL,				// Param is the level index
+	PLAY_ENDLESS
+};
+// -----------------------------------------------------------------------------
+struct MenuClick
+{
+	MenuAction m_action = MenuAction::NONE;
+	int		   m_actionParam = 0;
+};
+// -----------------------------------------------------------------------------
+// Retained menu screens. Every screen's buttons and borders are built once into
+// fixed pools and kept, changing screens only changes which range is visible.
+// All visible quads and borders share one vertex buffer that is rebuilt when the
+// hovered button, the active screen or a button's enabled state changes.
+// -----------------------------------------------------------------------------
+class MenuUI
+{
+public:
+	explicit MenuUI(TextMeshCache* textMeshCache);
+	~MenuUI();
+
+	// Elements added between these belong to that screen, each screen is built once
+	void BeginScreen(int screenIndex);
+	void EndScreen();
+	int  AddButton(AABB2 const& bounds, std::string const& text, Rgba8 const& backgroundColor, Rgba8 const& hoverColor, MenuAction action, int actionParam = 0);
+	int  AddBorder(AABB2 const& bounds, Rgba8 const& color, float thickness);
+	int  AddDashedBorder(AABB2 const& bounds, Rgba8 const& color, float thickness, float dashLength, float gapLength);
+
+	void SetActiveScreen(int screenIndex);
+	void SetButtonEnabled(int buttonIndex, bool isEnabled);
+
+	MenuClick Update(Vec2 const& cursorPos, bool wasClicked);
+	void Render();
+
+private:
+	struct MenuButton
+	{
+		AABB2		m_bounds;
+		std::string m_text;
+		Rgba8		m_backgroundColor;
+		Rgba8		m_hoverColor;
+		MenuAction	m_action = MenuAction::NONE;
+		int			m_actionParam = 0;
+		bool		m_isEnabled = true;
+	};
+
+	struct MenuBorder
+	{
+		AABB2 m_bounds;
+		Rgba8 m_color;
+		float m_thickness = 0.f;
+		float m_dashLength = 0.f;		// Zero draws a solid border
+		float m_gapLength = 0.f;
+	};
+
+	struct MenuScreen
+	{
+		int					  m_firstButton = 0;
+		int					  m_numButtons = 0;
+		int					  m_firstBorder = 0;
+		int					  m_numBorders = 0;
+		std::vector<TextLine> m_labels;
+		bool				  m_isBuilt = false;
+	};
+
+	static void AddVertsForBorder(std::vector<Vertex_PCU>& verts, MenuBorder const& border);
+	static void AddVertsForDashedEdge(std::vector<Vertex_PCU>& verts, Vec2 const& start, Vec2 const& end, MenuBorder const& border);
+	void RebuildBatch();
+
+private:
+	TextMeshCache*			m_textMeshCache = nullptr;
+	MenuButton				m_buttons[MAX_MENU_BUTTONS];
+	MenuBorder				m_borders[MAX_MENU_BORDERS];
+	MenuScreen				m_screens[MAX_MENU_SCREENS];
+	int						m_numButtons = 0;
+	int						m_numBorders = 0;
+	int						m_buildingScreen = -1;
+	int						m_activeScreen = -1;
+	int						m_hoveredButton = INVALID_MENU_ELEMENT;
+
+	std::vector<Vertex_PCU> m_batchVerts;			// Kept so rebuilds reuse its storage
+	VertexBuffer*			m_batchVertexBuffer = nullptr;
+	int						m_numBatchVerts = 0;
+	bool					m_isBatchDirty = true;
+};
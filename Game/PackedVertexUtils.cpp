@@ -0,0 +1,63 @@
+#include "Game/PackedVertexUtils.hpp"
+#include <cmath>
+// -----------------------------------------------------------------------------
+static float GetSignNotZero(float value)
+{
+	return (value >= 0.f) ? 1.f : -1.f;
+}
+// -----------------------------------------------------------------------------
+Vec2 EncodeOctahedralNormal(Vec3 const& unitNormal)
+{
+	// Project onto the octahedron |x| + |y| + |z| = 1, then fold the lower half over the upper
+	float invL1Norm = 1.f / (fabsf(unitNormal.x) + fabsf(unitNormal.y) + fabsf(unitNormal.z));
+	float octX = unitNormal.x * invL1Norm;
+	float octY = unitNormal.y * invL1Norm;
+	if (unitNormal.z < 0.f)
+	{
+		float foldedX = (1.f - fabsf(octY)) * GetSignNotZero(octX);
+		float foldedY = (1.f - fabsf(octX)) * GetSignNotZero(octY);
+		octX = foldedX;
+		octY = foldedY;
+	}
+	return Vec2(octX, octY);
+}
+// -----------------------------------------------------------------------------
+void AddVertsForQuad3DPacked(std::vector<Vertex_PCU>& verts, std::vector<unsigned int>& indices, Vec3 const& bottomLeft, Vec3 const& bottomRight,
+	Vec3 const& topRight, Vec3 const& topLeft, Vec3 const& normal, Rgba8 const& color)
+{
+	unsigned int firstVertex = static_cast<unsigned int>(verts.size());
+	Vec2 octNormal = EncodeOctahedralNormal(normal);
+	verts.push_back(Vertex_PCU(bottomLeft, color, octNormal));
+	verts.push_back(Vertex_PCU(bottomRight, color, octNormal));
+	verts.push_back(Vertex_PCU(topRight, color, octNormal));
+	verts.push_back(Vertex_PCU(topLeft, color, octNormal));
+
+	// Counter-clockwise seen from the side the normal points to, same as AddVertsForQuad3D
+	indices.push_back(firstVertex + 0);
+	indices.push_back(firstVertex + 1);
+	indices.push_back(firstVertex + 2);
+	indices.push_back(firstVertex + 0);
+	indices.push_back(firstVertex + 2);
+	indices.push_back(firstVertex + 3);
+}
+
+void AddVertsForOBB3DPacked(std::vector<Vertex_PCU>& verts, std::vector<unsigned int>& indices, OBB3 const& box, Rgba8 const& color)
+{
+	Vec3 const i = box.m_iBasisNormal * box.m_halfDimensions.x;
+	Vec3 const j = box.m_jBasisNormal * box.m_halfDimensions.y;
+	Vec3 const k = box.m_kBasisNormal * box.m_halfDimensions.z;
+	Vec3 const& c = box.m_center;
+
+	// Each face as (normal, right, up) with right x up = normal
+	Vec3 const faceNormals[6] = { box.m_iBasisNormal, -box.m_iBasisNormal, box.m_jBasisNormal, -box.m_jBasisNormal, box.m_kBasisNormal, -box.m_kBasisNormal };
+	Vec3 const faceCenters[6] = { c + i, c - i, c + j, c - j, c + k, c - k };
+	Vec3 const faceRights[6] = { j, -j, -i, i, i, i };
+	Vec3 const faceUps[6] = { k, k, k, k, j, -j };
+	for (int faceIndex = 0; faceIndex < 6; ++faceIndex)
+	{
+		Vec3 const& center = faceCenters[faceIndex];
+		Vec3 const& right = faceRights[faceIndex];
+		Vec3 const& up = faceUps[faceIndex];
+		AddVertsForQuad3DPacked(verts, indices, center - right - up, center + right - up, center + right + up, center - right + up, faceNormals[faceIndex], color);
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "Engine/Math/OBB3.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.h"
+#include "Engine/Core/Rgba8.h"
+#include "Engine/Core/Vertex_PCU.h"
+#include <vector>
+// -----------------------------------------------------------------------------
+// Static level block vertices in the Engine's 24 byte Vertex_PCU layout, against
+// 60 for Vertex_PCUTBN. Blocks are flat shaded and untextured, so the UV slot
+// carries the octahedral encoded normal and the PackedBlock shader derives the
+// tangent frame from it.
+// -----------------------------------------------------------------------------
+Vec2 EncodeOctahedralNormal(Vec3 const& unitNormal);
+
+void AddVertsForQuad3DPacked(std::vector<Vertex_PCU>& verts, std::vector<unsigned int>& indices, Vec3 const& bottomLeft, Vec3 const& bottomRight,
+	Vec3 const& topRight, Vec3 const& topLeft, Vec3 const& normal, Rgba8 const& color);
+void AddVertsForOBB3DPacked(std::vector<Vertex_PCU>& verts, std::vector<unsigned int>& indices, OBB3 const& box, Rgba8 const& color);
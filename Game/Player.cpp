@@ -1,9 +1,11 @@
 #include "Game/Player.hpp"
 #include "Game/GameCommon.h"
 #include "Game/Game.h"
-#include "Game/Level.hpp"
+#include "Game/SimLevel.hpp"
 #include "Game/AnimationGroup.hpp"
 #include "Game/PlayerDefinition.hpp"
+#include "Game/PlayerMeshCache.hpp"
+#include "Game/RenderQueue.hpp"
 #include "Engine/Input/InputSystem.h"
 #include "Engine/Math/MathUtils.h"
 #include "Engine/Core/EngineCommon.h"
@@ -14,79 +16,33 @@
 
 Player::Player(Game* owner, Vec3 const& position, EulerAngles orientation, Rgba8 color, PlayerDefinition* def)
 	: m_game(owner),
-	  m_position(position),
+	  m_previousPosition(position),
+	  m_renderPosition(position),
 	  m_orientation(orientation),
 	  m_color(color),
 	  m_playerDef(def),
 	  m_animationClock(new Clock(*g_theGame->m_gameClock))
 {
-	m_position = position;
+	m_simState.m_position = position;
 	m_orientation = orientation;
 	InitializePlayerData();
 	InitializePlayerGeometry();
 
 	if (m_playerDef->m_isVisible && !m_playerDef->m_animationGroups.empty())
 	{
-		m_animGroup = m_playerDef->m_animationGroups[0];
+		PlayAnimation(m_playerDef->m_animStateMachine.GetInitialState());
 	}
 }
 
 void Player::InitializePlayerData()
 {
-	m_gravityForce = GRAVITY_FORCE;
-	m_physicsHeight = m_playerDef->m_physicsHeight;
-	m_physicsRadius = m_playerDef->m_physicsRadius;
-	m_playerJumpForce = m_playerDef->m_jumpForce;
+	m_simParams = m_playerDef->m_simParams;
 }
 
 void Player::InitializePlayerGeometry()
 {
-	Rgba8 bodyColor = m_color;
-	float bodyRadius = m_physicsRadius * 0.6f;
-	float bodyHeight = m_physicsHeight * 0.6f;
-
-	// Body
-	Vec3 bodyCenter = m_position + Vec3(0.f, 0.f, bodyHeight * 0.25f);
-	AddVertsForSphere3D(m_playerVerts, bodyCenter, bodyRadius, bodyColor);
-
-	// Arms
-	float armRadius = bodyRadius * 0.3f;
-	Vec3 leftShoulder = bodyCenter + Vec3(0.f, bodyRadius - armRadius * 0.5f, 0.f);
-	Vec3 leftHand = leftShoulder + Vec3(0.f, bodyRadius * 0.8f, -bodyHeight * 0.3f);
-	Vec3 rightShoulder = bodyCenter + Vec3(0.f, -bodyRadius + armRadius * 0.5f, 0.f);
-	Vec3 rightHand = rightShoulder + Vec3(0.f, -bodyRadius * 0.8f, -bodyHeight * 0.3f);
-	AddVertsForCylinder3D(m_playerVerts, leftShoulder, leftHand, bodyRadius * 0.3f, bodyColor);
-	AddVertsForCylinder3D(m_playerVerts, rightShoulder, rightHand, bodyRadius * 0.3f, bodyColor);
-
-	// Legs
-	Vec3 leftHip = m_position + Vec3(0.f, bodyRadius * 0.5f, 0.15f);
-	Vec3 leftFoot = leftHip + Vec3(0.f, bodyRadius * 0.25f, -bodyHeight * 0.9f);
-	Vec3 rightHip = m_position + Vec3(0.f, -bodyRadius * 0.5f, 0.15f);
-	Vec3 rightFoot = rightHip + Vec3(0.f, -bodyRadius * 0.25f, -bodyHeight * 0.9f);
-	AddVertsForCylinder3D(m_playerVerts, leftHip, leftFoot, bodyRadius * 0.35f, bodyColor);
-	AddVertsForCylinder3D(m_playerVerts, rightHip, rightFoot, bodyRadius * 0.35f, bodyColor);
-
-	// Antennas
-	float antennaLength = bodyHeight * 0.5f;
-	float antennaRadius = bodyRadius * 0.1f;
-	float antennaBallRadius = antennaRadius * 1.9f;
-	float antennaBaseOffsetZ = -bodyRadius * 0.2f;
-
-	Vec3 topOfHead = bodyCenter + Vec3(0.f, 0.f, bodyRadius + antennaBaseOffsetZ);
-	Vec3 leftAntennaDir = Vec3(0.4f, 0.4f, 1.0f).GetNormalized();
-	Vec3 rightAntennaDir = Vec3(-0.4f, -0.4f, 1.0f).GetNormalized();
-
-	// Left antenna
-	Vec3 antennaBaseLeft = topOfHead + Vec3(0.f, bodyRadius * 0.3f, 0.f);
-	Vec3 antennaTipLeft = antennaBaseLeft + leftAntennaDir * antennaLength;
-	AddVertsForCylinder3D(m_playerVerts, antennaBaseLeft, antennaTipLeft, antennaRadius, bodyColor);
-	AddVertsForSphere3D(m_playerVerts, antennaTipLeft, antennaBallRadius, bodyColor);
-
-	// Right antenna
-	Vec3 antennaBaseRight = topOfHead + Vec3(0.f, -bodyRadius * 0.3f, 0.f);
-	Vec3 antennaTipRight = antennaBaseRight + rightAntennaDir * antennaLength;
-	AddVertsForCylinder3D(m_playerVerts, antennaBaseRight, antennaTipRight, antennaRadius, bodyColor);
-	AddVertsForSphere3D(m_playerVerts, antennaTipRight, antennaBallRadius, bodyColor);
+	// Shared with every other player of the same look, only the first one tessellates
+	m_bodyMesh = m_game->m_playerMeshCache->CreateOrGetBodyMesh(m_playerDef, m_color, m_simParams.m_physicsRadius, m_simParams.m_physicsHeight);
 }
 
 Player::~Player()
@@ -95,14 +51,22 @@ Player::~Player()
 
 void Player::Update(float deltaSeconds)
 {
-	PlayerInput(deltaSeconds);
+	UNUSED(deltaSeconds);
 
-	m_velocity.z += m_gravityForce * deltaSeconds;
-
-	// Here I am clamping gravity so we don't fall super fast
-	m_velocity.z = GetClamped(m_velocity.z, MAX_FALL_SPEED, m_playerJumpForce);
+	// Latch the jump until the next fixed tick so a frame that runs no ticks doesn't drop it
+	if (g_theInput->WasKeyJustPressed(KEYCODE_SPACE))
+	{
+		m_jumpRequested = true;
+	}
 
-	m_position += m_velocity * deltaSeconds;
+	if (g_theInput->WasKeyJustPressed(KEYCODE_F1))
+	{
+		m_drawDebug = !m_drawDebug;
+	}
+	if (g_theInput->WasKeyJustPressed('L'))
+	{
+		ToggleShadow();
+	}
 
 	if (m_animGroup == nullptr)
 	{
@@ -110,15 +74,31 @@ void Player::Update(float deltaSeconds)
 	}
 
 	UpdateAnimation();
+}
 
-	if (g_theInput->WasKeyJustPressed(KEYCODE_F1))
+unsigned int Player::FixedUpdate(SimLevel const& level, SimInput simInput, float fixedDeltaSeconds)
+{
+	m_previousPosition = m_simState.m_position;
+	bool wasGrounded = m_simState.m_isGrounded;
+
+	unsigned int simEvents = SimulateRunnerTick(level, m_simParams, simInput, m_simState, fixedDeltaSeconds);
+	HandleSimEvents(simEvents);
+
+	// Only the animation cares about these, so they are derived here rather than added to the sim events
+	if (wasGrounded && !m_simState.m_isGrounded)
 	{
-		m_drawDebug = !m_drawDebug;
+		FireAnimTrigger(AnimTrigger::LEFT_GROUND);
 	}
-	if (g_theInput->WasKeyJustPressed('L'))
+	else if (!wasGrounded && m_simState.m_isGrounded)
 	{
-		ToggleShadow();
+		FireAnimTrigger(AnimTrigger::LANDED);
 	}
+	return simEvents;
+}
+
+void Player::UpdateRenderPosition(float tickFraction)
+{
+	m_renderPosition = m_previousPosition + (m_simState.m_position - m_previousPosition) * tickFraction;
 }
 
 void Player::UpdateAnimation()
@@ -126,15 +106,11 @@ void Player::UpdateAnimation()
 	float animDuration = m_animGroup->m_anims[0].GetDuration();
 	if (m_animationClock->GetTotalSeconds() > animDuration && m_animGroup->m_playbackMode == SpriteAnimPlaybackType::ONCE)
 	{
-		if (m_animGroup != m_playerDef->m_animationGroups[0])
-		{
-			m_animGroup = m_playerDef->m_animationGroups[0];
-			m_animationClock->Reset();
-		}
+		FireAnimTrigger(AnimTrigger::FINISHED);
 	}
 	if (m_animGroup->m_scaleBySpeed)
 	{
-		m_animationClock->SetTimeScale(m_velocity.GetLength() / m_playerDef->m_moveSpeed);
+		m_animationClock->SetTimeScale(m_simState.m_velocity.GetLength() / m_simParams.m_moveSpeed);
 	}
 	else
 	{
@@ -142,6 +118,22 @@ void Player::UpdateAnimation()
 	}
 }
 
+void Player::UpdateSpriteFrame()
+{
+	if (!m_playerDef->m_isVisible || m_animGroup == nullptr)
+	{
+		return;
+	}
+
+	Vec2 playerToActorDirectionXY = (m_renderPosition - g_theGame->m_gameWorldCamera.GetPosition()).GetXY();
+	Vec3 playerToActorDirection = playerToActorDirectionXY.GetNormalized().GetAsVec3();
+	Vec3 viewingDirection = GetModelToWorldTransform().GetOrthonormalInverse().TransformVectorQuantity3D(playerToActorDirection);
+
+	// Every frame was built into its own buffer at load, so this only picks one
+	int flipbookFrame = m_animGroup->GetFlipbookFrame(viewingDirection, static_cast<float>(m_animationClock->GetTotalSeconds()));
+	m_spriteFrameVBO = m_playerDef->GetSpriteFrameBuffer(m_animState, flipbookFrame);
+}
+
 void Player::ToggleShadow()
 {
 	m_showShadow = !m_showShadow;
@@ -152,9 +144,9 @@ void Player::DrawDebug() const
 	// Draw debug physics cylinder
 	if (m_drawDebug)
 	{
-		Vec3 base = m_position - Vec3(0.f, 0.f, m_physicsHeight * 0.5f);
-		Vec3 top = m_position + Vec3(0.f, 0.f, m_physicsHeight * 0.5f);
-		DebugAddWorldWireCylinder(base, top, m_physicsRadius, 0.f, Rgba8::RED, Rgba8::RED);
+		Vec3 base = m_renderPosition - Vec3(0.f, 0.f, m_simParams.m_physicsHeight * 0.5f);
+		Vec3 top = m_renderPosition + Vec3(0.f, 0.f, m_simParams.m_physicsHeight * 0.5f);
+		DebugAddWorldWireCylinder(base, top, m_simParams.m_physicsRadius, 0.f, Rgba8::RED, Rgba8::RED);
 	}
 }
 
@@ -178,15 +170,15 @@ void Player::Render() const
 	{
 		if (m_playerDef->m_billboardType == BillboardType::WORLD_UP_FACING)
 		{
-			localToWorldTransform.Append(GetBillboardMatrix(BillboardType::WORLD_UP_FACING, g_theGame->m_gameWorldCamera.GetCameraToWorldTransform(), m_position));
+			localToWorldTransform.Append(GetBillboardMatrix(BillboardType::WORLD_UP_FACING, g_theGame->m_gameWorldCamera.GetCameraToWorldTransform(), m_renderPosition));
 		}
 		else if (m_playerDef->m_billboardType == BillboardType::FULL_OPPOSING)
 		{
-			localToWorldTransform.Append(GetBillboardMatrix(BillboardType::FULL_OPPOSING, g_theGame->m_gameWorldCamera.GetCameraToWorldTransform(), m_position));
+			localToWorldTransform.Append(GetBillboardMatrix(BillboardType::FULL_OPPOSING, g_theGame->m_gameWorldCamera.GetCameraToWorldTransform(), m_renderPosition));
 		}
 		else if (m_playerDef->m_billboardType == BillboardType::WORLD_UP_OPPOSING)
 		{
-			localToWorldTransform.Append(GetBillboardMatrix(BillboardType::WORLD_UP_OPPOSING, g_theGame->m_gameWorldCamera.GetCameraToWorldTransform(), m_position));
+			localToWorldTransform.Append(GetBillboardMatrix(BillboardType::WORLD_UP_OPPOSING, g_theGame->m_gameWorldCamera.GetCameraToWorldTransform(), m_renderPosition));
 		}
 		else
 		{
@@ -194,58 +186,23 @@ void Player::Render() const
 		}
 	}
 
-	Vec2 playerToActorDirectionXY = (m_position - g_theGame->m_gameWorldCamera.GetPosition()).GetXY();
-	Vec3 playerToActorDirection = playerToActorDirectionXY.GetNormalized().GetAsVec3();
-	Vec3 viewingDirection = GetModelToWorldTransform().GetOrthonormalInverse().TransformVectorQuantity3D(playerToActorDirection);
-
-	SpriteAnimDefinition anim = m_animGroup->GetAnimDirection(viewingDirection);
-	SpriteDefinition spriteDef = anim.GetSpriteDefAtTime(static_cast<float>(m_animationClock->GetTotalSeconds()));
-	AABB2 spriteUVs = spriteDef.GetUVs();
-
-	Vec3 spriteOffsetSize = -Vec3(0.f, m_playerDef->m_spriteSize.x, m_playerDef->m_spriteSize.y);
-	Vec3 spriteOffsetPivot = Vec3(0.f, m_playerDef->m_spritePivot.x, m_playerDef->m_spritePivot.y);
-	Vec3 spriteOffset = (spriteOffsetSize * spriteOffsetPivot);
-
-	Vec3 bL = Vec3::ZERO;
-	Vec3 bR = (Vec3::YAXE * m_playerDef->m_spriteSize.x);
-	Vec3 tR = (Vec3::YAXE * m_playerDef->m_spriteSize.x) + (Vec3::ZAXE * m_playerDef->m_spriteSize.y);
-	Vec3 tL = (Vec3::ZAXE * m_playerDef->m_spriteSize.y);
-
-	std::vector<Vertex_PCU> unlitVerts;
-	std::vector<Vertex_PCUTBN> litVertexes;
-
-	// Drawing player sprite
-	if (m_playerDef->m_renderRounded)
-	{
-		litVertexes.reserve(10000);
-		AddVertsForRoundedQuad3D(litVertexes, bL, bR, tR, tL, Rgba8::WHITE, spriteUVs);
-		TransformVertexArrayTBN3D(litVertexes, Mat44::MakeTranslation3D(spriteOffset));
-	}
-	else
+	// Drawing player sprite, the definition's quad for this frame is already on the GPU so only its transform changes
+	RenderCommand spriteCommand;
+	spriteCommand.m_layer = RenderLayer::WORLD;
+	spriteCommand.m_state.m_shader = m_playerDef->m_shader;
+	spriteCommand.m_state.m_texture = m_animGroup->GetTexture();
+	spriteCommand.m_state.m_blendMode = BlendMode::OPAQUE;
+	spriteCommand.m_state.m_rasterizerMode = RasterizerMode::SOLID_CULL_BACK;
+	spriteCommand.m_state.m_depthMode = DepthMode::READ_WRITE_LESS_EQUAL;
+	spriteCommand.m_modelToWorld = localToWorldTransform;
+	if (m_spriteFrameVBO != nullptr)
 	{
-		litVertexes.reserve(10000);
-		AddVertsForQuad3D(litVertexes, bL, bR, tR, tL, Rgba8::WHITE, spriteUVs);
-		TransformVertexArrayTBN3D(litVertexes, Mat44::MakeTranslation3D(spriteOffset));
+		g_theRenderQueue->AddVertexBuffer(spriteCommand, m_spriteFrameVBO, m_playerDef->m_numSpriteFrameVerts);
 	}
-	g_theRenderer->SetModelConstants(localToWorldTransform);
-	g_theRenderer->SetBlendMode(BlendMode::OPAQUE);
-	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-	g_theRenderer->BindShader(m_playerDef->m_shader);
-	g_theRenderer->BindTexture(&spriteDef.GetTexture());
-	g_theRenderer->DrawVertexArray(litVertexes);
 
 	// Drawing planar projected shadow
-	if (!m_isGrounded)
+	if (!m_simState.m_isGrounded)
 	{
-		std::vector<Vertex_PCU> shadowVerts;
-		Vec3 shadowBL = Vec3(-0.5f, -0.25f, 0.f);
-		Vec3 shadowBR = Vec3(0.5f, -0.25f, 0.f);
-		Vec3 shadowTR = Vec3(0.5f, 0.25f, 0.f);
-		Vec3 shadowTL = Vec3(-0.5f, 0.25f, 0.f);
-		Rgba8 shadowColor = Rgba8(0, 0, 0, 180);
-		AddVertsForQuad3D(shadowVerts, shadowBL, shadowBR, shadowTR, shadowTL, shadowColor);
-
 		Mat44 shadowTransform = GetShadowToWorldTransform();
 		if (shadowTransform.GetTranslation3D() == Vec3::ZERO)
 		{
@@ -254,13 +211,14 @@ void Player::Render() const
 
 		if (m_showShadow)
 		{
-			g_theRenderer->SetBlendMode(BlendMode::ALPHA);
-			g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_BACK);
-			g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
-			g_theRenderer->SetModelConstants(shadowTransform);
-			g_theRenderer->BindShader(m_playerDef->m_shader);
-			g_theRenderer->BindTexture(nullptr);
-			g_theRenderer->DrawVertexArray(m_playerVerts);
+			RenderCommand shadowCommand;
+			shadowCommand.m_layer = RenderLayer::WORLD;
+			shadowCommand.m_state.m_shader = m_playerDef->m_shader;
+			shadowCommand.m_state.m_blendMode = BlendMode::ALPHA;
+			shadowCommand.m_state.m_rasterizerMode = RasterizerMode::SOLID_CULL_BACK;
+			shadowCommand.m_state.m_depthMode = DepthMode::READ_WRITE_LESS_EQUAL;
+			shadowCommand.m_modelToWorld = shadowTransform;
+			g_theRenderQueue->AddVertexBuffer(shadowCommand, m_bodyMesh->m_vertexBuffer, static_cast<unsigned int>(m_bodyMesh->m_numVerts));
 		}
 	}
 }
@@ -268,7 +226,7 @@ void Player::Render() const
 Mat44 Player::GetModelToWorldTransform() const
 {
 	Mat44 modelToWorldMatrix;
-	modelToWorldMatrix.SetTranslation3D(m_position);
+	modelToWorldMatrix.SetTranslation3D(m_renderPosition);
 	EulerAngles orientation;
 	modelToWorldMatrix.Append(orientation.GetAsMatrix_IFwd_JLeft_KUp());
 	return modelToWorldMatrix;
@@ -277,16 +235,16 @@ Mat44 Player::GetModelToWorldTransform() const
 Mat44 Player::GetShadowToWorldTransform() const
 {
 	Mat44 shadowToWorldMatrix;
-	float maxDist = 100.f;
 
-	if (m_position.z > 0.f || m_velocity.z > 0.f)
+	if (m_simState.m_position.z > 0.f || m_simState.m_velocity.z > 0.f)
 	{
-		Vec3 intersectionPoint;
-
-		if (g_theGame->m_currentLevel->RaycastDown(m_position, maxDist, intersectionPoint))
+		// Cast by the level's batched ray pass after the frame's ticks
+		if (m_shadowRaycast.m_didImpact)
 		{
+			// Follow the interpolated body horizontally so the shadow doesn't trail the sprite between ticks
 			Vec3 planarShadowOffset = Vec3(0.f, 0.f, 0.1f);
-			shadowToWorldMatrix.SetTranslation3D(intersectionPoint + planarShadowOffset);
+			Vec3 shadowPosition = Vec3(m_renderPosition.x, m_renderPosition.y, m_shadowRaycast.m_impactPos.z);
+			shadowToWorldMatrix.SetTranslation3D(shadowPosition + planarShadowOffset);
 			EulerAngles orientation;
 			shadowToWorldMatrix.Append(orientation.GetAsMatrix_IFwd_JLeft_KUp());
 		}
@@ -305,86 +263,97 @@ Vec3 Player::GetForwardNormal() const
 	return Vec3::MakeFromPolarDegrees(m_orientation.m_pitchDegrees, m_orientation.m_yawDegrees, 2.f);
 }
 
-void Player::PlayerInput(float deltaseconds)
+SimInput Player::ConsumeSimInput()
 {
-	UNUSED(deltaseconds);
-
-	Vec3 forward = GetModelToWorldTransform().GetIBasis3D();
-	Vec3 left = GetModelToWorldTransform().GetJBasis3D();
-	float playerMoveSpeed = m_playerDef->m_moveSpeed;
-	float playerStrafeSpeed = m_playerDef->m_strafeSpeed;
+	// Latched presses go to exactly one tick, held keys are sampled fresh every tick
+	SimInput simInput = SIM_INPUT_NONE;
+	if (m_jumpRequested)
+	{
+		simInput |= SIM_INPUT_JUMP;
+	}
+	if (m_respawnRequested)
+	{
+		simInput |= SIM_INPUT_RESPAWN;
+	}
+	m_jumpRequested = false;
+	m_respawnRequested = false;
 
-	// Jumping movement
-	if (g_theInput->WasKeyJustPressed(KEYCODE_SPACE) && m_isGrounded)
+	if (g_theInput->IsKeyDown('A'))
 	{
-		PlayAnimation("Jump");
-		m_velocity.z = m_playerJumpForce;
-		m_isGrounded = false;
+		simInput |= SIM_INPUT_LEFT;
 	}
+	if (g_theInput->IsKeyDown('D'))
+	{
+		simInput |= SIM_INPUT_RIGHT;
+	}
+	return simInput;
+}
 
-	// Constant forward speed
-	Vec3 horizontalVelocity = forward * playerMoveSpeed;
+void Player::HandleSimEvents(unsigned int simEvents)
+{
+	// The tick already respawned the sim state and may have moved it on, respawning it again would drop that
+	if (simEvents & (SIM_EVENT_DIED | SIM_EVENT_RESPAWNED))
+	{
+		ResetPresentation();
+		return;
+	}
 
-	// Left and right movement
-	if (!m_isGrounded || g_theInput->WasKeyJustPressed(KEYCODE_SPACE))
+	if (simEvents & SIM_EVENT_JUMPED)
 	{
-		if (g_theInput->IsKeyDown('A')) 
-		{
-			horizontalVelocity += left * playerStrafeSpeed;
-		}
-		if (g_theInput->IsKeyDown('D')) 
-		{
-			horizontalVelocity -= left * playerStrafeSpeed;
-		}
+		FireAnimTrigger(AnimTrigger::JUMPED);
 	}
-	else
+	if (simEvents & SIM_EVENT_TURNING_LEFT)
 	{
-		if (g_theInput->IsKeyDown('A'))
-		{
-			PlayAnimation("TurnLeft");
-			horizontalVelocity += left * playerStrafeSpeed;
-			m_isTurning = true;
-		}
-		else if (g_theInput->IsKeyDown('D'))
-		{
-			PlayAnimation("TurnRight");
-			horizontalVelocity -= left * playerStrafeSpeed;
-			m_isTurning = true;
-		}
-		else
-		{
-			if (m_isTurning)
-			{
-				PlayAnimation("Walk");
-				m_isTurning = false;
-			}
-		}
+		FireAnimTrigger(AnimTrigger::TURNING_LEFT);
 	}
+	else if (simEvents & SIM_EVENT_TURNING_RIGHT)
+	{
+		FireAnimTrigger(AnimTrigger::TURNING_RIGHT);
+	}
+	else if (simEvents & SIM_EVENT_STOPPED_TURNING)
+	{
+		FireAnimTrigger(AnimTrigger::STOPPED_TURNING);
+	}
+}
 
-	m_velocity = Vec3(horizontalVelocity.x, horizontalVelocity.y, m_velocity.z);
-	m_orientation.m_pitchDegrees = GetClamped(m_orientation.m_pitchDegrees, -85.f, 85.f);
+void Player::RequestRespawn()
+{
+	// Goes through the tick input like every other button so recordings replay it
+	m_respawnRequested = true;
 }
 
 void Player::Respawn()
 {
-	m_position = Vec3::ZERO;
-	m_velocity = Vec3::ZERO;
+	m_simState.Respawn();
+	m_jumpRequested = false;
+	m_respawnRequested = false;
+	ResetPresentation();
+}
+
+void Player::ResetPresentation()
+{
+	// Interpolation starts over from the spawn point
+	m_previousPosition = Vec3::ZERO;
+	m_renderPosition = Vec3::ZERO;
 	m_orientation = EulerAngles::ZERO;
-	m_isGrounded = false;
+	m_shadowRaycast = RaycastResult3D();
 }
 
-void Player::PlayAnimation(std::string const& name)
+void Player::FireAnimTrigger(AnimTrigger trigger)
 {
-	for (int animIndex = 0; animIndex < static_cast<int>(m_playerDef->m_animationGroups.size()); ++animIndex)
+	int nextState = m_playerDef->m_animStateMachine.GetNextState(m_animState, trigger);
+	if (nextState != INVALID_ANIM_STATE)
 	{
-		if (m_playerDef->m_animationGroups[animIndex]->m_animationGroupName.compare(name) == 0)
-		{
-			if (m_animGroup != m_playerDef->m_animationGroups[animIndex])
-			{
-				m_animGroup = m_playerDef->m_animationGroups[animIndex];
-				m_animationClock->Reset();
-			}
-			break;
-		}
+		PlayAnimation(nextState);
+	}
+}
+
+void Player::PlayAnimation(int animState)
+{
+	if (animState != m_animState)
+	{
+		m_animState = animState;
+		m_animGroup = m_playerDef->m_animationGroups[animState];
+		m_animationClock->Reset();
 	}
 }
@@ -1,13 +1,19 @@
 #pragma once
+#include "Game/SimRunner.hpp"
+#include "Game/AnimationStateMachine.hpp"
 #include "Engine/Renderer/Camera.h"
 #include "Engine/Core/Vertex_PCU.h"
+#include "Engine/Math/RaycastUtils.hpp"
 #include <vector>
 #include <string>
 // -----------------------------------------------------------------------------
 class  Game;
 class  AnimationGroup;
 struct PlayerDefinition;
+struct PlayerMesh;
 class  Clock;
+class  SimLevel;
+class  VertexBuffer;
 // -----------------------------------------------------------------------------
 class Player
 {
@@ -18,7 +24,10 @@ public:
 	void InitializePlayerGeometry();
 
 	void Update(float deltaSeconds);
+	unsigned int FixedUpdate(SimLevel const& level, SimInput simInput, float fixedDeltaSeconds);
+	void UpdateRenderPosition(float tickFraction);
 	void UpdateAnimation();
+	void UpdateSpriteFrame();		// After the cameras, the frame depends on the viewing direction
 	void ToggleShadow();
 
 	void  DrawDebug() const;
@@ -27,34 +36,36 @@ public:
 	Mat44 GetShadowToWorldTransform() const;
 
 	Vec3  GetForwardNormal() const;
-	void  PlayerInput(float deltaseconds);
+	SimInput ConsumeSimInput();
+	void  RequestRespawn();
+	void  HandleSimEvents(unsigned int simEvents);
 	void  Respawn();
-	void  PlayAnimation(std::string const& name);
-
-	Vec3 m_gravityDirection = Vec3(0.f, 0.f, -1.f);
+	void  ResetPresentation();
+	void  FireAnimTrigger(AnimTrigger trigger);
+	void  PlayAnimation(int animState);
 
 public:
 	Game* m_game = nullptr;
 	Rgba8 m_color = Rgba8::WHITE;
-	Vec3 m_position = Vec3::ZERO;
-	Vec3 m_velocity = Vec3::ZERO;
-	Vec3 m_acceleration = Vec3::ZERO;
-	float  m_physicsRadius = 0.0f;
-	float  m_physicsHeight = 0.0f;
+	SimRunnerParams m_simParams;
+	SimRunnerState  m_simState;
+	Vec3 m_previousPosition = Vec3::ZERO;	// Position at the start of the last fixed tick
+	Vec3 m_renderPosition = Vec3::ZERO;		// Interpolated between ticks, used for rendering and the camera
 	EulerAngles m_orientation = EulerAngles::ZERO;
-	float  m_gravityForce = -30.f;
-	bool   m_isGrounded = false;
+	RaycastResult3D m_shadowRaycast;
 	PlayerDefinition* m_playerDef = nullptr;
 
 private:
 	Camera m_playerCamera;
-	std::vector<Vertex_PCU> m_playerVerts;
+	PlayerMesh const* m_bodyMesh = nullptr;		// Owned by the game's PlayerMeshCache
 	std::vector<Vertex_PCU> m_overlayVerts;
+	VertexBuffer* m_spriteFrameVBO = nullptr;		// The definition's quad for the current frame
 	bool m_drawDebug = false;
-	float m_playerJumpForce = 0.0f;
+	bool m_jumpRequested = false;
+	bool m_respawnRequested = false;
 
 	Clock* m_animationClock = nullptr;
 	AnimationGroup* m_animGroup = nullptr;
-	bool m_isTurning = false;
+	int  m_animState = INVALID_ANIM_STATE;		// Index of m_animGroup in the definition
 	bool m_showShadow = true;
 };
\ No newline at end of file
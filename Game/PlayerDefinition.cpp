@@ -1,12 +1,17 @@
 #include "Game/PlayerDefinition.hpp"
 #include "Game/AnimationGroup.hpp"
 #include "Game/GameCommon.h"
+#include "Game/ShaderLibrary.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/VertexUtils.h"
 #include "Engine/Renderer/Renderer.h"
 
 std::vector<PlayerDefinition*> PlayerDefinition::s_playerDefs;
 
-PlayerDefinition::PlayerDefinition(XmlElement const& playerDefElement)
+// Kept while any sprite sheet is still loading, its animation elements are parsed after
+static XmlDocument* s_pendingPlayerDefsXml = nullptr;
+
+PlayerDefinition::PlayerDefinition(XmlElement const& playerDefElement, AsyncAssetLoader& assetLoader)
 {
 	m_playerName = ParseXmlAttribute(playerDefElement, "name", m_playerName);
 	m_isVisible = ParseXmlAttribute(playerDefElement, "visible", m_isVisible);
@@ -14,7 +19,16 @@ PlayerDefinition::PlayerDefinition(XmlElement const& playerDefElement)
 	ParseCollision(playerDefElement);
 	ParsePhysics(playerDefElement);
 	ParseCamera(playerDefElement);
-	ParseVisuals(playerDefElement);
+	ParseVisuals(playerDefElement, assetLoader);
+}
+
+PlayerDefinition::~PlayerDefinition()
+{
+	for (VertexBuffer* spriteFrameVBO : m_spriteFrameVBOs)
+	{
+		delete spriteFrameVBO;
+	}
+	m_spriteFrameVBOs.clear();
 }
 
 void PlayerDefinition::ParseCollision(XmlElement const& playerDefElement)
@@ -25,8 +39,7 @@ void PlayerDefinition::ParseCollision(XmlElement const& playerDefElement)
 		return;
 	}
 
-	m_physicsRadius		 = ParseXmlAttribute(*collisionElement, "physicsRadius", m_physicsRadius);
-	m_physicsHeight		 = ParseXmlAttribute(*collisionElement, "physicsHeight", m_physicsHeight);
+	m_simParams.ParseCollision(*collisionElement);
 	m_collidesWithBlocks = ParseXmlAttribute(*collisionElement, "collidesWithBlock", m_collidesWithBlocks);
 }
 
@@ -39,9 +52,7 @@ void PlayerDefinition::ParsePhysics(XmlElement const& playerDefElement)
 	}
 
 	m_isSimulated = ParseXmlAttribute(*physicsElement, "simulated", m_isSimulated);
-	m_moveSpeed	  = ParseXmlAttribute(*physicsElement, "moveSpeed", m_moveSpeed);
-	m_strafeSpeed = ParseXmlAttribute(*physicsElement, "strafeSpeed", m_strafeSpeed);
-	m_jumpForce   = ParseXmlAttribute(*physicsElement, "jumpForce", m_jumpForce);
+	m_simParams.ParsePhysics(*physicsElement);
 }
 
 void PlayerDefinition::ParseCamera(XmlElement const& playerDefElement)
@@ -55,7 +66,7 @@ void PlayerDefinition::ParseCamera(XmlElement const& playerDefElement)
 	m_cameraFOV = ParseXmlAttribute(*cameraElement, "cameraFOV", m_cameraFOV);
 }
 
-void PlayerDefinition::ParseVisuals(XmlElement const& playerDefElement)
+void PlayerDefinition::ParseVisuals(XmlElement const& playerDefElement, AsyncAssetLoader& assetLoader)
 {
 	XmlElement const* visualElement = playerDefElement.FirstChildElement("Visuals");
 	if (!visualElement)
@@ -90,26 +101,91 @@ void PlayerDefinition::ParseVisuals(XmlElement const& playerDefElement)
 	}
 	else
 	{
-		m_shader = g_theRenderer->CreateShader(shader.c_str(), VertexType::VERTEX_PCUTBN);
+		m_shader = g_theShaderLibrary->CreateOrGetShader(shader, VertexType::VERTEX_PCUTBN);
 	}
 
 	std::string spritesheet = ParseXmlAttribute(*visualElement, "spriteSheet", spritesheet);
 	m_cellCount = ParseXmlAttribute(*visualElement, "cellCount", m_cellCount);
-	Texture* spriteSheetTextureImg = g_theRenderer->CreateOrGetTextureFromFile(spritesheet.c_str());
-	m_spriteSheet = new SpriteSheet(*spriteSheetTextureImg, m_cellCount);
+	m_spriteSheetTexture = assetLoader.RequestTexture(spritesheet);
+	m_pendingVisualsElement = visualElement;
+}
+
+void PlayerDefinition::FinishVisuals(Texture& spriteSheetTexture)
+{
+	m_spriteSheet = new SpriteSheet(spriteSheetTexture, m_cellCount);
 
-	XmlElement const* animGroupElement = visualElement->FirstChildElement("AnimationGroup");
+	XmlElement const* animGroupElement = m_pendingVisualsElement->FirstChildElement("AnimationGroup");
 	while (animGroupElement != nullptr)
 	{
 		AnimationGroup* animGroup = new AnimationGroup(*animGroupElement, m_spriteSheet);
 		m_animationGroups.push_back(animGroup);
 		animGroupElement = animGroupElement->NextSiblingElement("AnimationGroup");
 	}
+	m_animStateMachine.Compile(m_pendingVisualsElement->FirstChildElement("AnimationStates"), m_animationGroups, m_playerName);
+	m_pendingVisualsElement = nullptr;
+	CreateSpriteFrameBuffers();
+}
+
+void PlayerDefinition::AddVertsForSprite(std::vector<Vertex_PCUTBN>& verts, AABB2 const& spriteUVs) const
+{
+	Vec3 spriteOffsetSize = -Vec3(0.f, m_spriteSize.x, m_spriteSize.y);
+	Vec3 spriteOffsetPivot = Vec3(0.f, m_spritePivot.x, m_spritePivot.y);
+	Vec3 spriteOffset = (spriteOffsetSize * spriteOffsetPivot);
+
+	Vec3 bL = Vec3::ZERO;
+	Vec3 bR = (Vec3::YAXE * m_spriteSize.x);
+	Vec3 tR = (Vec3::YAXE * m_spriteSize.x) + (Vec3::ZAXE * m_spriteSize.y);
+	Vec3 tL = (Vec3::ZAXE * m_spriteSize.y);
+
+	if (m_renderRounded)
+	{
+		AddVertsForRoundedQuad3D(verts, bL, bR, tR, tL, Rgba8::WHITE, spriteUVs);
+	}
+	else
+	{
+		AddVertsForQuad3D(verts, bL, bR, tR, tL, Rgba8::WHITE, spriteUVs);
+	}
+	TransformVertexArrayTBN3D(verts, Mat44::MakeTranslation3D(spriteOffset));
+}
+
+void PlayerDefinition::CreateSpriteFrameBuffers()
+{
+	if (!m_isVisible)
+	{
+		return;
+	}
+
+	// Every frame is tessellated and uploaded here once, a frame change at runtime only swaps buffers
+	std::vector<Vertex_PCUTBN> spriteVerts;
+	for (AnimationGroup const* animGroup : m_animationGroups)
+	{
+		m_firstSpriteFrameVBOs.push_back(static_cast<int>(m_spriteFrameVBOs.size()));
+		for (AABB2 const& frameUVs : animGroup->m_frameUVs)
+		{
+			spriteVerts.clear();
+			AddVertsForSprite(spriteVerts, frameUVs);
+			unsigned int spriteBytes = static_cast<unsigned int>(spriteVerts.size()) * sizeof(Vertex_PCUTBN);
+			VertexBuffer* spriteFrameVBO = g_theRenderer->CreateVertexBuffer(spriteBytes, sizeof(Vertex_PCUTBN));
+			g_theRenderer->CopyCPUToGPU(spriteVerts.data(), spriteBytes, spriteFrameVBO);
+			m_spriteFrameVBOs.push_back(spriteFrameVBO);
+			m_numSpriteFrameVerts = static_cast<unsigned int>(spriteVerts.size());
+		}
+	}
 }
 
-void PlayerDefinition::InitializePlayerDefintions()
+VertexBuffer* PlayerDefinition::GetSpriteFrameBuffer(int animationIndex, int flipbookFrame) const
 {
-	XmlDocument playerDefsXml;
+	if (animationIndex < 0 || animationIndex >= static_cast<int>(m_firstSpriteFrameVBOs.size()))
+	{
+		return nullptr;
+	}
+	return m_spriteFrameVBOs[m_firstSpriteFrameVBOs[animationIndex] + flipbookFrame];
+}
+
+void PlayerDefinition::InitializePlayerDefintions(AsyncAssetLoader& assetLoader)
+{
+	s_pendingPlayerDefsXml = new XmlDocument();
+	XmlDocument& playerDefsXml = *s_pendingPlayerDefsXml;
 	char const* filePath = "Data/Definitions/PlayerDefinitions.xml";
 	XmlError result = playerDefsXml.LoadFile(filePath);
 	GUARANTEE_OR_DIE(result == tinyxml2::XML_SUCCESS, Stringf("Failed to open required player definitions file \"s\"", filePath));
@@ -122,10 +198,56 @@ void PlayerDefinition::InitializePlayerDefintions()
 	{
 		std::string elementName = playerDefElement->Name();
 		GUARANTEE_OR_DIE(elementName == "PlayerDefinition", Stringf("Root child element in %s was <%s>, must be <PlayerDefinitions>!", filePath, elementName.c_str()));
-		PlayerDefinition* newPlayerDefinition = new PlayerDefinition(*playerDefElement);
+		PlayerDefinition* newPlayerDefinition = new PlayerDefinition(*playerDefElement, assetLoader);
 		s_playerDefs.push_back(newPlayerDefinition);
 		playerDefElement = playerDefElement->NextSiblingElement();
 	}
+
+	// Definitions without visuals are already complete
+	UpdatePendingVisuals(assetLoader);
+}
+
+void PlayerDefinition::UpdatePendingVisuals(AsyncAssetLoader& assetLoader)
+{
+	if (s_pendingPlayerDefsXml == nullptr)
+	{
+		return;
+	}
+
+	bool isAnyPending = false;
+	for (PlayerDefinition* playerDef : s_playerDefs)
+	{
+		if (playerDef->m_pendingVisualsElement == nullptr)
+		{
+			continue;
+		}
+		if (assetLoader.IsTextureReady(playerDef->m_spriteSheetTexture))
+		{
+			playerDef->FinishVisuals(*assetLoader.GetTexture(playerDef->m_spriteSheetTexture));
+		}
+		else
+		{
+			isAnyPending = true;
+		}
+	}
+
+	if (!isAnyPending)
+	{
+		delete s_pendingPlayerDefsXml;
+		s_pendingPlayerDefsXml = nullptr;
+	}
+}
+
+void PlayerDefinition::WaitForPendingVisuals(AsyncAssetLoader& assetLoader)
+{
+	for (PlayerDefinition* playerDef : s_playerDefs)
+	{
+		if (playerDef->m_pendingVisualsElement != nullptr)
+		{
+			assetLoader.WaitForTexture(playerDef->m_spriteSheetTexture);
+		}
+	}
+	UpdatePendingVisuals(assetLoader);
 }
 
 void PlayerDefinition::ClearPlayerDefinitions()
@@ -136,6 +258,9 @@ void PlayerDefinition::ClearPlayerDefinitions()
 		s_playerDefs[playerDefIndex] = nullptr;
 	}
 	s_playerDefs.clear();
+
+	delete s_pendingPlayerDefsXml;
+	s_pendingPlayerDefsXml = nullptr;
 }
 
 PlayerDefinition* PlayerDefinition::GetPlayerByName(std::string const& playerName)
@@ -150,14 +275,14 @@ PlayerDefinition* PlayerDefinition::GetPlayerByName(std::string const& playerNam
 	return nullptr;
 }
 
-AnimationGroup* PlayerDefinition::GetAnimationByName(std::string const& animationName)
+int PlayerDefinition::GetAnimationIndex(std::string const& animationName) const
 {
 	for (int animDefIndex = 0; animDefIndex < static_cast<int>(m_animationGroups.size()); ++animDefIndex)
 	{
 		if (m_animationGroups[animDefIndex]->m_animationGroupName == animationName)
 		{
-			return m_animationGroups[animDefIndex];
+			return animDefIndex;
 		}
 	}
-	return nullptr;
+	return INVALID_ANIM_STATE;
 }
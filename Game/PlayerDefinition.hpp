@@ -1,36 +1,49 @@
 #pragma once
+#include "Game/SimRunner.hpp"
+#include "Game/AsyncAssetLoader.hpp"
+#include "Game/AnimationStateMachine.hpp"
 #include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/MathUtils.h"
 #include <vector>
 // -----------------------------------------------------------------------------
 class AnimationGroup;
 class Shader;
 class SpriteSheet;
+class Texture;
+class VertexBuffer;
 // -----------------------------------------------------------------------------
 struct PlayerDefinition
 {
-	PlayerDefinition(XmlElement const& playerDefElement);
+	PlayerDefinition(XmlElement const& playerDefElement, AsyncAssetLoader& assetLoader);
+	~PlayerDefinition();
 	static std::vector<PlayerDefinition*> s_playerDefs;
-	static void InitializePlayerDefintions();
+	static void InitializePlayerDefintions(AsyncAssetLoader& assetLoader);
 	static void ClearPlayerDefinitions();
-	static PlayerDefinition* GetPlayerByName(std::string const& playerName);
-	AnimationGroup* GetAnimationByName(std::string const& animationName);
+
+	// Sprite sheets and animations are built once their texture has loaded, both are
+	// null until then. Update never blocks, Wait does and is for just before a player is made
+	static void UpdatePendingVisuals(AsyncAssetLoader& assetLoader);
+	static void WaitForPendingVisuals(AsyncAssetLoader& assetLoader);
+	static PlayerDefinition* GetPlayerByName(std::string const& playerName);		// Load time only, players keep the pointer
+	int GetAnimationIndex(std::string const& animationName) const;				// INVALID_ANIM_STATE if missing
 // -----------------------------------------------------------------------------
 	void ParseCollision(XmlElement const& playerDefElement);
 	void ParsePhysics(XmlElement const& playerDefElement);
 	void ParseCamera(XmlElement const& playerDefElement);
-	void ParseVisuals(XmlElement const& playerDefElement);
+	void ParseVisuals(XmlElement const& playerDefElement, AsyncAssetLoader& assetLoader);
+	void FinishVisuals(Texture& spriteSheetTexture);
+	void AddVertsForSprite(std::vector<Vertex_PCUTBN>& verts, AABB2 const& spriteUVs) const;		// Sized and pivoted quad showing one frame
+	void CreateSpriteFrameBuffers();
+	VertexBuffer* GetSpriteFrameBuffer(int animationIndex, int flipbookFrame) const;
 // -----------------------------------------------------------------------------
 	std::string m_playerName		 = "default";
 	bool		m_isVisible			 = false;
-	float		m_physicsRadius		 = 0.0f;
-	float		m_physicsHeight		 = 0.0f;
 	bool		m_collidesWithBlocks = false;
 	bool		m_isSimulated		 = false;
-	float		m_moveSpeed			 = 0.0f;
-	float		m_strafeSpeed		 = 0.0f;
-	float		m_jumpForce			 = 0.0f;
 	float		m_cameraFOV			 = 0.0f;
+	SimRunnerParams m_simParams;
 // -----------------------------------------------------------------------------
 	Vec2		  m_spriteSize = Vec2::ONE;
 	Vec2          m_spritePivot = Vec2::ONEHALF;
@@ -39,9 +52,16 @@ struct PlayerDefinition
 	bool		  m_renderRounded = false;
 	Shader* m_shader = nullptr;
 	SpriteSheet* m_spriteSheet = nullptr;
+	TextureHandle m_spriteSheetTexture = INVALID_TEXTURE_HANDLE;
+	XmlElement const* m_pendingVisualsElement = nullptr;		// Into the kept definitions XML until FinishVisuals
 	IntVec2       m_cellCount = IntVec2::ONE;
 	Vec3		  m_direction = Vec3::XAXE;
 	int			  m_startFrame = 0;
 	int			  m_endFrame = 0;
 	std::vector<AnimationGroup*> m_animationGroups;
+	AnimationStateMachine m_animStateMachine;			// States index m_animationGroups
+	// One static quad per flipbook frame of every animation group, players only pick one
+	std::vector<VertexBuffer*> m_spriteFrameVBOs;
+	std::vector<int>		   m_firstSpriteFrameVBOs;		// Parallel to m_animationGroups
+	unsigned int			   m_numSpriteFrameVerts = 0;
 };
\ No newline at end of file
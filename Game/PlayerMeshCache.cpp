@@ -0,0 +1,96 @@
+#include "Game/PlayerMeshCache.hpp"
+#include "Game/GameCommon.h"
+#include "Engine/Core/VertexUtils.h"
+#include "Engine/Renderer/Renderer.h"
+// -----------------------------------------------------------------------------
+PlayerMeshCache::~PlayerMeshCache()
+{
+	for (CachedMesh& cachedMesh : m_meshes)
+	{
+		delete cachedMesh.m_mesh->m_vertexBuffer;
+		delete cachedMesh.m_mesh;
+	}
+	m_meshes.clear();
+}
+
+PlayerMesh const* PlayerMeshCache::CreateOrGetBodyMesh(PlayerDefinition const* playerDef, Rgba8 const& color, float physicsRadius, float physicsHeight)
+{
+	for (CachedMesh const& cachedMesh : m_meshes)
+	{
+		if (cachedMesh.m_playerDef == playerDef && cachedMesh.m_color == color && cachedMesh.m_physicsRadius == physicsRadius && cachedMesh.m_physicsHeight == physicsHeight)
+		{
+			return cachedMesh.m_mesh;
+		}
+	}
+
+	std::vector<Vertex_PCU> bodyVerts;
+	AddVertsForBody(bodyVerts, color, physicsRadius, physicsHeight);
+
+	PlayerMesh* mesh = new PlayerMesh();
+	mesh->m_numVerts = static_cast<int>(bodyVerts.size());
+	mesh->m_vertexBuffer = g_theRenderer->CreateVertexBuffer(static_cast<unsigned int>(bodyVerts.size()) * sizeof(Vertex_PCU), sizeof(Vertex_PCU));
+	g_theRenderer->CopyCPUToGPU(bodyVerts.data(), mesh->m_vertexBuffer->GetSize(), mesh->m_vertexBuffer);
+
+	CachedMesh cachedMesh;
+	cachedMesh.m_playerDef = playerDef;
+	cachedMesh.m_color = color;
+	cachedMesh.m_physicsRadius = physicsRadius;
+	cachedMesh.m_physicsHeight = physicsHeight;
+	cachedMesh.m_mesh = mesh;
+	m_meshes.push_back(cachedMesh);
+	return mesh;
+}
+
+int PlayerMeshCache::GetNumMeshes() const
+{
+	return static_cast<int>(m_meshes.size());
+}
+
+void PlayerMeshCache::AddVertsForBody(std::vector<Vertex_PCU>& verts, Rgba8 const& color, float physicsRadius, float physicsHeight)
+{
+	float bodyRadius = physicsRadius * 0.6f;
+	float bodyHeight = physicsHeight * 0.6f;
+
+	// Body
+	Vec3 bodyCenter = Vec3(0.f, 0.f, bodyHeight * 0.25f);
+	AddVertsForSphere3D(verts, bodyCenter, bodyRadius, color);
+
+	// Arms
+	float armRadius = bodyRadius * 0.3f;
+	Vec3 leftShoulder = bodyCenter + Vec3(0.f, bodyRadius - armRadius * 0.5f, 0.f);
+	Vec3 leftHand = leftShoulder + Vec3(0.f, bodyRadius * 0.8f, -bodyHeight * 0.3f);
+	Vec3 rightShoulder = bodyCenter + Vec3(0.f, -bodyRadius + armRadius * 0.5f, 0.f);
+	Vec3 rightHand = rightShoulder + Vec3(0.f, -bodyRadius * 0.8f, -bodyHeight * 0.3f);
+	AddVertsForCylinder3D(verts, leftShoulder, leftHand, bodyRadius * 0.3f, color);
+	AddVertsForCylinder3D(verts, rightShoulder, rightHand, bodyRadius * 0.3f, color);
+
+	// Legs
+	Vec3 leftHip = Vec3(0.f, bodyRadius * 0.5f, 0.15f);
+	Vec3 leftFoot = leftHip + Vec3(0.f, bodyRadius * 0.25f, -bodyHeight * 0.9f);
+	Vec3 rightHip = Vec3(0.f, -bodyRadius * 0.5f, 0.15f);
+	Vec3 rightFoot = rightHip + Vec3(0.f, -bodyRadius * 0.25f, -bodyHeight * 0.9f);
+	AddVertsForCylinder3D(verts, leftHip, leftFoot, bodyRadius * 0.35f, color);
+	AddVertsForCylinder3D(verts, rightHip, rightFoot, bodyRadius * 0.35f, color);
+
+	// Antennas
+	float antennaLength = bodyHeight * 0.5f;
+	float antennaRadius = bodyRadius * 0.1f;
+	float antennaBallRadius = antennaRadius * 1.9f;
+	float antennaBaseOffsetZ = -bodyRadius * 0.2f;
+
+	Vec3 topOfHead = bodyCenter + Vec3(0.f, 0.f, bodyRadius + antennaBaseOffsetZ);
+	Vec3 leftAntennaDir = Vec3(0.4f, 0.4f, 1.0f).GetNormalized();
+	Vec3 rightAntennaDir = Vec3(-0.4f, -0.4f, 1.0f).GetNormalized();
+
+	// Left antenna
+	Vec3 antennaBaseLeft = topOfHead + Vec3(0.f, bodyRadius * 0.3f, 0.f);
+	Vec3 antennaTipLeft = antennaBaseLeft + leftAntennaDir * antennaLength;
+	AddVertsForCylinder3D(verts, antennaBaseLeft, antennaTipLeft, antennaRadius, color);
+	AddVertsForSphere3D(verts, antennaTipLeft, antennaBallRadius, color);
+
+	// Right antenna
+	Vec3 antennaBaseRight = topOfHead + Vec3(0.f, -bodyRadius * 0.3f, 0.f);
+	Vec3 antennaTipRight = antennaBaseRight + rightAntennaDir * antennaLength;
+	AddVertsForCylinder3D(verts, antennaBaseRight, antennaTipRight, antennaRadius, color);
+	AddVertsForSphere3D(verts, antennaTipRight, antennaBallRadius, color);
+}
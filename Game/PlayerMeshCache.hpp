@@ -0,0 +1,42 @@
+#pragma once
+#include "Engine/Core/Rgba8.h"
+#include "Engine/Core/Vertex_PCU.h"
+#include <vector>
+// -----------------------------------------------------------------------------
+struct PlayerDefinition;
+class VertexBuffer;
+// -----------------------------------------------------------------------------
+struct PlayerMesh
+{
+	VertexBuffer* m_vertexBuffer = nullptr;
+	int			  m_numVerts = 0;
+};
+// -----------------------------------------------------------------------------
+// Tessellated player bodies, built once per definition, color and physics size
+// and kept in vertex buffers for the whole session. Players only hold a pointer,
+// so switching characters tessellates nothing and drawing uploads nothing.
+// -----------------------------------------------------------------------------
+class PlayerMeshCache
+{
+public:
+	~PlayerMeshCache();
+
+	// Around the origin, the draw transform places it
+	PlayerMesh const* CreateOrGetBodyMesh(PlayerDefinition const* playerDef, Rgba8 const& color, float physicsRadius, float physicsHeight);
+	int GetNumMeshes() const;
+
+private:
+	static void AddVertsForBody(std::vector<Vertex_PCU>& verts, Rgba8 const& color, float physicsRadius, float physicsHeight);
+
+private:
+	struct CachedMesh
+	{
+		PlayerDefinition const* m_playerDef = nullptr;
+		Rgba8		m_color;
+		float		m_physicsRadius = 0.f;
+		float		m_physicsHeight = 0.f;
+		PlayerMesh* m_mesh = nullptr;		// Separately allocated so handed out pointers stay valid
+	};
+
+	std::vector<CachedMesh> m_meshes;
+};
@@ -0,0 +1,232 @@
+#include "Game/RenderQueue.hpp"
+#include "Game/GameCommon.h"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <algorithm>
+#include <cstring>
+// -----------------------------------------------------------------------------
+// Sort key, high bits first: layer, translucent, shader, texture, depth, rasterizer, blend, packet index
+constexpr int SORT_KEY_PACKET_BITS = 16;
+constexpr int SORT_KEY_MODE_BITS = 3;
+constexpr int SORT_KEY_ID_BITS = 10;
+constexpr uint64_t SORT_KEY_ID_MASK = (1ull << SORT_KEY_ID_BITS) - 1;
+constexpr uint64_t SORT_KEY_MODE_MASK = (1ull << SORT_KEY_MODE_BITS) - 1;
+static_assert(MAX_RENDER_PACKETS_PER_SUBMIT <= (1 << SORT_KEY_PACKET_BITS), "Packet index must fit in the sort key");
+// -----------------------------------------------------------------------------
+void RenderQueue::AddVertexBuffer(RenderCommand const& command, VertexBuffer* vertexBuffer, unsigned int numVerts)
+{
+	DrawPacket& packet = AddPacket(command, DrawType::VERTEX_BUFFER);
+	packet.m_vertexBuffer = vertexBuffer;
+	packet.m_count = numVerts;
+}
+
+void RenderQueue::AddIndexedVertexBuffer(RenderCommand const& command, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned int numIndices)
+{
+	DrawPacket& packet = AddPacket(command, DrawType::INDEXED_VERTEX_BUFFER);
+	packet.m_vertexBuffer = vertexBuffer;
+	packet.m_indexBuffer = indexBuffer;
+	packet.m_count = numIndices;
+}
+
+void RenderQueue::AddVertexArray(RenderCommand const& command, std::vector<Vertex_PCU> const& verts)
+{
+	DrawPacket& packet = AddPacket(command, DrawType::VERTEX_ARRAY);
+	packet.m_verts = &verts;
+	packet.m_count = static_cast<unsigned int>(verts.size());
+}
+
+void RenderQueue::Submit()
+{
+	for (int packetIndex = 0; packetIndex < m_numPackets; ++packetIndex)
+	{
+		m_sortKeys.push_back(GetSortKey(m_packets[packetIndex].m_command, packetIndex));
+	}
+	std::sort(m_sortKeys.begin(), m_sortKeys.end());
+
+	m_isStateBound = false;
+	for (uint64_t sortKey : m_sortKeys)
+	{
+		DrawPacket const& packet = m_packets[static_cast<int>(sortKey & ((1ull << SORT_KEY_PACKET_BITS) - 1))];
+		ApplyState(packet.m_command);
+		IssueDraw(packet);
+	}
+
+	// Keeps the storage for the next submit
+	m_sortKeys.clear();
+	m_numPackets = 0;
+}
+
+void RenderQueue::EndFrame()
+{
+	GUARANTEE_OR_DIE(m_numPackets == 0, "Render packets were added but never submitted");
+	m_lastFrameStats = m_frameStats;
+	m_frameStats = RenderQueueStats();
+}
+
+RenderQueueStats const& RenderQueue::GetLastFrameStats() const
+{
+	return m_lastFrameStats;
+}
+
+RenderQueue::DrawPacket& RenderQueue::AddPacket(RenderCommand const& command, DrawType drawType)
+{
+	GUARANTEE_OR_DIE(m_numPackets < MAX_RENDER_PACKETS_PER_SUBMIT, "Too many render packets in one submit, raise MAX_RENDER_PACKETS_PER_SUBMIT");
+	if (m_numPackets == static_cast<int>(m_packets.size()))
+	{
+		m_packets.emplace_back();
+	}
+
+	DrawPacket& packet = m_packets[m_numPackets];
+	packet = DrawPacket();
+	packet.m_command = command;
+	packet.m_drawType = drawType;
+	m_numPackets++;
+	return packet;
+}
+
+uint64_t RenderQueue::GetSortKey(RenderCommand const& command, int packetIndex)
+{
+	RenderState const& state = command.m_state;
+	uint64_t isTranslucent = (state.m_blendMode == BlendMode::OPAQUE) ? 0 : 1;
+
+	uint64_t key = static_cast<uint64_t>(command.m_layer);
+	key = (key << 1) | isTranslucent;
+	if (isTranslucent)
+	{
+		// Blending depends on draw order, so translucent draws keep the order they were added in and only opaque ones group by state
+		key <<= (SORT_KEY_ID_BITS * 2) + (SORT_KEY_MODE_BITS * 3);
+		key = (key << SORT_KEY_PACKET_BITS) | static_cast<uint64_t>(packetIndex);
+		return key;
+	}
+
+	key = (key << SORT_KEY_ID_BITS) | (static_cast<uint64_t>(GetShaderID(state.m_shader)) & SORT_KEY_ID_MASK);
+	key = (key << SORT_KEY_ID_BITS) | (static_cast<uint64_t>(GetTextureID(state.m_texture)) & SORT_KEY_ID_MASK);
+	key = (key << SORT_KEY_MODE_BITS) | (static_cast<uint64_t>(state.m_depthMode) & SORT_KEY_MODE_MASK);
+	key = (key << SORT_KEY_MODE_BITS) | (static_cast<uint64_t>(state.m_rasterizerMode) & SORT_KEY_MODE_MASK);
+	key = (key << SORT_KEY_MODE_BITS) | (static_cast<uint64_t>(state.m_blendMode) & SORT_KEY_MODE_MASK);
+
+	// Equal state keeps the order it was added in
+	key = (key << SORT_KEY_PACKET_BITS) | static_cast<uint64_t>(packetIndex);
+	return key;
+}
+
+int RenderQueue::GetShaderID(Shader const* shader)
+{
+	for (int shaderIndex = 0; shaderIndex < static_cast<int>(m_knownShaders.size()); ++shaderIndex)
+	{
+		if (m_knownShaders[shaderIndex] == shader)
+		{
+			return shaderIndex;
+		}
+	}
+	m_knownShaders.push_back(shader);
+	return static_cast<int>(m_knownShaders.size()) - 1;
+}
+
+int RenderQueue::GetTextureID(Texture const* texture)
+{
+	for (int textureIndex = 0; textureIndex < static_cast<int>(m_knownTextures.size()); ++textureIndex)
+	{
+		if (m_knownTextures[textureIndex] == texture)
+		{
+			return textureIndex;
+		}
+	}
+	m_knownTextures.push_back(texture);
+	return static_cast<int>(m_knownTextures.size()) - 1;
+}
+
+void RenderQueue::ApplyState(RenderCommand const& command)
+{
+	RenderState const& state = command.m_state;
+	RenderState const& boundState = m_boundCommand.m_state;
+	int numStateChanges = 0;
+	int numRedundantStateChanges = 0;
+
+	if (!m_isStateBound || state.m_blendMode != boundState.m_blendMode)
+	{
+		g_theRenderer->SetBlendMode(state.m_blendMode);
+		numStateChanges++;
+	}
+	else
+	{
+		numRedundantStateChanges++;
+	}
+
+	if (!m_isStateBound || state.m_rasterizerMode != boundState.m_rasterizerMode)
+	{
+		g_theRenderer->SetRasterizerMode(state.m_rasterizerMode);
+		numStateChanges++;
+	}
+	else
+	{
+		numRedundantStateChanges++;
+	}
+
+	if (!m_isStateBound || state.m_depthMode != boundState.m_depthMode)
+	{
+		g_theRenderer->SetDepthMode(state.m_depthMode);
+		numStateChanges++;
+	}
+	else
+	{
+		numRedundantStateChanges++;
+	}
+
+	if (!m_isStateBound || state.m_shader != boundState.m_shader)
+	{
+		g_theRenderer->BindShader(state.m_shader);
+		numStateChanges++;
+	}
+	else
+	{
+		numRedundantStateChanges++;
+	}
+
+	if (!m_isStateBound || state.m_texture != boundState.m_texture)
+	{
+		g_theRenderer->BindTexture(state.m_texture);
+		numStateChanges++;
+	}
+	else
+	{
+		numRedundantStateChanges++;
+	}
+
+	if (!m_isStateBound || memcmp(&command.m_modelToWorld, &m_boundCommand.m_modelToWorld, sizeof(Mat44)) != 0 || !(command.m_modelColor == m_boundCommand.m_modelColor))
+	{
+		g_theRenderer->SetModelConstants(command.m_modelToWorld, command.m_modelColor);
+		numStateChanges++;
+	}
+	else
+	{
+		numRedundantStateChanges++;
+	}
+
+	m_boundCommand = command;
+	m_isStateBound = true;
+	m_frameStats.m_numStateChanges += numStateChanges;
+	m_frameStats.m_numRedundantStateChanges += numRedundantStateChanges;
+}
+
+void RenderQueue::IssueDraw(DrawPacket const& packet)
+{
+	switch (packet.m_drawType)
+	{
+		case DrawType::VERTEX_BUFFER:
+		{
+			g_theRenderer->DrawVertexBuffer(packet.m_vertexBuffer, packet.m_count);
+			break;
+		}
+		case DrawType::INDEXED_VERTEX_BUFFER:
+		{
+			g_theRenderer->DrawIndexedVertexBuffer(packet.m_vertexBuffer, packet.m_indexBuffer, packet.m_count);
+			break;
+		}
+		case DrawType::VERTEX_ARRAY:
+		{
+			g_theRenderer->DrawVertexArray(*packet.m_verts);
+			break;
+		}
+	}
+	m_frameStats.m_numDraws++;
+}
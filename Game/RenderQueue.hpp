@@ -0,0 +1,106 @@
+#pragma once
+#include "Engine/Core/Rgba8.h"
+#include "Engine/Core/Vertex_PCU.h"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Renderer/Renderer.h"
+#include <cstdint>
+#include <vector>
+// -----------------------------------------------------------------------------
+class IndexBuffer;
+class Shader;
+class Texture;
+class VertexBuffer;
+// -----------------------------------------------------------------------------
+constexpr int MAX_RENDER_PACKETS_PER_SUBMIT = 1 << 16;
+// -----------------------------------------------------------------------------
+// Lower layers draw first, each Submit sorts only what was added since the last
+enum class RenderLayer
+{
+	BACKGROUND,
+	WORLD,
+	MENU,
+	TEXT,
+	COUNT
+};
+// -----------------------------------------------------------------------------
+struct RenderState
+{
+	Shader*			m_shader = nullptr;
+	Texture const*	m_texture = nullptr;
+	BlendMode		m_blendMode = BlendMode::ALPHA;
+	RasterizerMode	m_rasterizerMode = RasterizerMode::SOLID_CULL_NONE;
+	DepthMode		m_depthMode = DepthMode::DISABLED;
+};
+// -----------------------------------------------------------------------------
+struct RenderCommand
+{
+	RenderLayer		m_layer = RenderLayer::WORLD;
+	RenderState		m_state;
+	Mat44			m_modelToWorld;
+	Rgba8			m_modelColor = Rgba8::WHITE;
+};
+// -----------------------------------------------------------------------------
+struct RenderQueueStats
+{
+	int m_numDraws = 0;
+	int m_numStateChanges = 0;			// Binds that reached the renderer
+	int m_numRedundantStateChanges = 0;	// Binds skipped because that state was already set
+};
+// -----------------------------------------------------------------------------
+// Draws are recorded as packets and issued together at Submit, sorted by layer,
+// then opaque before translucent. Opaque draws then sort by shader, texture and
+// the remaining modes, so draws sharing state end up next to each other, while
+// translucent draws stay in the order they were added so they blend correctly.
+// Binds matching what the previous packet left set are skipped. Anything drawn
+// outside the queue may change renderer state, so nothing is assumed bound at
+// the start of a Submit.
+// -----------------------------------------------------------------------------
+class RenderQueue
+{
+public:
+	void AddVertexBuffer(RenderCommand const& command, VertexBuffer* vertexBuffer, unsigned int numVerts);
+	void AddIndexedVertexBuffer(RenderCommand const& command, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, unsigned int numIndices);
+	// The array is read at Submit, frame scratch arrays live long enough
+	void AddVertexArray(RenderCommand const& command, std::vector<Vertex_PCU> const& verts);
+
+	void Submit();
+	void EndFrame();
+	RenderQueueStats const& GetLastFrameStats() const;
+
+private:
+	enum class DrawType
+	{
+		VERTEX_BUFFER,
+		INDEXED_VERTEX_BUFFER,
+		VERTEX_ARRAY
+	};
+
+	struct DrawPacket
+	{
+		RenderCommand					m_command;
+		DrawType						m_drawType = DrawType::VERTEX_BUFFER;
+		VertexBuffer*					m_vertexBuffer = nullptr;
+		IndexBuffer*					m_indexBuffer = nullptr;
+		std::vector<Vertex_PCU> const*	m_verts = nullptr;
+		unsigned int					m_count = 0;
+	};
+
+	DrawPacket& AddPacket(RenderCommand const& command, DrawType drawType);
+	uint64_t GetSortKey(RenderCommand const& command, int packetIndex);
+	int GetShaderID(Shader const* shader);
+	int GetTextureID(Texture const* texture);
+	void ApplyState(RenderCommand const& command);
+	void IssueDraw(DrawPacket const& packet);
+
+private:
+	std::vector<DrawPacket>		m_packets;				// Kept between submits so recording does not allocate
+	std::vector<uint64_t>		m_sortKeys;				// Packet index in the low bits
+	int							m_numPackets = 0;
+	std::vector<Shader const*>	m_knownShaders;			// Index is the shader's sort ID
+	std::vector<Texture const*> m_knownTextures;
+
+	bool						m_isStateBound = false;
+	RenderCommand				m_boundCommand;
+	RenderQueueStats			m_frameStats;
+	RenderQueueStats			m_lastFrameStats;
+};
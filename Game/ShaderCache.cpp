@@ -0,0 +1,166 @@
+#include "Game/ShaderCache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+// -----------------------------------------------------------------------------
+static char const SHADER_CACHE_FOURCC[4] = { 'R', 'N', 'S', 'B' };
+// -----------------------------------------------------------------------------
+struct ShaderCacheFileHeader
+{
+	char	 m_fourCC[4];
+	uint32_t m_version = 0;
+	uint64_t m_key = 0;
+	uint64_t m_bytecodeSize = 0;
+};
+// -----------------------------------------------------------------------------
+static uint64_t HashString(char const* text, size_t length, uint64_t hash)
+{
+	// FNV-1a, a zero byte after each field keeps "ab"+"c" and "a"+"bc" apart
+	for (size_t charIndex = 0; charIndex < length; ++charIndex)
+	{
+		hash ^= static_cast<unsigned char>(text[charIndex]);
+		hash *= 1099511628211ull;
+	}
+	hash *= 1099511628211ull;
+	return hash;
+}
+// -----------------------------------------------------------------------------
+ShaderBytecodeCache::ShaderBytecodeCache(ShaderCompiler& compiler, std::string const& cacheFolder)
+	:m_compiler(compiler),
+	 m_cacheFolder(cacheFolder)
+{
+}
+
+bool ShaderBytecodeCache::GetBytecode(std::string const& source, char const* sourceName, char const* entryPoint, char const* target, std::vector<unsigned char>& out_bytecode)
+{
+	uint64_t key = GetKey(source, entryPoint, target);
+	for (CachedBytecode const& cached : m_memoryCache)
+	{
+		if (cached.m_key == key)
+		{
+			out_bytecode = cached.m_bytecode;
+			m_stats.m_numMemoryHits++;
+			return true;
+		}
+	}
+
+	if (ReadCacheFile(key, out_bytecode))
+	{
+		m_stats.m_numDiskHits++;
+	}
+	else
+	{
+		if (!m_compiler.CompileStage(source, sourceName, entryPoint, target, out_bytecode))
+		{
+			return false;
+		}
+		m_stats.m_numCompiles++;
+		WriteCacheFile(key, out_bytecode);
+	}
+
+	CachedBytecode cached;
+	cached.m_key = key;
+	cached.m_bytecode = out_bytecode;
+	m_memoryCache.push_back(cached);
+	return true;
+}
+
+std::string ShaderBytecodeCache::ApplyDefines(std::string const& source, std::vector<ShaderDefine> const& defines)
+{
+	std::string definedSource;
+	for (ShaderDefine const& define : defines)
+	{
+		definedSource += "#define " + define.m_name + " " + define.m_value + "\n";
+	}
+	if (!defines.empty())
+	{
+		// Keeps compiler line numbers matching the file on disk
+		definedSource += "#line 1\n";
+	}
+	definedSource += source;
+	return definedSource;
+}
+
+uint64_t ShaderBytecodeCache::GetKey(std::string const& source, char const* entryPoint, char const* target) const
+{
+	uint64_t key = 14695981039346656037ull;
+	char const* compilerId = m_compiler.GetCompilerId();
+	key = HashString(compilerId, strlen(compilerId), key);
+	key = HashString(entryPoint, strlen(entryPoint), key);
+	key = HashString(target, strlen(target), key);
+	key = HashString(source.data(), source.size(), key);
+	return key;
+}
+
+ShaderCacheStats const& ShaderBytecodeCache::GetStats() const
+{
+	return m_stats;
+}
+
+std::string ShaderBytecodeCache::GetCacheFilePath(uint64_t key) const
+{
+	char fileName[32];
+	snprintf(fileName, sizeof(fileName), "%016llx.shaderbin", static_cast<unsigned long long>(key));
+	return m_cacheFolder + fileName;
+}
+
+bool ShaderBytecodeCache::ReadCacheFile(uint64_t key, std::vector<unsigned char>& out_bytecode) const
+{
+	std::ifstream file(GetCacheFilePath(key), std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	// A file from another version or cut short by a crash is just a miss
+	ShaderCacheFileHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file || memcmp(header.m_fourCC, SHADER_CACHE_FOURCC, 4) != 0 || header.m_version != SHADER_CACHE_VERSION || header.m_key != key)
+	{
+		return false;
+	}
+
+	out_bytecode.resize(static_cast<size_t>(header.m_bytecodeSize));
+	file.read(reinterpret_cast<char*>(out_bytecode.data()), static_cast<std::streamsize>(out_bytecode.size()));
+	if (!file || file.peek() != std::ifstream::traits_type::eof())
+	{
+		out_bytecode.clear();
+		return false;
+	}
+	return true;
+}
+
+void ShaderBytecodeCache::WriteCacheFile(uint64_t key, std::vector<unsigned char> const& bytecode) const
+{
+	std::error_code errorCode;
+	std::filesystem::create_directories(m_cacheFolder, errorCode);
+
+	ShaderCacheFileHeader header;
+	memcpy(header.m_fourCC, SHADER_CACHE_FOURCC, 4);
+	header.m_version = SHADER_CACHE_VERSION;
+	header.m_key = key;
+	header.m_bytecodeSize = bytecode.size();
+
+	// Written beside the final name and renamed, so a reader never sees half a file
+	std::string filePath = GetCacheFilePath(key);
+	std::string tempPath = filePath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return;
+		}
+		file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		file.write(reinterpret_cast<char const*>(bytecode.data()), static_cast<std::streamsize>(bytecode.size()));
+		if (!file)
+		{
+			return;
+		}
+	}
+	std::filesystem::rename(tempPath, filePath, errorCode);
+	if (errorCode)
+	{
+		std::filesystem::remove(tempPath, errorCode);
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+// -----------------------------------------------------------------------------
+constexpr uint32_t SHADER_CACHE_VERSION = 1;
+// -----------------------------------------------------------------------------
+struct ShaderDefine
+{
+	std::string m_name;
+	std::string m_value;
+};
+// -----------------------------------------------------------------------------
+// Turns one shader stage into bytecode. The cache only sees this interface, so
+// it works the same over D3D, another backend, or a stub that returns canned
+// bytes for testing.
+// -----------------------------------------------------------------------------
+class ShaderCompiler
+{
+public:
+	virtual ~ShaderCompiler() = default;
+
+	// Part of every cache key, change it whenever the compiler or its flags change
+	virtual char const* GetCompilerId() const = 0;
+	virtual bool CompileStage(std::string const& source, char const* sourceName, char const* entryPoint, char const* target, std::vector<unsigned char>& out_bytecode) = 0;
+};
+// -----------------------------------------------------------------------------
+struct ShaderCacheStats
+{
+	int m_numMemoryHits = 0;
+	int m_numDiskHits = 0;
+	int m_numCompiles = 0;
+};
+// -----------------------------------------------------------------------------
+// Content addressed bytecode cache. The key hashes the compiler id, entry point,
+// target and the exact source text with its defines, so an edited shader simply
+// misses and nothing ever needs invalidating. Hits come from memory, then from
+// one file per key in the cache folder, and only then from the compiler.
+// -----------------------------------------------------------------------------
+class ShaderBytecodeCache
+{
+public:
+	ShaderBytecodeCache(ShaderCompiler& compiler, std::string const& cacheFolder);
+
+	bool GetBytecode(std::string const& source, char const* sourceName, char const* entryPoint, char const* target, std::vector<unsigned char>& out_bytecode);
+
+	// Defines go in front of the source as #define lines, so any backend sees them the same way
+	static std::string ApplyDefines(std::string const& source, std::vector<ShaderDefine> const& defines);
+	uint64_t GetKey(std::string const& source, char const* entryPoint, char const* target) const;
+	std::string GetCacheFilePath(uint64_t key) const;
+	ShaderCacheStats const& GetStats() const;
+
+private:
+	bool ReadCacheFile(uint64_t key, std::vector<unsigned char>& out_bytecode) const;
+	void WriteCacheFile(uint64_t key, std::vector<unsigned char> const& bytecode) const;
+
+private:
+	struct CachedBytecode
+	{
+		uint64_t m_key = 0;
+		std::vector<unsigned char> m_bytecode;
+	};
+
+	ShaderCompiler&				m_compiler;
+	std::string					m_cacheFolder;
+	std::vector<CachedBytecode> m_memoryCache;
+	ShaderCacheStats			m_stats;
+};
@@ -0,0 +1,34 @@
+#include "Game/ShaderLibrary.hpp"
+#include "Game/GameCommon.h"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+// -----------------------------------------------------------------------------
+Shader* ShaderLibrary::CreateOrGetShader(std::string const& shaderPath, VertexType vertexType)
+{
+	m_numRequests++;
+	for (LoadedShader const& loadedShader : m_shaders)
+	{
+		if (loadedShader.m_shaderPath == shaderPath && loadedShader.m_vertexType == vertexType)
+		{
+			return loadedShader.m_shader;
+		}
+	}
+
+	LoadedShader loadedShader;
+	loadedShader.m_shaderPath = shaderPath;
+	loadedShader.m_vertexType = vertexType;
+	loadedShader.m_shader = g_theRenderer->CreateShader(shaderPath.c_str(), vertexType);
+	GUARANTEE_OR_DIE(loadedShader.m_shader != nullptr, Stringf("Could not create shader \"%s\"", shaderPath.c_str()));
+	m_shaders.push_back(loadedShader);
+	return loadedShader.m_shader;
+}
+
+int ShaderLibrary::GetNumShaders() const
+{
+	return static_cast<int>(m_shaders.size());
+}
+
+int ShaderLibrary::GetNumRequests() const
+{
+	return m_numRequests;
+}
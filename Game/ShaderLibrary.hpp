@@ -0,0 +1,35 @@
+#pragma once
+#include "Engine/Renderer/Renderer.h"
+#include <string>
+#include <vector>
+// -----------------------------------------------------------------------------
+class Shader;
+// -----------------------------------------------------------------------------
+// Every shader the game asks for goes through here. One shader object exists per
+// source path and vertex type no matter how many definitions name it, so each
+// shader is compiled once per run instead of once per level or player.
+//
+// Stages are still compiled by Renderer::CreateShader from the path. The Engine
+// has no CreateShader that takes bytecode, so ShaderBytecodeCache cannot feed
+// it yet and a warm start compiles every shader once like a cold one.
+// -----------------------------------------------------------------------------
+class ShaderLibrary
+{
+public:
+	// Path without extension like the renderer takes
+	Shader* CreateOrGetShader(std::string const& shaderPath, VertexType vertexType);
+
+	int GetNumShaders() const;
+	int GetNumRequests() const;
+
+private:
+	struct LoadedShader
+	{
+		std::string m_shaderPath;
+		VertexType	m_vertexType = VertexType::VERTEX_PCUTBN;
+		Shader*		m_shader = nullptr;		// Owned by the renderer
+	};
+
+	std::vector<LoadedShader> m_shaders;
+	int						  m_numRequests = 0;
+};
@@ -0,0 +1,182 @@
+#include "Game/SimBatch.hpp"
+#include "Game/SimLevel.hpp"
+#include "Game/WorkStealingPool.hpp"
+// -----------------------------------------------------------------------------
+int SimRunnerBatch::AddRunnerParams(SimRunnerParams const& params)
+{
+	m_params.push_back(params);
+	return static_cast<int>(m_params.size()) - 1;
+}
+
+int SimRunnerBatch::AddScriptedRunner(int paramsIndex, int jumpInterval)
+{
+	SimRunnerState spawnState;
+	m_positionX.push_back(spawnState.m_position.x);
+	m_positionY.push_back(spawnState.m_position.y);
+	m_positionZ.push_back(spawnState.m_position.z);
+	m_velocityX.push_back(spawnState.m_velocity.x);
+	m_velocityY.push_back(spawnState.m_velocity.y);
+	m_velocityZ.push_back(spawnState.m_velocity.z);
+	m_isGrounded.push_back(spawnState.m_isGrounded ? 1 : 0);
+	m_isTurning.push_back(spawnState.m_isTurning ? 1 : 0);
+	m_paramsIndex.push_back(paramsIndex);
+
+	m_jumpInterval.push_back(jumpInterval);
+	m_replayCursor.push_back(InputReplayCursor());
+	m_isReplaying.push_back(0);
+
+	m_numDeaths.push_back(0);
+	m_numCompletions.push_back(0);
+	m_furthestX.push_back(0.f);
+	m_trajectoryHash.push_back(TRAJECTORY_HASH_SEED);
+	return GetNumRunners() - 1;
+}
+
+int SimRunnerBatch::AddReplayRunner(int paramsIndex, InputRecording const* recording)
+{
+	int runnerIndex = AddScriptedRunner(paramsIndex, 0);
+	m_replayCursor[runnerIndex].Reset(recording);
+	m_isReplaying[runnerIndex] = 1;
+	return runnerIndex;
+}
+
+void SimRunnerBatch::Clear()
+{
+	*this = SimRunnerBatch();
+}
+
+void SimRunnerBatch::Simulate(SimLevel const& level, int numTicks, float deltaSeconds, WorkStealingPool& pool)
+{
+	// Runners never see each other, so each task can carry its span through every tick without syncing
+	// and results do not depend on how tasks land on threads
+	RangeTaskFunc simulateSpan = [this, &level, numTicks, deltaSeconds](int firstRunner, int numRunners)
+	{
+		SimulateRunners(level, firstRunner, numRunners, numTicks, deltaSeconds);
+	};
+	pool.ParallelFor(GetNumRunners(), RUNNERS_PER_BATCH_TASK, simulateSpan);
+	m_numTicksSimulated += numTicks;
+}
+
+void SimRunnerBatch::SimulateRunners(SimLevel const& level, int firstRunner, int numRunners, int numTicks, float deltaSeconds)
+{
+	for (int runnerIndex = firstRunner; runnerIndex < firstRunner + numRunners; ++runnerIndex)
+	{
+		// Unpack into the same state struct the game uses so batch and single runs share one tick function bit for bit
+		SimRunnerState state;
+		state.m_position = Vec3(m_positionX[runnerIndex], m_positionY[runnerIndex], m_positionZ[runnerIndex]);
+		state.m_velocity = Vec3(m_velocityX[runnerIndex], m_velocityY[runnerIndex], m_velocityZ[runnerIndex]);
+		state.m_isGrounded = m_isGrounded[runnerIndex] != 0;
+		state.m_isTurning = m_isTurning[runnerIndex] != 0;
+
+		SimRunnerParams const& params = m_params[m_paramsIndex[runnerIndex]];
+		InputReplayCursor& replayCursor = m_replayCursor[runnerIndex];
+		bool isReplaying = m_isReplaying[runnerIndex] != 0;
+		int numDeaths = m_numDeaths[runnerIndex];
+		int numCompletions = m_numCompletions[runnerIndex];
+		float furthestX = m_furthestX[runnerIndex];
+		uint64_t trajectoryHash = m_trajectoryHash[runnerIndex];
+
+		for (int tickIndex = m_numTicksSimulated; tickIndex < m_numTicksSimulated + numTicks; ++tickIndex)
+		{
+			SimInput input = isReplaying ? replayCursor.Next() : GetScriptedInput(runnerIndex, tickIndex);
+			unsigned int simEvents = SimulateRunnerTick(level, params, input, state, deltaSeconds);
+			trajectoryHash = HashRunnerState(state, trajectoryHash);
+
+			if (state.m_position.x > furthestX)
+			{
+				furthestX = state.m_position.x;
+			}
+			if (simEvents & SIM_EVENT_DIED)
+			{
+				++numDeaths;
+			}
+			if (simEvents & SIM_EVENT_REACHED_END_GOAL)
+			{
+				++numCompletions;
+				state.Respawn();
+			}
+		}
+
+		m_positionX[runnerIndex] = state.m_position.x;
+		m_positionY[runnerIndex] = state.m_position.y;
+		m_positionZ[runnerIndex] = state.m_position.z;
+		m_velocityX[runnerIndex] = state.m_velocity.x;
+		m_velocityY[runnerIndex] = state.m_velocity.y;
+		m_velocityZ[runnerIndex] = state.m_velocity.z;
+		m_isGrounded[runnerIndex] = state.m_isGrounded ? 1 : 0;
+		m_isTurning[runnerIndex] = state.m_isTurning ? 1 : 0;
+		m_numDeaths[runnerIndex] = numDeaths;
+		m_numCompletions[runnerIndex] = numCompletions;
+		m_furthestX[runnerIndex] = furthestX;
+		m_trajectoryHash[runnerIndex] = trajectoryHash;
+	}
+}
+
+SimInput SimRunnerBatch::GetScriptedInput(int runnerIndex, int tickIndex) const
+{
+	int jumpInterval = m_jumpInterval[runnerIndex];
+	if (jumpInterval > 0 && (tickIndex % jumpInterval) == 0)
+	{
+		return SIM_INPUT_JUMP;
+	}
+	return SIM_INPUT_NONE;
+}
+
+int SimRunnerBatch::GetNumRunners() const
+{
+	return static_cast<int>(m_positionX.size());
+}
+
+int SimRunnerBatch::GetNumTicksSimulated() const
+{
+	return m_numTicksSimulated;
+}
+
+int SimRunnerBatch::GetTotalDeaths() const
+{
+	int totalDeaths = 0;
+	for (int runnerIndex = 0; runnerIndex < GetNumRunners(); ++runnerIndex)
+	{
+		totalDeaths += m_numDeaths[runnerIndex];
+	}
+	return totalDeaths;
+}
+
+int SimRunnerBatch::GetTotalCompletions() const
+{
+	int totalCompletions = 0;
+	for (int runnerIndex = 0; runnerIndex < GetNumRunners(); ++runnerIndex)
+	{
+		totalCompletions += m_numCompletions[runnerIndex];
+	}
+	return totalCompletions;
+}
+
+float SimRunnerBatch::GetFurthestX() const
+{
+	float furthestX = 0.f;
+	for (int runnerIndex = 0; runnerIndex < GetNumRunners(); ++runnerIndex)
+	{
+		if (m_furthestX[runnerIndex] > furthestX)
+		{
+			furthestX = m_furthestX[runnerIndex];
+		}
+	}
+	return furthestX;
+}
+
+uint64_t SimRunnerBatch::GetCombinedTrajectoryHash() const
+{
+	// Fold per-runner hashes in runner order, independent of which thread ran which runner
+	uint64_t combinedHash = TRAJECTORY_HASH_SEED;
+	for (int runnerIndex = 0; runnerIndex < GetNumRunners(); ++runnerIndex)
+	{
+		uint64_t runnerHash = m_trajectoryHash[runnerIndex];
+		for (int byteIndex = 0; byteIndex < 8; ++byteIndex)
+		{
+			combinedHash ^= (runnerHash >> (byteIndex * 8)) & 0xFF;
+			combinedHash *= 1099511628211ull;
+		}
+	}
+	return combinedHash;
+}
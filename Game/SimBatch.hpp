@@ -0,0 +1,61 @@
+#pragma once
+#include "Game/SimRunner.hpp"
+#include "Game/InputRecording.hpp"
+#include <cstdint>
+#include <vector>
+// -----------------------------------------------------------------------------
+class SimLevel;
+class WorkStealingPool;
+// -----------------------------------------------------------------------------
+constexpr int RUNNERS_PER_BATCH_TASK = 32;
+// -----------------------------------------------------------------------------
+// Many independent runners against one shared, read-only SimLevel. Runner state
+// lives in parallel arrays indexed by runner, so a worker walking a span of
+// runners streams through memory and no two workers ever touch the same entry.
+// -----------------------------------------------------------------------------
+class SimRunnerBatch
+{
+public:
+	int  AddRunnerParams(SimRunnerParams const& params);
+	int  AddScriptedRunner(int paramsIndex, int jumpInterval);
+	int  AddReplayRunner(int paramsIndex, InputRecording const* recording);
+	void Clear();
+
+	void Simulate(SimLevel const& level, int numTicks, float deltaSeconds, WorkStealingPool& pool);
+
+	int		 GetNumRunners() const;
+	int		 GetNumTicksSimulated() const;
+	int		 GetTotalDeaths() const;
+	int		 GetTotalCompletions() const;
+	float	 GetFurthestX() const;
+	uint64_t GetCombinedTrajectoryHash() const;
+
+private:
+	void SimulateRunners(SimLevel const& level, int firstRunner, int numRunners, int numTicks, float deltaSeconds);
+	SimInput GetScriptedInput(int runnerIndex, int tickIndex) const;
+
+public:
+	std::vector<SimRunnerParams> m_params;
+
+	std::vector<float>			m_positionX;
+	std::vector<float>			m_positionY;
+	std::vector<float>			m_positionZ;
+	std::vector<float>			m_velocityX;
+	std::vector<float>			m_velocityY;
+	std::vector<float>			m_velocityZ;
+	std::vector<unsigned char>	m_isGrounded;
+	std::vector<unsigned char>	m_isTurning;
+	std::vector<int>			m_paramsIndex;
+
+	std::vector<int>			   m_jumpInterval;		// Scripted runners only, 0 never jumps
+	std::vector<InputReplayCursor> m_replayCursor;		// Replay runners only
+	std::vector<unsigned char>	   m_isReplaying;
+
+	std::vector<int>			m_numDeaths;
+	std::vector<int>			m_numCompletions;
+	std::vector<float>			m_furthestX;
+	std::vector<uint64_t>		m_trajectoryHash;
+
+private:
+	int m_numTicksSimulated = 0;
+};
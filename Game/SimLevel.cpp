@@ -0,0 +1,317 @@
+#include "Game/SimLevel.hpp"
+#include "Game/LevelDefinition.hpp"
+#include "Game/CookedLevel.hpp"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Math/RaycastUtils.hpp"
+// -----------------------------------------------------------------------------
+void SimLevel::LayoutFromDefinition(LevelDefinition const& levelDef)
+{
+	if (levelDef.m_cookedLevel != nullptr)
+	{
+		LayoutFromCooked(*levelDef.m_cookedLevel);
+		return;
+	}
+
+	for (SpawnInfo const& spawnInfo : levelDef.m_itemSpawnInfo)
+	{
+		if (spawnInfo.m_levelItem == "Block")
+		{
+			AddBlock(spawnInfo.m_center, spawnInfo.m_dimensions, spawnInfo.m_orientation, spawnInfo.m_color);
+		}
+		else if (spawnInfo.m_levelItem == "EndGoal")
+		{
+			SetEndGoal(spawnInfo.m_center, spawnInfo.m_radius, spawnInfo.m_color);
+		}
+	}
+}
+
+void SimLevel::LayoutFromCooked(CookedLevelView const& cookedLevel)
+{
+	// Blocks are already in BVH leaf order, both arrive as bulk copies with nothing to parse or build
+	CookedLevelEntry const& entry = *cookedLevel.m_entry;
+	int numBlocks = static_cast<int>(entry.m_numBlocks);
+	m_blocks.AssignArrays(numBlocks, cookedLevel.m_floatArrays, cookedLevel.m_colors, cookedLevel.m_orientations);
+	m_blockBVH.AdoptPrebuilt(cookedLevel.m_bvhNodes, static_cast<int>(entry.m_numBVHNodes), cookedLevel.m_leafPrimBounds, numBlocks);
+	if (entry.m_hasEndGoal != 0)
+	{
+		SetEndGoal(entry.m_endGoal.m_center, entry.m_endGoal.m_radius, entry.m_endGoal.m_endGoalColor);
+	}
+}
+
+void SimLevel::AddBlock(Vec3 const& center, Vec3 const& dimensions, EulerAngles const& orientation, Rgba8 const& color)
+{
+	m_blocks.AddBlock(center, dimensions, orientation, color);
+}
+
+void SimLevel::SetEndGoal(Vec3 const& center, float radius, Rgba8 const& color)
+{
+	m_endGoal = EndGoal(center, radius, color);
+	m_hasEndGoal = true;
+}
+
+void SimLevel::SetDeathBounds(AABB3 const& deathBounds)
+{
+	m_deathBounds = deathBounds;
+}
+
+void SimLevel::SetBlockColor(int blockIndex, Rgba8 const& color)
+{
+	m_blocks.m_colors[blockIndex] = color;
+}
+
+void SimLevel::BuildBlockBVH()
+{
+	// Cooked levels arrive with theirs
+	if (!m_blockBVH.IsEmpty())
+	{
+		return;
+	}
+
+	std::vector<AABB3> blockBounds;
+	blockBounds.reserve(m_blocks.GetNumBlocks());
+	for (int blockIndex = 0; blockIndex < m_blocks.GetNumBlocks(); ++blockIndex)
+	{
+		blockBounds.push_back(m_blocks.GetBlockWorldBounds(blockIndex));
+	}
+
+	m_blockBVH.Build(blockBounds);
+
+	// Store blocks in leaf order so every BVH leaf is a contiguous run of the block arrays
+	m_blocks.Reorder(m_blockBVH.GetPrimOrder());
+	m_blockBVH.AdoptPrimOrder();
+}
+
+void SimLevel::Clear()
+{
+	m_blocks.Clear();
+	m_blockBVH.Clear();
+	m_endGoal = EndGoal();
+	m_hasEndGoal = false;
+}
+
+void SimLevel::CollideZCylinder(Vec3& position, Vec3& velocity, bool& isGrounded, float radius, float height) const
+{
+	float halfHeight = height * 0.5f;
+	isGrounded = false;
+
+	// Only blocks near the cylinder can push it, pad slightly so blocks touched after an earlier push still get tested
+	float queryPadding = 0.1f;
+	Vec3 cylinderHalfDims = Vec3(radius + queryPadding, radius + queryPadding, halfHeight + queryPadding);
+	AABB3 queryBounds = AABB3(position - cylinderHalfDims, position + cylinderHalfDims);
+
+	BVHPrimRange blockRanges[MAX_COLLISION_RANGES];
+	int numRanges = m_blockBVH.QueryOverlappingLeaves(queryBounds, blockRanges, MAX_COLLISION_RANGES);
+
+	for (int rangeIndex = 0; rangeIndex < numRanges; ++rangeIndex)
+	{
+		BVHPrimRange const& blockRange = blockRanges[rangeIndex];
+		int endBlock = blockRange.m_firstPrim + blockRange.m_primCount;
+
+		for (int firstBlock = blockRange.m_firstPrim; firstBlock < endBlock; firstBlock += BLOCK_SIMD_WIDTH)
+		{
+			int blockCount = endBlock - firstBlock;
+			if (blockCount > BLOCK_SIMD_WIDTH)
+			{
+				blockCount = BLOCK_SIMD_WIDTH;
+			}
+			unsigned int overlapMask = m_blocks.GetZCylinderOverlapMask(firstBlock, blockCount, position, radius, halfHeight);
+			if (overlapMask == 0)
+			{
+				continue;
+			}
+
+			for (int lane = 0; lane < blockCount; ++lane)
+			{
+				if (overlapMask & (1u << lane))
+				{
+					PushZCylinderOutOfBlock(firstBlock + lane, position, velocity, isGrounded, radius, halfHeight);
+				}
+			}
+		}
+	}
+}
+
+void SimLevel::PushZCylinderOutOfBlock(int blockIndex, Vec3& position, Vec3& velocity, bool& isGrounded, float radius, float halfHeight) const
+{
+	// Re-test against the current position, an earlier push this tick may already have separated them
+	Vec3 pushNormal;
+	float pushDepth = 0.f;
+	if (!m_blocks.GetZCylinderPenetration(blockIndex, position, radius, halfHeight, pushNormal, pushDepth))
+	{
+		return;
+	}
+
+	position += pushNormal * pushDepth;
+
+	// Anything flatter than 45 degrees counts as ground
+	if (pushNormal.z > 0.7f)
+	{
+		isGrounded = true;
+	}
+
+	float intoSurfaceSpeed = DotProduct3D(velocity, pushNormal);
+	if (intoSurfaceSpeed < 0.f)
+	{
+		velocity -= pushNormal * intoSurfaceSpeed;
+	}
+}
+
+bool SimLevel::IsZCylinderInDeathBounds(Vec3 const& position, float radius, float height) const
+{
+	return DoZCylinderAndAABB3Overlap3D(position, radius, height, m_deathBounds);
+}
+
+bool SimLevel::IsZCylinderTouchingEndGoal(Vec3 const& position, float radius, float height) const
+{
+	if (!m_hasEndGoal)
+	{
+		return false;
+	}
+	return DoZCylinderAndSphereOverlap3D(position, radius, height, m_endGoal.m_center, m_endGoal.m_radius);
+}
+
+bool SimLevel::RaycastDown(Vec3 const& rayStartPos, float maxDist, Vec3& impactPos) const
+{
+	BlockRay downRay;
+	downRay.m_start = rayStartPos;
+	downRay.m_fwdNormal = -Vec3::ZAXE;
+	downRay.m_maxDist = maxDist;
+
+	RaycastResult3D raycastResult;
+	RaycastBlocks(&downRay, 1, &raycastResult);
+	if (raycastResult.m_didImpact)
+	{
+		impactPos = raycastResult.m_impactPos;
+		return true;
+	}
+	return false;
+}
+
+void SimLevel::RaycastBlocks(BlockRay const* rays, int numRays, RaycastResult3D* out_results) const
+{
+	for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+	{
+		RaycastResult3D& result = out_results[rayIndex];
+		result = RaycastResult3D();
+		result.m_rayStartPosition = rays[rayIndex].m_start;
+		result.m_rayFwdNormal = rays[rayIndex].m_fwdNormal;
+		result.m_rayMaxLength = rays[rayIndex].m_maxDist;
+	}
+
+	if (m_blockBVH.IsEmpty())
+	{
+		return;
+	}
+
+	for (int firstRay = 0; firstRay < numRays; firstRay += RAY_PACKET_SIZE)
+	{
+		int packetSize = numRays - firstRay;
+		if (packetSize > RAY_PACKET_SIZE)
+		{
+			packetSize = RAY_PACKET_SIZE;
+		}
+		RaycastPacket(rays + firstRay, packetSize, out_results + firstRay);
+	}
+}
+
+void SimLevel::RaycastPacket(BlockRay const* rays, int numRays, RaycastResult3D* out_results) const
+{
+	// The whole packet walks the BVH together, each node carries the mask of rays still interested in it.
+	// Rays shrink their max distance as they hit, so later nodes behind the closest hit get culled.
+	Vec3  rayInvFwds[RAY_PACKET_SIZE];
+	float closestDists[RAY_PACKET_SIZE];
+	for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+	{
+		Vec3 const& rayFwd = rays[rayIndex].m_fwdNormal;
+		rayInvFwds[rayIndex] = Vec3(1.f / rayFwd.x, 1.f / rayFwd.y, 1.f / rayFwd.z);
+		closestDists[rayIndex] = rays[rayIndex].m_maxDist;
+	}
+
+	int nodeStack[BVH_MAX_TRAVERSAL_DEPTH];
+	unsigned int rayMaskStack[BVH_MAX_TRAVERSAL_DEPTH];
+	int stackSize = 0;
+	nodeStack[stackSize] = 0;
+	rayMaskStack[stackSize] = (numRays == 32) ? 0xFFFFFFFFu : ((1u << numRays) - 1u);
+	stackSize++;
+
+	while (stackSize > 0)
+	{
+		stackSize--;
+		int nodeIndex = nodeStack[stackSize];
+		unsigned int incomingMask = rayMaskStack[stackSize];
+		BVHNode const& node = m_blockBVH.GetNode(nodeIndex);
+
+		unsigned int activeMask = 0;
+		for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+		{
+			if ((incomingMask & (1u << rayIndex)) && DoesRayHitAABB3(rays[rayIndex].m_start, rayInvFwds[rayIndex], closestDists[rayIndex], node.m_bounds))
+			{
+				activeMask |= (1u << rayIndex);
+			}
+		}
+		if (activeMask == 0)
+		{
+			continue;
+		}
+
+		if (node.m_primCount == 0)
+		{
+			nodeStack[stackSize] = node.m_firstPrimOrRightChild;
+			rayMaskStack[stackSize] = activeMask;
+			stackSize++;
+			nodeStack[stackSize] = nodeIndex + 1;
+			rayMaskStack[stackSize] = activeMask;
+			stackSize++;
+			continue;
+		}
+
+		for (int blockIndex = node.m_firstPrimOrRightChild; blockIndex < node.m_firstPrimOrRightChild + node.m_primCount; ++blockIndex)
+		{
+			for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+			{
+				if ((activeMask & (1u << rayIndex)) == 0)
+				{
+					continue;
+				}
+
+				float impactDist = 0.f;
+				Vec3 impactNormal;
+				if (m_blocks.RaycastBlock(blockIndex, rays[rayIndex], impactDist, impactNormal) && impactDist < closestDists[rayIndex])
+				{
+					closestDists[rayIndex] = impactDist;
+
+					RaycastResult3D& result = out_results[rayIndex];
+					result.m_didImpact = true;
+					result.m_impactDist = impactDist;
+					result.m_impactPos = rays[rayIndex].m_start + (rays[rayIndex].m_fwdNormal * impactDist);
+					result.m_impactNormal = impactNormal;
+				}
+			}
+		}
+	}
+}
+
+LevelBlocks const& SimLevel::GetBlocks() const
+{
+	return m_blocks;
+}
+
+LevelBVH const& SimLevel::GetBlockBVH() const
+{
+	return m_blockBVH;
+}
+
+EndGoal const& SimLevel::GetEndGoal() const
+{
+	return m_endGoal;
+}
+
+bool SimLevel::HasEndGoal() const
+{
+	return m_hasEndGoal;
+}
+
+size_t SimLevel::GetMemoryBytes() const
+{
+	return m_blocks.GetMemoryBytes() + m_blockBVH.GetMemoryBytes();
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "Game/LevelBVH.hpp"
+#include "Game/LevelBlocks.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Core/Rgba8.h"
+// -----------------------------------------------------------------------------
+struct LevelDefinition;
+struct CookedLevelView;
+struct RaycastResult3D;
+struct SimRunnerState;
+// -----------------------------------------------------------------------------
+constexpr int   RAY_PACKET_SIZE = 32;
+constexpr int   MAX_COLLISION_RANGES = 16;
+// -----------------------------------------------------------------------------
+struct EndGoal
+{
+	EndGoal() = default;
+	EndGoal(Vec3 center, float radius, Rgba8 color)
+		:m_center(center), m_radius(radius), m_endGoalColor(color) {}
+	Vec3  m_center = Vec3::ZERO;
+	float m_radius = 0.0f;
+	Rgba8 m_endGoalColor = Rgba8::WHITE;
+};
+// -----------------------------------------------------------------------------
+// Collision data for one level with no renderer, input or game dependencies.
+// Once built every query is const and safe to call from several threads.
+// -----------------------------------------------------------------------------
+class SimLevel
+{
+public:
+	void LayoutFromDefinition(LevelDefinition const& levelDef);
+	void LayoutFromCooked(CookedLevelView const& cookedLevel);
+	void AddBlock(Vec3 const& center, Vec3 const& dimensions, EulerAngles const& orientation, Rgba8 const& color);
+	void SetEndGoal(Vec3 const& center, float radius, Rgba8 const& color);
+	void SetDeathBounds(AABB3 const& deathBounds);
+	void SetBlockColor(int blockIndex, Rgba8 const& color);
+	void BuildBlockBVH();
+	void Clear();
+
+	void CollideZCylinder(Vec3& position, Vec3& velocity, bool& isGrounded, float radius, float height) const;
+	bool IsZCylinderInDeathBounds(Vec3 const& position, float radius, float height) const;
+	bool IsZCylinderTouchingEndGoal(Vec3 const& position, float radius, float height) const;
+
+	bool RaycastDown(Vec3 const& rayStartPos, float maxDist, Vec3& impactPos) const;
+	void RaycastBlocks(BlockRay const* rays, int numRays, RaycastResult3D* out_results) const;
+
+	LevelBlocks const& GetBlocks() const;
+	LevelBVH const& GetBlockBVH() const;
+	EndGoal const& GetEndGoal() const;
+	bool HasEndGoal() const;
+	size_t GetMemoryBytes() const;
+
+private:
+	void PushZCylinderOutOfBlock(int blockIndex, Vec3& position, Vec3& velocity, bool& isGrounded, float radius, float halfHeight) const;
+	void RaycastPacket(BlockRay const* rays, int numRays, RaycastResult3D* out_results) const;
+
+private:
+	LevelBlocks m_blocks;
+	LevelBVH	m_blockBVH;
+	EndGoal		m_endGoal;
+	bool		m_hasEndGoal = false;
+	AABB3		m_deathBounds = AABB3(Vec3(-20.f, -20.f, -200.f), Vec3(1000.f, 1000.f, -20.f));
+};
@@ -0,0 +1,143 @@
+#include "Game/SimRunner.hpp"
+#include "Game/SimLevel.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Math/MathUtils.h"
+// -----------------------------------------------------------------------------
+void SimRunnerParams::ParseCollision(XmlElement const& collisionElement)
+{
+	m_physicsRadius = ParseXmlAttribute(collisionElement, "physicsRadius", m_physicsRadius);
+	m_physicsHeight = ParseXmlAttribute(collisionElement, "physicsHeight", m_physicsHeight);
+}
+
+void SimRunnerParams::ParsePhysics(XmlElement const& physicsElement)
+{
+	m_moveSpeed	  = ParseXmlAttribute(physicsElement, "moveSpeed", m_moveSpeed);
+	m_strafeSpeed = ParseXmlAttribute(physicsElement, "strafeSpeed", m_strafeSpeed);
+	m_jumpForce	  = ParseXmlAttribute(physicsElement, "jumpForce", m_jumpForce);
+}
+// -----------------------------------------------------------------------------
+void SimRunnerState::Respawn()
+{
+	m_position = Vec3::ZERO;
+	m_velocity = Vec3::ZERO;
+	m_isGrounded = false;
+	m_isTurning = false;
+}
+// -----------------------------------------------------------------------------
+unsigned int SimulateRunnerTick(SimLevel const& level, SimRunnerParams const& params, SimInput input, SimRunnerState& state, float deltaSeconds)
+{
+	unsigned int events = SIM_EVENT_NONE;
+
+	if (input & SIM_INPUT_RESPAWN)
+	{
+		events |= SIM_EVENT_RESPAWNED;
+		state.Respawn();
+	}
+
+	// Runners always face down +X
+	Vec3 forward = Vec3::XAXE;
+	Vec3 left = Vec3::YAXE;
+	bool isJumpPressed = (input & SIM_INPUT_JUMP) != 0;
+	bool isLeftHeld = (input & SIM_INPUT_LEFT) != 0;
+	bool isRightHeld = (input & SIM_INPUT_RIGHT) != 0;
+
+	// Jumping movement
+	if (isJumpPressed && state.m_isGrounded)
+	{
+		events |= SIM_EVENT_JUMPED;
+		state.m_velocity.z = params.m_jumpForce;
+		state.m_isGrounded = false;
+	}
+
+	// Constant forward speed
+	Vec3 horizontalVelocity = forward * params.m_moveSpeed;
+
+	// Left and right movement
+	if (!state.m_isGrounded || isJumpPressed)
+	{
+		if (isLeftHeld)
+		{
+			horizontalVelocity += left * params.m_strafeSpeed;
+		}
+		if (isRightHeld)
+		{
+			horizontalVelocity -= left * params.m_strafeSpeed;
+		}
+	}
+	else
+	{
+		if (isLeftHeld)
+		{
+			events |= SIM_EVENT_TURNING_LEFT;
+			horizontalVelocity += left * params.m_strafeSpeed;
+			state.m_isTurning = true;
+		}
+		else if (isRightHeld)
+		{
+			events |= SIM_EVENT_TURNING_RIGHT;
+			horizontalVelocity -= left * params.m_strafeSpeed;
+			state.m_isTurning = true;
+		}
+		else if (state.m_isTurning)
+		{
+			events |= SIM_EVENT_STOPPED_TURNING;
+			state.m_isTurning = false;
+		}
+	}
+
+	state.m_velocity = Vec3(horizontalVelocity.x, horizontalVelocity.y, state.m_velocity.z);
+	state.m_velocity.z += params.m_gravityForce * deltaSeconds;
+
+	// Here I am clamping gravity so we don't fall super fast
+	state.m_velocity.z = GetClamped(state.m_velocity.z, params.m_maxFallSpeed, params.m_jumpForce);
+
+	state.m_position += state.m_velocity * deltaSeconds;
+
+	level.CollideZCylinder(state.m_position, state.m_velocity, state.m_isGrounded, params.m_physicsRadius, params.m_physicsHeight);
+
+	if (level.IsZCylinderInDeathBounds(state.m_position, params.m_physicsRadius, params.m_physicsHeight))
+	{
+		events |= SIM_EVENT_DIED;
+		state.Respawn();
+	}
+	else if (level.IsZCylinderTouchingEndGoal(state.m_position, params.m_physicsRadius, params.m_physicsHeight))
+	{
+		events |= SIM_EVENT_REACHED_END_GOAL;
+	}
+
+	return events;
+}
+
+bool LoadSimRunnerParams(char const* playerDefsFilePath, std::string const& playerName, SimRunnerParams& out_params)
+{
+	XmlDocument playerDefsXml;
+	XmlError result = playerDefsXml.LoadFile(playerDefsFilePath);
+	GUARANTEE_OR_DIE(result == tinyxml2::XML_SUCCESS, Stringf("Failed to open required player definitions file \"%s\"", playerDefsFilePath));
+
+	XmlElement* rootElement = playerDefsXml.RootElement();
+	GUARANTEE_OR_DIE(rootElement, "RootElement not found!");
+
+	for (XmlElement const* playerDefElement = rootElement->FirstChildElement("PlayerDefinition");
+		playerDefElement != nullptr; playerDefElement = playerDefElement->NextSiblingElement("PlayerDefinition"))
+	{
+		std::string name = ParseXmlAttribute(*playerDefElement, "name", std::string());
+		if (name != playerName)
+		{
+			continue;
+		}
+
+		out_params = SimRunnerParams();
+		XmlElement const* collisionElement = playerDefElement->FirstChildElement("Collision");
+		if (collisionElement)
+		{
+			out_params.ParseCollision(*collisionElement);
+		}
+		XmlElement const* physicsElement = playerDefElement->FirstChildElement("Physics");
+		if (physicsElement)
+		{
+			out_params.ParsePhysics(*physicsElement);
+		}
+		return true;
+	}
+	return false;
+}
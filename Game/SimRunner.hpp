@@ -0,0 +1,60 @@
+#pragma once
+#include "Game/GameCommon.h"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Math/Vec3.h"
+#include <string>
+// -----------------------------------------------------------------------------
+class SimLevel;
+// -----------------------------------------------------------------------------
+// Buttons held or pressed for one simulation tick
+// -----------------------------------------------------------------------------
+enum SimInputFlags : unsigned char
+{
+	SIM_INPUT_NONE  = 0,
+	SIM_INPUT_JUMP  = 1 << 0,	// Pressed since the previous tick
+	SIM_INPUT_LEFT  = 1 << 1,	// Held
+	SIM_INPUT_RIGHT = 1 << 2,	// Held
+	SIM_INPUT_RESPAWN = 1 << 3,	// Pressed since the previous tick
+};
+typedef unsigned char SimInput;
+// -----------------------------------------------------------------------------
+// Things that happened during a tick, for the caller to react to (animation, audio, level flow)
+// -----------------------------------------------------------------------------
+enum SimEventFlags : unsigned int
+{
+	SIM_EVENT_NONE			   = 0,
+	SIM_EVENT_JUMPED		   = 1 << 0,
+	SIM_EVENT_TURNING_LEFT	   = 1 << 1,
+	SIM_EVENT_TURNING_RIGHT	   = 1 << 2,
+	SIM_EVENT_STOPPED_TURNING  = 1 << 3,
+	SIM_EVENT_DIED			   = 1 << 4,
+	SIM_EVENT_REACHED_END_GOAL = 1 << 5,
+	SIM_EVENT_RESPAWNED		   = 1 << 6,
+};
+// -----------------------------------------------------------------------------
+struct SimRunnerParams
+{
+	void ParseCollision(XmlElement const& collisionElement);
+	void ParsePhysics(XmlElement const& physicsElement);
+
+	float m_physicsRadius = 0.0f;
+	float m_physicsHeight = 0.0f;
+	float m_moveSpeed	  = 0.0f;
+	float m_strafeSpeed	  = 0.0f;
+	float m_jumpForce	  = 0.0f;
+	float m_gravityForce  = GRAVITY_FORCE;
+	float m_maxFallSpeed  = MAX_FALL_SPEED;
+};
+// -----------------------------------------------------------------------------
+struct SimRunnerState
+{
+	void Respawn();
+
+	Vec3 m_position = Vec3::ZERO;
+	Vec3 m_velocity = Vec3::ZERO;
+	bool m_isGrounded = false;
+	bool m_isTurning = false;
+};
+// -----------------------------------------------------------------------------
+unsigned int SimulateRunnerTick(SimLevel const& level, SimRunnerParams const& params, SimInput input, SimRunnerState& state, float deltaSeconds);
+bool LoadSimRunnerParams(char const* playerDefsFilePath, std::string const& playerName, SimRunnerParams& out_params);
@@ -0,0 +1,226 @@
+#include "Game/TextMeshCache.hpp"
+#include "Game/GameCommon.h"
+#include "Game/RenderQueue.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+#include "Engine/Renderer/Renderer.h"
+#include <cstring>
+// -----------------------------------------------------------------------------
+static uint64_t HashBytes(void const* data, size_t length, uint64_t hash)
+{
+	// FNV-1a, a zero byte after each field keeps "ab"+"c" and "a"+"bc" apart
+	unsigned char const* bytes = static_cast<unsigned char const*>(data);
+	for (size_t byteIndex = 0; byteIndex < length; ++byteIndex)
+	{
+		hash ^= bytes[byteIndex];
+		hash *= 1099511628211ull;
+	}
+	hash *= 1099511628211ull;
+	return hash;
+}
+// -----------------------------------------------------------------------------
+TextMeshCache::TextMeshCache(BitmapFont* font)
+	: m_font(font)
+{
+}
+
+TextMeshCache::~TextMeshCache()
+{
+	for (TextMesh* mesh : m_staticMeshes)
+	{
+		delete mesh->m_vertexBuffer;
+		delete mesh;
+	}
+	m_staticMeshes.clear();
+
+	for (DynamicSlot* slot : m_dynamicSlots)
+	{
+		if (slot != nullptr)
+		{
+			delete slot->m_vertexBuffer;
+			delete slot;
+		}
+	}
+	m_dynamicSlots.clear();
+}
+
+void TextMeshCache::DrawStaticText(TextLine const* lines, int numLines)
+{
+	uint64_t key = GetKey(lines, numLines);
+	for (TextMesh const* mesh : m_staticMeshes)
+	{
+		if (mesh->m_key == key && DoLinesMatch(*mesh, lines, numLines))
+		{
+			DrawVerts(mesh->m_vertexBuffer, mesh->m_numVerts);
+			return;
+		}
+	}
+
+	TextMesh* mesh = new TextMesh();
+	mesh->m_key = key;
+	StoreLines(*mesh, lines, numLines);
+	LayoutLines(lines, numLines, m_layoutVerts);
+	UploadAllVerts(mesh->m_vertexBuffer, mesh->m_numVerts, m_layoutVerts);
+	m_staticMeshes.push_back(mesh);
+	DrawVerts(mesh->m_vertexBuffer, mesh->m_numVerts);
+}
+
+void TextMeshCache::DrawDynamicText(int slotIndex, TextLine const& line)
+{
+	if (slotIndex >= static_cast<int>(m_dynamicSlots.size()))
+	{
+		m_dynamicSlots.resize(slotIndex + 1, nullptr);
+	}
+	if (m_dynamicSlots[slotIndex] == nullptr)
+	{
+		m_dynamicSlots[slotIndex] = new DynamicSlot();
+	}
+
+	DynamicSlot& slot = *m_dynamicSlots[slotIndex];
+	if (!DoesSlotMatch(slot, line))
+	{
+		// The buffer keeps its size, a line of the same length or shorter replaces it in place
+		LayoutLines(&line, 1, m_layoutVerts);
+		UploadAllVerts(slot.m_vertexBuffer, slot.m_numVerts, m_layoutVerts);
+		StoreSlotLine(slot, line);
+	}
+	DrawVerts(slot.m_vertexBuffer, slot.m_numVerts);
+}
+
+void TextMeshCache::BeginFrame()
+{
+	m_lastFrameStats = m_frameStats;
+	m_frameStats = TextMeshStats();
+
+	int numDynamicMeshes = 0;
+	for (DynamicSlot const* slot : m_dynamicSlots)
+	{
+		if (slot != nullptr)
+		{
+			numDynamicMeshes++;
+		}
+	}
+	m_frameStats.m_numCachedMeshes = static_cast<int>(m_staticMeshes.size()) + numDynamicMeshes;
+}
+
+TextMeshStats const& TextMeshCache::GetLastFrameStats() const
+{
+	return m_lastFrameStats;
+}
+
+uint64_t TextMeshCache::GetKey(TextLine const* lines, int numLines)
+{
+	uint64_t key = 14695981039346656037ull;
+	for (int lineIndex = 0; lineIndex < numLines; ++lineIndex)
+	{
+		TextLine const& line = lines[lineIndex];
+		key = HashBytes(line.m_text, strlen(line.m_text), key);
+		key = HashBytes(&line.m_box, sizeof(line.m_box), key);
+		key = HashBytes(&line.m_cellHeight, sizeof(line.m_cellHeight), key);
+		key = HashBytes(&line.m_color, sizeof(line.m_color), key);
+		key = HashBytes(&line.m_alignment, sizeof(line.m_alignment), key);
+	}
+	return key;
+}
+
+bool TextMeshCache::DoLinesMatch(TextMesh const& mesh, TextLine const* lines, int numLines)
+{
+	if (static_cast<int>(mesh.m_lines.size()) != numLines)
+	{
+		return false;
+	}
+	for (int lineIndex = 0; lineIndex < numLines; ++lineIndex)
+	{
+		CachedLine const& cachedLine = mesh.m_lines[lineIndex];
+		TextLine const& line = lines[lineIndex];
+		if (cachedLine.m_text != line.m_text || cachedLine.m_cellHeight != line.m_cellHeight || !(cachedLine.m_color == line.m_color) ||
+			cachedLine.m_alignment.x != line.m_alignment.x || cachedLine.m_alignment.y != line.m_alignment.y ||
+			cachedLine.m_box.m_mins.x != line.m_box.m_mins.x || cachedLine.m_box.m_mins.y != line.m_box.m_mins.y ||
+			cachedLine.m_box.m_maxs.x != line.m_box.m_maxs.x || cachedLine.m_box.m_maxs.y != line.m_box.m_maxs.y)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void TextMeshCache::StoreLines(TextMesh& mesh, TextLine const* lines, int numLines)
+{
+	mesh.m_lines.resize(numLines);
+	for (int lineIndex = 0; lineIndex < numLines; ++lineIndex)
+	{
+		CachedLine& cachedLine = mesh.m_lines[lineIndex];
+		TextLine const& line = lines[lineIndex];
+		cachedLine.m_text = line.m_text;
+		cachedLine.m_box = line.m_box;
+		cachedLine.m_cellHeight = line.m_cellHeight;
+		cachedLine.m_color = line.m_color;
+		cachedLine.m_alignment = line.m_alignment;
+	}
+}
+
+bool TextMeshCache::DoesSlotMatch(DynamicSlot const& slot, TextLine const& line)
+{
+	// A line too long for the buffer never matches, it is laid out every time rather than drawn stale
+	return slot.m_hasLine && strncmp(slot.m_text, line.m_text, DEBUG_TEXT_LINE_LENGTH) == 0 &&
+		slot.m_cellHeight == line.m_cellHeight && slot.m_color == line.m_color &&
+		slot.m_alignment.x == line.m_alignment.x && slot.m_alignment.y == line.m_alignment.y &&
+		slot.m_box.m_mins.x == line.m_box.m_mins.x && slot.m_box.m_mins.y == line.m_box.m_mins.y &&
+		slot.m_box.m_maxs.x == line.m_box.m_maxs.x && slot.m_box.m_maxs.y == line.m_box.m_maxs.y;
+}
+
+void TextMeshCache::StoreSlotLine(DynamicSlot& slot, TextLine const& line)
+{
+	strncpy(slot.m_text, line.m_text, DEBUG_TEXT_LINE_LENGTH - 1);
+	slot.m_text[DEBUG_TEXT_LINE_LENGTH - 1] = '\0';
+	slot.m_box = line.m_box;
+	slot.m_cellHeight = line.m_cellHeight;
+	slot.m_color = line.m_color;
+	slot.m_alignment = line.m_alignment;
+	slot.m_hasLine = true;
+}
+
+void TextMeshCache::LayoutLines(TextLine const* lines, int numLines, std::vector<Vertex_PCU>& out_verts)
+{
+	out_verts.clear();
+	for (int lineIndex = 0; lineIndex < numLines; ++lineIndex)
+	{
+		TextLine const& line = lines[lineIndex];
+		m_font->AddVertsForTextInBox2D(out_verts, line.m_text, line.m_box, line.m_cellHeight, line.m_color, 1.f, line.m_alignment);
+	}
+	m_frameStats.m_numLayouts++;
+}
+
+void TextMeshCache::UploadAllVerts(VertexBuffer*& vertexBuffer, int& out_numVerts, std::vector<Vertex_PCU> const& verts)
+{
+	int numVerts = static_cast<int>(verts.size());
+	unsigned int vertsBytes = static_cast<unsigned int>(numVerts) * sizeof(Vertex_PCU);
+	if (vertexBuffer == nullptr || vertexBuffer->GetSize() < vertsBytes)
+	{
+		delete vertexBuffer;
+		vertexBuffer = nullptr;
+		if (numVerts > 0)
+		{
+			vertexBuffer = g_theRenderer->CreateVertexBuffer(vertsBytes, sizeof(Vertex_PCU));
+		}
+	}
+	if (numVerts > 0)
+	{
+		g_theRenderer->CopyCPUToGPU(verts.data(), vertsBytes, vertexBuffer);
+	}
+	out_numVerts = numVerts;
+	m_frameStats.m_numGlyphsUploaded += numVerts / VERTS_PER_GLYPH;
+}
+
+void TextMeshCache::DrawVerts(VertexBuffer* vertexBuffer, int numVerts)
+{
+	if (numVerts == 0)
+	{
+		return;
+	}
+
+	RenderCommand command;
+	command.m_layer = RenderLayer::TEXT;
+	command.m_state.m_texture = &m_font->GetTexture();
+	g_theRenderQueue->AddVertexBuffer(command, vertexBuffer, static_cast<unsigned int>(numVerts));
+	m_frameStats.m_numDraws++;
+}
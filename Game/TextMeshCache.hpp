@@ -0,0 +1,100 @@
+#pragma once
+#include "Game/GameCommon.h"
+#include "Engine/Core/Rgba8.h"
+#include "Engine/Core/Vertex_PCU.h"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+// -----------------------------------------------------------------------------
+class BitmapFont;
+class VertexBuffer;
+// -----------------------------------------------------------------------------
+constexpr int VERTS_PER_GLYPH = 6;
+// -----------------------------------------------------------------------------
+struct TextLine
+{
+	char const* m_text = "";
+	AABB2		m_box;
+	float		m_cellHeight = 0.f;
+	Rgba8		m_color = Rgba8::WHITE;
+	Vec2		m_alignment = Vec2(0.5f, 0.5f);
+};
+// -----------------------------------------------------------------------------
+struct TextMeshStats
+{
+	int m_numCachedMeshes = 0;
+	int m_numDraws = 0;
+	int m_numLayouts = 0;			// Text laid out on the CPU because it was new or changed
+	int m_numGlyphsUploaded = 0;
+};
+// -----------------------------------------------------------------------------
+// Laid out text kept in vertex buffers. A static block is any set of lines drawn
+// together and is found again by its lines, box, size, color and alignment, so
+// an unchanged menu costs one lookup and one draw. A dynamic slot is one line
+// whose text changes, it is laid out and uploaded again only when it differs
+// from last time. Its text is kept in a fixed buffer, so checking it costs no
+// allocation. A changed slot is always laid out and uploaded whole, updating
+// only the glyphs that differ is not supported.
+// -----------------------------------------------------------------------------
+class TextMeshCache
+{
+public:
+	explicit TextMeshCache(BitmapFont* font);
+	~TextMeshCache();
+
+	void DrawStaticText(TextLine const* lines, int numLines);
+	void DrawDynamicText(int slotIndex, TextLine const& line);
+
+	void BeginFrame();
+	TextMeshStats const& GetLastFrameStats() const;
+
+private:
+	struct CachedLine
+	{
+		std::string m_text;
+		AABB2		m_box;
+		float		m_cellHeight = 0.f;
+		Rgba8		m_color;
+		Vec2		m_alignment;
+	};
+
+	struct TextMesh
+	{
+		uint64_t				m_key = 0;
+		std::vector<CachedLine> m_lines;
+		VertexBuffer*			m_vertexBuffer = nullptr;
+		int						m_numVerts = 0;
+	};
+
+	struct DynamicSlot
+	{
+		char		  m_text[DEBUG_TEXT_LINE_LENGTH] = {};
+		AABB2		  m_box;
+		float		  m_cellHeight = 0.f;
+		Rgba8		  m_color;
+		Vec2		  m_alignment;
+		bool		  m_hasLine = false;
+		VertexBuffer* m_vertexBuffer = nullptr;
+		int			  m_numVerts = 0;
+	};
+
+	static uint64_t GetKey(TextLine const* lines, int numLines);
+	static bool DoLinesMatch(TextMesh const& mesh, TextLine const* lines, int numLines);
+	static void StoreLines(TextMesh& mesh, TextLine const* lines, int numLines);
+	static bool DoesSlotMatch(DynamicSlot const& slot, TextLine const& line);
+	static void StoreSlotLine(DynamicSlot& slot, TextLine const& line);
+
+	void LayoutLines(TextLine const* lines, int numLines, std::vector<Vertex_PCU>& out_verts);
+	void UploadAllVerts(VertexBuffer*& vertexBuffer, int& out_numVerts, std::vector<Vertex_PCU> const& verts);
+	void DrawVerts(VertexBuffer* vertexBuffer, int numVerts);
+
+private:
+	BitmapFont*					m_font = nullptr;
+	std::vector<TextMesh*>		m_staticMeshes;
+	std::vector<DynamicSlot*>	m_dynamicSlots;
+	std::vector<Vertex_PCU>		m_layoutVerts;			// Reused for every layout
+	TextMeshStats				m_frameStats;
+	TextMeshStats				m_lastFrameStats;
+};
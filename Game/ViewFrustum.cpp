@@ -0,0 +1,52 @@
+#include "Game/ViewFrustum.hpp"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Math/Mat44.hpp"
+// -----------------------------------------------------------------------------
+static FrustumPlane MakeFrustumPlane(Vec3 const& inwardDirection, Vec3 const& pointOnPlane)
+{
+	FrustumPlane plane;
+	plane.m_normal = inwardDirection.GetNormalized();
+	plane.m_distFromOrigin = DotProduct3D(plane.m_normal, pointOnPlane);
+	return plane;
+}
+// -----------------------------------------------------------------------------
+ViewFrustum::ViewFrustum(Vec3 const& position, EulerAngles const& orientation, float aspect, float fovDegrees, float nearDist, float farDist)
+{
+	Mat44 cameraToWorld = orientation.GetAsMatrix_IFwd_JLeft_KUp();
+	Vec3 fwd = cameraToWorld.GetIBasis3D();
+	Vec3 left = cameraToWorld.GetJBasis3D();
+	Vec3 up = cameraToWorld.GetKBasis3D();
+
+	// Field of view is vertical, the aspect widens it horizontally
+	float halfHeight = SinDegrees(fovDegrees * 0.5f) / CosDegrees(fovDegrees * 0.5f);
+	float halfWidth = halfHeight * aspect;
+	Vec3 leftEdge = fwd + left * halfWidth;
+	Vec3 rightEdge = fwd - left * halfWidth;
+	Vec3 topEdge = fwd + up * halfHeight;
+	Vec3 bottomEdge = fwd - up * halfHeight;
+
+	m_planes[0] = MakeFrustumPlane(fwd, position + fwd * nearDist);
+	m_planes[1] = MakeFrustumPlane(-fwd, position + fwd * farDist);
+	m_planes[2] = MakeFrustumPlane(CrossProduct3D(leftEdge, up), position);
+	m_planes[3] = MakeFrustumPlane(CrossProduct3D(up, rightEdge), position);
+	m_planes[4] = MakeFrustumPlane(CrossProduct3D(left, topEdge), position);
+	m_planes[5] = MakeFrustumPlane(CrossProduct3D(bottomEdge, left), position);
+}
+
+bool ViewFrustum::IsAABB3Outside(AABB3 const& bounds) const
+{
+	// Conservative, the box is rejected only when its corner furthest inside is behind one plane
+	for (int planeIndex = 0; planeIndex < 6; ++planeIndex)
+	{
+		FrustumPlane const& plane = m_planes[planeIndex];
+		Vec3 furthestCorner;
+		furthestCorner.x = (plane.m_normal.x >= 0.f) ? bounds.m_maxs.x : bounds.m_mins.x;
+		furthestCorner.y = (plane.m_normal.y >= 0.f) ? bounds.m_maxs.y : bounds.m_mins.y;
+		furthestCorner.z = (plane.m_normal.z >= 0.f) ? bounds.m_maxs.z : bounds.m_mins.z;
+		if (DotProduct3D(plane.m_normal, furthestCorner) < plane.m_distFromOrigin)
+		{
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/Vec3.h"
+// -----------------------------------------------------------------------------
+struct FrustumPlane
+{
+	Vec3  m_normal;				// Points into the frustum
+	float m_distFromOrigin = 0.f;
+};
+// -----------------------------------------------------------------------------
+// Perspective view volume in world space, built from the same values the world
+// camera is given, for rejecting geometry on the CPU before it is drawn
+// -----------------------------------------------------------------------------
+class ViewFrustum
+{
+public:
+	ViewFrustum() = default;
+	ViewFrustum(Vec3 const& position, EulerAngles const& orientation, float aspect, float fovDegrees, float nearDist, float farDist);
+
+	bool IsAABB3Outside(AABB3 const& bounds) const;
+
+private:
+	FrustumPlane m_planes[6];
+};
@@ -0,0 +1,145 @@
+#include "Game/WorkStealingPool.hpp"
+// -----------------------------------------------------------------------------
+WorkStealingPool::WorkStealingPool(int numThreads)
+{
+	if (numThreads < 1)
+	{
+		numThreads = 1;
+	}
+
+	for (int workerIndex = 0; workerIndex < numThreads; ++workerIndex)
+	{
+		m_queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+	}
+
+	// Worker 0 is whichever thread calls ParallelFor
+	for (int workerIndex = 1; workerIndex < numThreads; ++workerIndex)
+	{
+		m_threads.push_back(std::thread(&WorkStealingPool::WorkerThreadMain, this, workerIndex));
+	}
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_isQuitting = true;
+	}
+	m_wakeCondition.notify_all();
+
+	for (std::thread& workerThread : m_threads)
+	{
+		workerThread.join();
+	}
+}
+
+void WorkStealingPool::ParallelFor(int numItems, int itemsPerTask, RangeTaskFunc const& func)
+{
+	if (numItems <= 0)
+	{
+		return;
+	}
+	if (itemsPerTask < 1)
+	{
+		itemsPerTask = 1;
+	}
+
+	int numWorkers = GetNumThreads();
+	int numTasks = (numItems + itemsPerTask - 1) / itemsPerTask;
+	m_numPendingTasks.store(numTasks);
+
+	// Deal tasks out in contiguous spans so each worker starts on neighbouring items
+	for (int taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+	{
+		RangeTask task;
+		task.m_func = &func;
+		task.m_firstItem = taskIndex * itemsPerTask;
+		task.m_numItems = (numItems - task.m_firstItem < itemsPerTask) ? (numItems - task.m_firstItem) : itemsPerTask;
+
+		int workerIndex = static_cast<int>((static_cast<long long>(taskIndex) * numWorkers) / numTasks);
+		WorkerQueue& queue = *m_queues[workerIndex];
+		std::lock_guard<std::mutex> lock(queue.m_mutex);
+		queue.m_tasks.push_back(task);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_batchGeneration++;
+	}
+	m_wakeCondition.notify_all();
+
+	RunTasksUntilEmpty(0);
+
+	std::unique_lock<std::mutex> lock(m_wakeMutex);
+	m_doneCondition.wait(lock, [this]() { return m_numPendingTasks.load() == 0; });
+}
+
+int WorkStealingPool::GetNumThreads() const
+{
+	return static_cast<int>(m_queues.size());
+}
+
+void WorkStealingPool::WorkerThreadMain(int workerIndex)
+{
+	unsigned int seenGeneration = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_wakeMutex);
+			m_wakeCondition.wait(lock, [this, seenGeneration]() { return m_isQuitting || m_batchGeneration != seenGeneration; });
+			if (m_isQuitting)
+			{
+				return;
+			}
+			seenGeneration = m_batchGeneration;
+		}
+		RunTasksUntilEmpty(workerIndex);
+	}
+}
+
+void WorkStealingPool::RunTasksUntilEmpty(int workerIndex)
+{
+	RangeTask task;
+	while (PopOwnTask(workerIndex, task) || StealTask(workerIndex, task))
+	{
+		(*task.m_func)(task.m_firstItem, task.m_numItems);
+
+		if (m_numPendingTasks.fetch_sub(1) == 1)
+		{
+			// Take the lock so the wake-up cannot slip in between ParallelFor's check and its wait
+			std::lock_guard<std::mutex> lock(m_wakeMutex);
+			m_doneCondition.notify_all();
+		}
+	}
+}
+
+bool WorkStealingPool::PopOwnTask(int workerIndex, RangeTask& out_task)
+{
+	WorkerQueue& queue = *m_queues[workerIndex];
+	std::lock_guard<std::mutex> lock(queue.m_mutex);
+	if (queue.m_tasks.empty())
+	{
+		return false;
+	}
+	out_task = queue.m_tasks.front();
+	queue.m_tasks.pop_front();
+	return true;
+}
+
+bool WorkStealingPool::StealTask(int thiefIndex, RangeTask& out_task)
+{
+	int numWorkers = GetNumThreads();
+	for (int offset = 1; offset < numWorkers; ++offset)
+	{
+		WorkerQueue& victimQueue = *m_queues[(thiefIndex + offset) % numWorkers];
+		std::lock_guard<std::mutex> lock(victimQueue.m_mutex);
+		if (!victimQueue.m_tasks.empty())
+		{
+			// Take from the far end, away from where the owner is working
+			out_task = victimQueue.m_tasks.back();
+			victimQueue.m_tasks.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+// -----------------------------------------------------------------------------
+typedef std::function<void(int firstItem, int numItems)> RangeTaskFunc;
+// -----------------------------------------------------------------------------
+struct RangeTask
+{
+	RangeTaskFunc const* m_func = nullptr;
+	int m_firstItem = 0;
+	int m_numItems = 0;
+};
+// -----------------------------------------------------------------------------
+// Fixed set of worker threads, each with its own task deque. A worker drains its
+// own deque from the front and, once empty, steals from the back of the others,
+// so uneven task costs still keep every core busy. The calling thread joins in
+// as worker 0 for the duration of ParallelFor.
+// -----------------------------------------------------------------------------
+class WorkStealingPool
+{
+public:
+	explicit WorkStealingPool(int numThreads);
+	~WorkStealingPool();
+
+	void ParallelFor(int numItems, int itemsPerTask, RangeTaskFunc const& func);
+	int  GetNumThreads() const;
+
+private:
+	struct WorkerQueue
+	{
+		std::mutex			  m_mutex;
+		std::deque<RangeTask> m_tasks;
+	};
+
+	void WorkerThreadMain(int workerIndex);
+	void RunTasksUntilEmpty(int workerIndex);
+	bool PopOwnTask(int workerIndex, RangeTask& out_task);
+	bool StealTask(int thiefIndex, RangeTask& out_task);
+
+private:
+	std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+	std::vector<std::thread> m_threads;
+
+	std::mutex				m_wakeMutex;
+	std::condition_variable m_wakeCondition;
+	std::condition_variable m_doneCondition;
+	unsigned int			m_batchGeneration = 0;
+	bool					m_isQuitting = false;
+	std::atomic<int>		m_numPendingTasks{ 0 };
+};
@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------------------------
+// Phong lighting for level blocks in the packed static layout, the Engine's
+// Vertex_PCU input layout with the octahedral encoded normal in place of the UVs.
+// Blocks are untextured, so the tangent frame is derived from the normal.
+//------------------------------------------------------------------------------------------------
+struct vs_input_t
+{
+	float3 modelPosition : POSITION;
+	float4 color : COLOR;
+	float2 octNormal : TEXCOORD;		// Octahedral encoded model space normal
+};
+
+//------------------------------------------------------------------------------------------------
+struct v2p_t
+{
+	float4 clipPosition : SV_Position;
+	float4 worldPosition : POSITION;
+	float4 color : COLOR;
+	float4 worldTangent : TANGENT;
+	float4 worldBitangent : BITANGENT;
+	float4 worldNormal : NORMAL;
+};
+
+// -----------------------------------------------------------------------------------------------
+struct PointLight
+{
+	float4 Position;
+	float4 Color;
+};
+#define MAX_POINT_LIGHTS 64
+// -----------------------------------------------------------------------------------------------
+struct SpotLight
+{
+    float4 Position;
+    float4 Color;
+
+    float3 SpotLightDirection;
+    float  InnerRadius;
+
+    float OuterRadius;
+    float InnerPenumbraDotThreshold;
+    float OuterPenumbraDotThreshold;
+    float Padding;
+};
+#define MAX_SPOT_LIGHTS 8
+//------------------------------------------------------------------------------------------------
+cbuffer PerFrameConstants : register(b1)
+{
+	float		c_time;
+	int			c_debugInt;
+	float		c_debugFloat;
+	int			EMPTY_PADDING;
+};
+// -----------------------------------------------------------------------------
+cbuffer CameraConstants : register(b2)
+{
+	float4x4 WorldToCameraTransform;	// View transform
+	float4x4 CameraToRenderTransform;	// Non-standard transform from game to DirectX conventions
+	float4x4 RenderToClipTransform;		// Projection transform
+	float3   CameraPosition;
+	float    Padding;
+};
+//------------------------------------------------------------------------------------------------
+cbuffer ModelConstants : register(b3)
+{
+	float4x4 ModelToWorldTransform;		// Model transform
+	float4 ModelColor;
+};
+//------------------------------------------------------------------------------------------------
+cbuffer LightConstants : register(b4)
+{
+	float3 SunDirection;
+	float SunIntensity;
+
+	float AmbientIntensity;
+	float3  padders;
+
+	int NumPointLights;
+	float3 pointPadding;
+	PointLight PointLights[MAX_POINT_LIGHTS];
+
+	int NumSpotLights;
+	float3 spotPadding;
+	SpotLight SpotLights[MAX_SPOT_LIGHTS];
+};
+//------------------------------------------------------------------------------------------------
+float3 DecodeOctahedralNormal(float2 encoded)
+{
+	float3 normal = float3(encoded.x, encoded.y, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float fold = saturate(-normal.z);
+	normal.x += (normal.x >= 0.0) ? -fold : fold;
+	normal.y += (normal.y >= 0.0) ? -fold : fold;
+	return normalize(normal);
+}
+//------------------------------------------------------------------------------------------------
+v2p_t VertexMain(vs_input_t input)
+{
+	float4 modelPosition = float4(input.modelPosition, 1);
+	float4 worldPosition = mul(ModelToWorldTransform, modelPosition);
+	float4 cameraPosition = mul(WorldToCameraTransform, worldPosition);
+	float4 renderPosition = mul(CameraToRenderTransform, cameraPosition);
+	float4 clipPosition = mul(RenderToClipTransform, renderPosition);
+
+	float3 worldNormal = normalize(mul(ModelToWorldTransform, float4(DecodeOctahedralNormal(input.octNormal), 0.0)).xyz);
+	float3 referenceUp = (abs(worldNormal.z) < 0.999) ? float3(0.0, 0.0, 1.0) : float3(1.0, 0.0, 0.0);
+	float3 worldTangent = normalize(cross(referenceUp, worldNormal));
+	float3 worldBitangent = cross(worldNormal, worldTangent);
+
+	v2p_t v2p;
+	v2p.clipPosition = clipPosition;
+	v2p.worldPosition = worldPosition;
+	v2p.color = input.color;
+	v2p.worldTangent = float4(worldTangent, 0.0);
+	v2p.worldBitangent = float4(worldBitangent, 0.0);
+	v2p.worldNormal = float4(worldNormal, 0.0);
+	return v2p;
+}
+// -----------------------------------------------------------------------------
+float RangeMapClamped(float inValue, float inStart, float inEnd, float outStart, float outEnd)
+{
+	float  fraction = saturate((inValue - inStart) / (inEnd - inStart));
+	float  outValue = (outStart + fraction * (outEnd - outStart));
+	return outValue;
+}
+float SmoothStep3(float x)
+{
+	return (3.0*(x*x)) - (2.0*x)*(x*x);
+}
+// -----------------------------------------------------------------------------
+float3 EncodeXYZToRGB( float3 vec )
+{
+	return (vec + 1.0) * 0.5;
+}
+//------------------------------------------------------------------------------------------------
+float4 PixelMain(v2p_t input) : SV_Target0
+{
+	float4 vertexColor = input.color;
+	float4 diffuseTintColor = vertexColor * ModelColor;
+	float3 worldNormal = normalize(input.worldNormal.xyz);
+
+	//---------------------------------------DIRECTIONAL LIGHT-------------------------------------------------//
+	float4 ambient = AmbientIntensity * float4(1.0f, 1.0f, 1.0f, 1.0f);
+	float4 directional = SunIntensity * saturate(dot(worldNormal, -SunDirection)) * ambient;
+	float4 lightColor = ambient + directional;
+	//-------------------------------------------------------------------------------------------------------//
+
+	//-----------------------------------------POINT LIGHTS---------------------------------------------------//
+	for (int lightIndex = 0; lightIndex < NumPointLights; ++lightIndex)
+	{
+		float4 pointLightPos = PointLights[lightIndex].Position;
+		float4 pointlightColor = PointLights[lightIndex].Color;
+
+		float3 pixelToLightDir = normalize(pointLightPos.xyz - input.worldPosition.xyz);
+		float distance = length(pointLightPos.xyz - input.worldPosition.xyz);
+		float linearfalloff = 0.09f;
+		float quadratic = 0.032f;
+		float attenuation = 1.0f / (1.0f + linearfalloff * distance + quadratic * distance * distance);
+
+		float diffuseDot = saturate(dot(worldNormal, pixelToLightDir));
+		lightColor.rgb += pointlightColor.rgb * diffuseDot * attenuation;
+	}
+	//-------------------------------------------------------------------------------------------------------//
+
+	//------------------------------------------SPOT LIGHTS---------------------------------------------------//
+	for (int spotLightIndex = 0; spotLightIndex < NumSpotLights; ++spotLightIndex)
+	{
+		SpotLight light = SpotLights[spotLightIndex];
+		float3 spotLightDirection = normalize(light.SpotLightDirection);
+
+		float3 pixelToLightDisp = light.Position.xyz - input.worldPosition.xyz;
+		float3 pixelToLightDirection = normalize(pixelToLightDisp);
+		float  distance = length(pixelToLightDisp);
+
+		float attenuation = SmoothStep3(RangeMapClamped(distance, light.InnerRadius, light.OuterRadius, 1.0f, 0.0f));
+		float dotAngle = dot(-pixelToLightDirection, spotLightDirection);
+		float penumbraAttenuation = SmoothStep3(RangeMapClamped(dotAngle, light.OuterPenumbraDotThreshold, light.InnerPenumbraDotThreshold, 0.0f, 1.0f));
+
+		float diffuseDot = saturate(dot(worldNormal, pixelToLightDirection));
+		lightColor.rgb += light.Color.rgb * diffuseDot * penumbraAttenuation * attenuation;
+	}
+	//-------------------------------------------------------------------------------------------------------//
+	float4 color = float4(diffuseTintColor.rgb * lightColor.rgb, diffuseTintColor.a);
+	clip(color.a - 0.01f);
+
+	if (c_debugInt == 2)
+	{
+		color.rgba = vertexColor.rgba;
+	}
+	else if (c_debugInt == 4)
+	{
+		color.rgb = EncodeXYZToRGB( normalize(input.worldTangent.xyz) );
+	}
+	else if (c_debugInt == 5)
+	{
+		color.rgb = EncodeXYZToRGB( normalize(input.worldBitangent.xyz) );
+	}
+	else if (c_debugInt == 6)
+	{
+		color.rgb = EncodeXYZToRGB( worldNormal );
+	}
+	return color;
+}